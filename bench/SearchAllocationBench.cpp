@@ -0,0 +1,116 @@
+#include "TestSupport.hpp"
+#include "../include/Flight/FlightCatalog.hpp"
+#include "../include/Utils/JsonUtils.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+// Heap allocations made by one flight search: the route lookup plus the compares a
+// caller makes on each flight found. The read paths are meant to make none.
+namespace
+{
+    std::atomic<std::uint64_t> allocations{0};
+
+    constexpr int flightCount = 2000;
+    constexpr int iterations = 100000;
+    const char* const cities[] = {"Florida", "Chicago", "Los Angeles", "New York", "Seattle", "Denver", "Boston", "Miami"};
+}
+
+#if defined(__GLIBC__)
+// Count every heap allocation, including those C code makes (a FILE from fopen, say):
+// these replace glibc's malloc family for the whole program, and operator new goes
+// through them too
+extern "C"
+{
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void* memory, std::size_t size);
+
+    void* malloc(std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* memory, std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(memory, size);
+    }
+}
+#else
+// Elsewhere only C++ allocations are counted
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+#endif
+
+int main()
+{
+    TestSupport::useScratchDirectory("search_bench");
+
+    // A schedule of flights between a few cities over ten days
+    nlohmann::json schedule = nlohmann::json::array();
+    for (int i = 0; i < flightCount; i++)
+    {
+        std::string day = "2025-03-1" + std::to_string(i % 10);
+        Flight flight("FL" + std::to_string(1000 + i), cities[i % 8], cities[(i / 8) % 8], day + " 09:00:00Z", day + " 13:00:00Z",
+                      "Boeing 737", (i / 10) % 5 ? "On Time" : "Delayed", 180, 180, 100.0 + i % 300);
+        schedule.push_back(flight.toJson());
+    }
+    JsonUtils::saveJsonToFile(schedule, "data/flights.json");
+
+    FlightCatalog &catalog = FlightCatalog::instance();
+    catalog.getFlights(); // Load once, outside the measurement
+
+    const std::string origin = "Florida", destination = "Chicago", departureDate = "2025-03-10";
+    const std::string_view onTime = "On Time";
+    size_t found = 0, matching = 0;
+    std::uint64_t before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        auto flights = catalog.findFlightsByRoute(origin, destination, departureDate);
+        for (const auto &flight : *flights)
+        {
+            found++;
+            if (flight->getOrigin() == origin && flight->getDestination() == destination && flight->getStatus() == onTime)
+            {
+                matching++;
+            }
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::uint64_t made = allocations.load() - before;
+
+    std::cout << iterations << " searches over " << flightCount << " flights (" << found / iterations << " found, "
+              << matching / iterations << " on time each)" << std::endl;
+    std::cout << "Allocations per search: " << static_cast<double>(made) / iterations << std::endl;
+    std::cout << "Time per search: " << elapsed.count() / iterations << " us" << std::endl;
+    return made == 0 ? 0 : 1;
+}
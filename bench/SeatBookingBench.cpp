@@ -0,0 +1,112 @@
+#include "TestSupport.hpp"
+#include "../include/Flight/SeatInventory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Booking throughput on one flight through SeatInventory as agent threads are added.
+// Holds: each thread holds and frees its own seats over and over, either in a block of
+// rows of its own (separate seat words) or spread across the cabin (every word shared
+// with the other threads), so the second mode shows the cost of CAS contention.
+// Claims: each thread holds a seat, claims it in the seat log as a transaction would,
+// then withdraws the claim and frees the seat again.
+namespace
+{
+    const std::string flightNumber = "B100";
+    constexpr int rows = 960;
+    constexpr int cols = 6;
+    constexpr int roundsPerThread = 200;
+    constexpr int claimsPerThread = 500;
+
+    template <typename Work>
+    double timeThreads(int threadCount, const Work& work)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back(work, t);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    double holds(int threadCount, bool sharedWords)
+    {
+        SeatInventory &inventory = SeatInventory::instance();
+        const int seatsPerThread = rows * cols / threadCount;
+        auto seatOf = [&](int thread, int i)
+        {
+            return sharedWords ? i * threadCount + thread : thread * seatsPerThread + i;
+        };
+
+        double seconds = timeThreads(threadCount, [&](int t)
+        {
+            for (int round = 0; round < roundsPerThread; round++)
+            {
+                for (int i = 0; i < seatsPerThread; i++)
+                {
+                    inventory.holdSeat(flightNumber, seatOf(t, i));
+                }
+                for (int i = 0; i < seatsPerThread; i++)
+                {
+                    inventory.releaseHeldSeat(flightNumber, seatOf(t, i));
+                }
+            }
+        });
+        return 2.0 * roundsPerThread * seatsPerThread * threadCount / seconds;
+    }
+
+    double claims(int threadCount)
+    {
+        SeatInventory &inventory = SeatInventory::instance();
+        const int seatsPerThread = rows * cols / threadCount;
+        static int run = 0;
+        run++;
+
+        double seconds = timeThreads(threadCount, [&](int t)
+        {
+            // A journal per thread, as if each were its own process
+            std::string journal = "bench-" + std::to_string(run) + "-" + std::to_string(t);
+            for (int i = 0; i < claimsPerThread; i++)
+            {
+                int seatIndex = t * seatsPerThread + i % seatsPerThread;
+                if (inventory.holdSeat(flightNumber, seatIndex) &&
+                    inventory.claimSeats({{flightNumber, seatIndex}}, journal, static_cast<std::uint64_t>(i) + 1))
+                {
+                    inventory.abortClaims(journal, static_cast<std::uint64_t>(i));
+                }
+                inventory.releaseHeldSeat(flightNumber, seatIndex);
+            }
+        });
+        return claimsPerThread * threadCount / seconds;
+    }
+}
+
+int main()
+{
+    TestSupport::useScratchDirectory("seat_booking_bench");
+    SeatInventory &inventory = SeatInventory::instance();
+    inventory.createSeatMap(flightNumber, rows, cols);
+    inventory.save();
+
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "Seat operations per second on one " << rows * cols << "-seat flight" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "holds (own)" << std::setw(16) << "holds (shared)"
+              << std::setw(16) << "hold + claim" << std::endl;
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    {
+        std::cout << std::setw(8) << threadCount << std::fixed << std::setprecision(0)
+                  << std::setw(16) << holds(threadCount, false) << std::setw(16) << holds(threadCount, true)
+                  << std::setw(16) << claims(threadCount) << std::endl;
+    }
+    inventory.save();
+    return 0;
+}
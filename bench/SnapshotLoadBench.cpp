@@ -0,0 +1,67 @@
+#include "TestSupport.hpp"
+#include "../include/Utils/Snapshot.hpp"
+#include "../include/Booking/Reservation.hpp"
+#include <chrono>
+#include <iostream>
+
+// Start-up cost of the reservations from JSON (streaming parse) and from the binary
+// snapshot (mmap, then decode every record or just one). The files were just written,
+// so they are in the page cache: this compares parsing against decoding, not disk reads.
+namespace
+{
+    constexpr int reservationCount = 200000;
+    const std::string reservationsFile = "data/reservations.json";
+    const std::string snapshotFile = "data/snapshot.bin";
+
+    template <typename Load>
+    double millisecondsFor(Load load)
+    {
+        auto start = std::chrono::steady_clock::now();
+        load();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    TestSupport::useScratchDirectory("snapshot_bench");
+
+    std::vector<Reservation> reservations;
+    reservations.reserve(reservationCount);
+    nlohmann::json array = nlohmann::json::array();
+    for (int i = 0; i < reservationCount; i++)
+    {
+        reservations.emplace_back("R" + std::to_string(i), "P" + std::to_string(i % 5000), "Passenger " + std::to_string(i % 5000),
+                                  "FL" + std::to_string(1000 + i % 400), std::to_string(i % 30 + 1) + char('A' + i % 6), "A12", "8:00",
+                                  "Confirmed", 100.0 + i % 300);
+        array.push_back(reservations.back().toJson());
+    }
+    JsonUtils::saveJsonToFile(array, reservationsFile);
+    array = nullptr;
+
+    Snapshot::Writer writer;
+    writer.addSection("reservations", reservations, Snapshot::FileStamp::of(reservationsFile));
+    writer.save(snapshotFile);
+    reservations.clear();
+    reservations.shrink_to_fit();
+
+    size_t fromJson = 0, fromSnapshot = 0;
+    double json = millisecondsFor([&] { fromJson = JsonUtils::readEntitiesFromFile<Reservation>(reservationsFile).size(); });
+    double snapshot = millisecondsFor([&]
+    {
+        Snapshot::Reader reader(snapshotFile);
+        fromSnapshot = reader.table<Reservation>("reservations").loadAll().size();
+    });
+    double oneRecord = millisecondsFor([&]
+    {
+        Snapshot::Reader reader(snapshotFile);
+        reader.table<Reservation>("reservations").get(reservationCount / 2);
+    });
+
+    std::cout << reservationCount << " reservations: JSON " << Snapshot::FileStamp::of(reservationsFile).size / 1024 << " KB, snapshot "
+              << Snapshot::FileStamp::of(snapshotFile).size / 1024 << " KB" << std::endl;
+    std::cout << "JSON, every record:     " << json << " ms" << std::endl;
+    std::cout << "Snapshot, every record: " << snapshot << " ms" << std::endl;
+    std::cout << "Snapshot, one record:   " << oneRecord << " ms (checks only the pages it reads)" << std::endl;
+    return fromJson == fromSnapshot ? 0 : 1;
+}
@@ -3,8 +3,12 @@
 
 #include <string>
 #include <optional>
+#include <string_view>
 #include "PaymentService.hpp"
 #include <nlohmann/json.hpp>
+#include "../Utils/Symbol.hpp"
+#include "../Utils/JsonStreamReader.hpp"
+#include "../Utils/Reflection.hpp"
 
 class Reservation
 {
@@ -12,36 +16,38 @@ private:
     std::string reservationId;
     std::string passengerId;
     std::string passengerName;
-    std::string flightNumber;
+    Symbol flightNumber;    // interned, shared with Flight
     std::string seatNumber;
-    std::string gate;
+    Symbol gate;
     std::string boardingTime;
-    std::string status;    
-    double price;
+    Symbol status;
+    double price = 0.0;
     std::string paymentMethod;
     std::optional<std::string> paymentDetails = std::nullopt;
     std::string paymentStatus = "Unpaid";
 
 public:
     Reservation() = default;
-    Reservation(const std::string &reservationId, const std::string &passengerId,
-                const std::string &passengerName,const std::string &flightNumber, const std::string &seatNumber,
-                const std::string &gate,const std::string &boardingTime,
+    Reservation(std::string reservationId, std::string passengerId,
+                std::string passengerName, const std::string &flightNumber, std::string seatNumber,
+                const std::string &gate, std::string boardingTime,
                 const std::string &status, double price);
 
     // Getters
-    std::string getReservationId() const { return reservationId; }
-    std::string getPassengerId() const { return passengerId; }
-    std::string getPassengerName() const { return passengerName; }
-    std::string getFlightNumber() const { return flightNumber; }
-    std::string getSeatNumber() const { return seatNumber; }
-    std::string getStatus() const { return status; }
-    std::string getGate() const { return gate; }
-    std::string getBoardingTime() const { return boardingTime; }
+    const std::string& getReservationId() const { return reservationId; }
+    const std::string& getPassengerId() const { return passengerId; }
+    const std::string& getPassengerName() const { return passengerName; }
+    std::string_view getFlightNumber() const { return flightNumber.view(); }
+    const std::string& getSeatNumber() const { return seatNumber; }
+    std::string_view getStatus() const { return status.view(); }
+    std::string_view getGate() const { return gate.view(); }
+    const std::string& getBoardingTime() const { return boardingTime; }
     double getPrice() const { return price; }
-    std::string getPaymentMethod() const { return paymentMethod; }
+    Symbol getFlightNumberSymbol() const { return flightNumber; }
+    Symbol getStatusSymbol() const { return status; }
+    const std::string& getPaymentMethod() const { return paymentMethod; }
     std::optional<std::string> getPaymentDetails() const { return paymentDetails; }
-    std::string getPaymentStatus() const { return paymentStatus; }
+    const std::string& getPaymentStatus() const { return paymentStatus; }
     
     // Setters
     void setStatus(const std::string& newStatus) { status = newStatus; }
@@ -57,6 +63,28 @@ public:
 
     //Serialization
     static Reservation fromJson(const nlohmann::json &j);
+
+    // Persisted fields; drives toJson, the streaming loader and the binary format
+    static constexpr auto fields()
+    {
+        using Reflection::field;
+        using Reflection::optionalField;
+        return std::make_tuple(
+            field("reservationId", &Reservation::reservationId),
+            field("passengerId", &Reservation::passengerId),
+            field("passengerName", &Reservation::passengerName),
+            field("flightNumber", &Reservation::flightNumber),
+            field("seatNumber", &Reservation::seatNumber),
+            field("gate", &Reservation::gate),
+            field("boardingTime", &Reservation::boardingTime),
+            field("status", &Reservation::status),
+            field("price", &Reservation::price),
+            optionalField("paymentStatus", &Reservation::paymentStatus),
+            optionalField("paymentMethod", &Reservation::paymentMethod),
+            optionalField("paymentDetails", &Reservation::paymentDetails));
+    }
+
+    using Builder = Reflection::Builder<Reservation>;
     nlohmann::json toJson() const;
 };
 
@@ -0,0 +1,109 @@
+#ifndef RESERVATIONJOURNAL_HPP
+#define RESERVATIONJOURNAL_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include "Reservation.hpp"
+#include "TransactionStamp.hpp"
+#include "../Utils/JsonUtils.hpp"
+
+// Process-wide reservation state backed by a snapshot and an append-only journal.
+// reservations.json is the snapshot; every booking, update, status change and
+// cancellation is appended to reservations.journal as one JSON line. A background
+// thread fsyncs appended records in batches and periodically folds the journal
+// back into the snapshot. Startup loads the snapshot and replays the journal.
+// Other processes append to the same journal. Appends hold the journal's exclusive
+// file lock and first apply whatever was appended since this process last read, so
+// every process applies the records in journal order. A compaction replaces both
+// files and bumps the journal's generation, which makes the others reload.
+// Changes made by transactions carry their TransactionStamp; one whose stamp the
+// journal has already applied is ignored, so replaying an intent journal never undoes
+// what happened since. Compaction keeps the stamps in a record at the journal's start.
+class ReservationJournal
+{
+public:
+    // Get the shared journal for data/reservations.json
+    static ReservationJournal& instance();
+    ~ReservationJournal();
+
+    // Copy of the current reservations (change them through the record methods).
+    // Copies, because background catch-ups and compactions change the reservations at any time.
+    std::vector<Reservation> getReservations() const;
+
+    // Copy of a reservation found by ID in O(1), nullopt if it doesn't exist
+    std::optional<Reservation> findReservation(const std::string& reservationId) const;
+
+    // Append a change to the journal, then apply it, so a failed append changes nothing.
+    // Those that take a stamp do nothing (and return false) if its change was applied already.
+    bool recordBooking(const Reservation& reservation, const std::optional<TransactionStamp>& stamp = std::nullopt);
+    bool recordBookings(const std::vector<Reservation>& group,    // one lock and one write for all
+                        const std::optional<TransactionStamp>& stamp = std::nullopt);
+    bool recordUpdate(const Reservation& reservation, const std::optional<TransactionStamp>& stamp = std::nullopt);
+    bool recordStatusChange(const std::string& reservationId, const std::string& status);
+    bool recordCancellation(const std::string& reservationId, const std::optional<TransactionStamp>& stamp = std::nullopt);
+
+    // Apply the records other processes appended since the last look
+    void refresh();
+
+    // Grows whenever records from other processes are applied; anything derived from
+    // the reservations must be rebuilt when it changes
+    std::uint64_t getExternalChanges() const { return externalChanges; }
+
+    // Block until every appended record is on disk
+    void flush();
+
+    // Write the current state to the snapshot and drop the folded journal records
+    void compact();
+
+private:
+    ReservationJournal(const std::string& snapshotFile, const std::string& journalFile);
+
+    // Both expect the journal's file lock and the mutex to be held
+    void reload(bool repairTornRecord);
+    void catchUp(bool repairTornRecord);
+
+    void apply(const nlohmann::json& record);
+    bool isApplied(const std::optional<TransactionStamp>& stamp) const;
+    static nlohmann::json makeRecord(nlohmann::json record, const std::optional<TransactionStamp>& stamp);
+    void append(const nlohmann::json& record);
+    void appendLines(const std::string& lines, size_t count);
+    void openJournal();
+    void syncPending(std::unique_lock<std::mutex>& lock);   // releases the mutex while it fsyncs
+    void backgroundLoop();
+    Reservation* find(const std::string& reservationId);   // expects the mutex to be held
+
+    // Batching and compaction policy
+    static constexpr std::chrono::milliseconds flushInterval{50};
+    static constexpr size_t maxPendingRecords = 64;
+    static constexpr size_t compactAfterRecords = 1000;
+
+    std::string snapshotFile;
+    std::string journalFile;
+    std::string lockFile;
+    std::vector<Reservation> reservations;
+    std::unordered_map<std::string, size_t> positions;   // reservation ID -> index in reservations
+    AppliedTransactions applied;
+
+    std::FILE* journal = nullptr;
+    size_t pendingRecords = 0;   // appended but not yet fsynced
+    size_t journalRecords = 0;   // records since the last compaction
+    std::uint64_t readOffset = 0;    // journal bytes already applied
+    std::uint64_t generation = 0;    // journal generation the reservations were loaded from
+    std::atomic<std::uint64_t> externalChanges{0};
+    bool stopping = false;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::thread worker;
+};
+
+#endif
@@ -5,34 +5,89 @@
 #include <iostream>
 #include "../Utils/JsonUtils.hpp"
 #include "../Flight/FlightService.hpp"
+#include "ReservationJournal.hpp"
 #include <vector>
+#include <set>
+#include <unordered_map>
 #include <functional>
 #include <utility>
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <mutex>
 
 class ReservationService
 {
-protected :
-    // Get all reservations
-    std::vector<Reservation> getReservations() const;
-
 public:
     
     ReservationService();
+
+    // Get all reservations
+    std::vector<Reservation> getReservations() const;
+
+    // Reservations of one passenger / on one flight, ordered by reservation ID (cost is proportional to the result)
+    std::vector<Reservation> getReservationsByPassenger(const std::string& passengerId) const;
+    std::vector<Reservation> getReservationsByFlight(const std::string& flightNumber) const;
+
     // Display reservations for a specific passenger
     void displayReservations(const std::string &passengerId);
 
     // Display reservations for a specific passenger
     void displayReservation(const Reservation &reservation);
 
-    // Booking a flight
-    bool bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt);
+    // Booking a flight; a held seat is confirmed, otherwise the seat is claimed now.
+    // The hold is released if the booking fails.
+    bool bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt,
+                    const std::optional<SeatHold>& seatHold = std::nullopt);
+
+    // Book a group with one payment for the total and one write: every seat is claimed
+    // (held seats confirmed) before anything is charged, and either every reservation is
+    // stored or none is and every seat goes back. Every hold is ended either way.
+    bool bookGroup(std::vector<Reservation> &reservations, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt,
+                   const std::vector<SeatHold>& seatHolds = {});
 
     // Find a reservation by ID
-    std::optional<std::reference_wrapper<Reservation>> findReservation(const std::string& reservationId);
+    std::optional<Reservation> findReservation(const std::string& reservationId) const;
 
     // Update the status of a reservation
     void updateReservationStatus(const std::string& reservationId, const std::string& status);
 
+    // Replace a reservation with an edited copy
+    bool updateReservation(const Reservation& reservation);
+
+    // Move a reservation to another seat; the seats and the reservation change in one transaction
+    bool changeSeat(Reservation& reservation, const std::string& newSeatNumber);
+
+    // Remove a reservation. In the same transaction the first eligible passenger on the
+    // flight's waitlist for its cabin class leaves the waitlist, and the seat, still sold,
+    // is offered to them for waitlistOfferTime; with nobody waiting the seat is freed.
+    // An offer that is declined or runs out goes to the next passenger waiting, and the
+    // seat is freed once nobody is left. Offers are kept with the waitlist, so any process
+    // can answer them, and the offer methods first pass on the ones whose time is up.
+    bool cancelReservation(const std::string& reservationId);
+
+    static constexpr std::chrono::minutes waitlistOfferTime{30};
+
+    // A passenger's open waitlist offers
+    std::vector<WaitlistOffer> getWaitlistOffers(const std::string& passengerId) const;
+
+    // Book an offered seat, paid like bookFlight; false if the offer is gone or the booking
+    // fails, in which case the offer stays open for the rest of its time
+    bool acceptWaitlistOffer(const std::string& entryId, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt);
+
+    // Turn an offer down; the seat is offered to the next passenger waiting
+    bool declineWaitlistOffer(const std::string& entryId);
+
+    // Pass on every offer whose time is up
+    static void expireWaitlistOffers();
+
+    // Put a passenger on a full flight's waitlist; fills in the entry's ID and request time.
+    // False if the flight doesn't exist or the passenger already waits for it or holds a seat on it.
+    bool joinWaitlist(WaitlistEntry& entry);
+
+    // A flight's waitlist in offer order
+    std::vector<WaitlistEntry> getWaitlist(const std::string& flightNumber) const;
+
 private:
 
     // Static flight service member to handle viewing flights
@@ -41,13 +96,36 @@ private:
     //Static flight service member to handle payment services
     static inline PaymentService paymentService{};
 
-    // Load reservations from JSON file
-    std::vector<Reservation> loadReservationsFromJson(const std::string &filename) const;
+    // Secondary indexes over the journal (key -> reservation IDs), shared by every service
+    // instance and kept up to date by the methods that change reservations. Services on
+    // several threads share them, so they are guarded by indexMutex.
+    template <typename Key>
+    using ReservationIndex = std::unordered_map<Key, std::set<std::string>>;
+    static inline std::mutex indexMutex{};
+    static inline ReservationIndex<std::string> reservationsByPassenger{};
+    static inline ReservationIndex<Symbol> reservationsByFlight{};   // interned flight numbers
+    static inline bool indexesBuilt = false;
+    static inline std::uint64_t indexedChanges = 0;   // journal's external change count when built
+
+    // Charge for a reservation whose seat transaction already claimed, then store both;
+    // the payment is refunded if the transaction can't be saved
+    static bool payAndRecord(Reservation& reservation, Transaction& transaction, const std::string& paymentMethod,
+                             const std::optional<std::string>& paymentDetails);
+
+    // Claim the first eligible passenger waiting for offer's seat and open the offer to
+    // them, inside transaction; false if nobody is waiting
+    static bool offerToWaitlist(const std::string& flightNumber, WaitlistOffer& offer, Transaction& transaction);
+    static bool hasReservationOn(const std::string& passengerId, std::string_view flightNumber);
 
-    // Save reservations to JSON file
-    void saveReservationsToJson(const std::string& filename) const;
+    // Close an open offer and offer its seat to the next eligible passenger, or free it
+    static bool passOn(const std::string& entryId);
 
-    std::vector<Reservation> reservations;
+    static void indexReservation(const Reservation& reservation);
+    static void unindexReservation(const Reservation& reservation);
+    // Expect indexMutex to be held
+    static void buildIndexes();
+    template <typename Key>
+    static std::vector<Reservation> collectReservations(const ReservationIndex<Key>& index, const Key& key);
 };
 
 #endif
\ No newline at end of file
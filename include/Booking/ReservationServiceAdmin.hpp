@@ -2,6 +2,7 @@
 #define RESERVATIONSERVICEADMIN_HPP
 
 #include "ReservationService.hpp"
+#include <unordered_map>
 
 class ReservationServiceAdmin : public ReservationService
 {
@@ -10,6 +11,9 @@ public:
     // Get the revenue from a flight for reports
     std::pair<int, double> countReservationsAndRevenue(const std::string &flightNumber) const;
 
+    // Reservation count and revenue for every flight, built in one pass over the reservations
+    std::unordered_map<Symbol, std::pair<int, double>> countReservationsAndRevenueByFlight() const;
+
 };
 
 #endif
\ No newline at end of file
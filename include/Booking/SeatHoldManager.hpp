@@ -0,0 +1,99 @@
+#ifndef SEATHOLDMANAGER_HPP
+#define SEATHOLDMANAGER_HPP
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "TransactionManager.hpp"
+#include "../Utils/Symbol.hpp"
+#include "../Utils/TimerWheel.hpp"
+
+// A seat set aside for one booking while the customer pays
+struct SeatHold
+{
+    std::uint64_t id = 0;
+    std::string flightNumber;
+    std::string seatNumber;
+    std::chrono::steady_clock::time_point expiresAt;
+};
+
+// Process-wide seat holds with a time limit.
+// A hold takes the seat in the seat map at once, so nobody else can pick it, but the
+// seat is saved as free until the hold is confirmed into a booking. Holds that are
+// neither confirmed nor released expire on a timer wheel, checked by a background
+// thread every tick, so arming and expiring a hold cost O(1) however many are open.
+// Holds live in this process only; another process sees the seat once it is booked.
+// A hold may carry a handler that is called, outside the manager's lock, when it expires;
+// the seat is then still held in the inventory, and the handler must adopt() it again or
+// free it with SeatInventory::releaseHeldSeat.
+class SeatHoldManager
+{
+public:
+    static constexpr std::chrono::seconds defaultHoldTime{300};
+
+    using ExpiryHandler = std::function<void(const SeatHold&)>;
+
+    // Get the shared hold manager
+    static SeatHoldManager& instance();
+    ~SeatHoldManager();
+
+    // Hold a free seat for ttl; nullopt if the flight or seat doesn't exist or the seat is taken
+    std::optional<SeatHold> hold(std::string_view flightNumber, const std::string& seatNumber, std::chrono::seconds ttl = defaultHoldTime,
+                                 ExpiryHandler onExpire = nullptr);
+
+    // Track a seat the inventory already holds (one whose hold ended with keepSeatHeld, say) as a hold for ttl;
+    // nullopt if the seat isn't held there or another hold already has it
+    std::optional<SeatHold> adopt(std::string_view flightNumber, const std::string& seatNumber, std::chrono::seconds ttl,
+                                  ExpiryHandler onExpire = nullptr);
+
+    // Turn a hold into a seat booking inside transaction; false if the hold expired or was released
+    bool confirm(const SeatHold& seatHold, Transaction& transaction);
+
+    // Give a held seat back before it expires (false if it already ended); with keepSeatHeld
+    // the hold ends but the inventory keeps the seat held, ready to adopt() for someone else
+    bool release(const SeatHold& seatHold, bool keepSeatHeld = false);
+
+    bool isActive(const SeatHold& seatHold) const;
+    size_t getActiveCount() const;
+
+    // Release every hold whose time is up; the background thread calls this every tick
+    size_t expire(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+private:
+    SeatHoldManager();
+
+    void backgroundLoop();
+    SeatHold track(std::string_view flightNumber, const std::string& seatNumber, int seatIndex,
+                   std::chrono::seconds ttl, ExpiryHandler onExpire);   // caller holds the mutex
+
+    struct ActiveHold
+    {
+        Symbol flightNumber;
+        int seatIndex;
+        TimerWheel::TimerId timer;
+        SeatHold seatHold;
+        ExpiryHandler onExpire;
+    };
+
+    static constexpr std::chrono::milliseconds tick{100};
+
+    std::unordered_map<std::uint64_t, ActiveHold> holds;   // hold ID -> hold
+    TimerWheel wheel{tick};
+    std::uint64_t nextId = 1;
+    bool stopping = false;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::thread worker;
+};
+
+#endif
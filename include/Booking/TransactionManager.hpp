@@ -0,0 +1,171 @@
+#ifndef TRANSACTIONMANAGER_HPP
+#define TRANSACTIONMANAGER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <optional>
+#include <utility>
+#include <nlohmann/json.hpp>
+#include "Reservation.hpp"
+#include "ReservationJournal.hpp"
+#include "Waitlist.hpp"
+#include "TransactionStamp.hpp"
+#include "../Flight/SeatInventory.hpp"
+#include "../Utils/FileLock.hpp"
+
+// One atomic change to the seat maps and the reservations.
+// Booked seats are held at once (see SeatInventory::holdSeat), so a seat taken by someone
+// else in this process is noticed before anything is written, and waitlist claims take
+// effect at once too; both are undone if the transaction is rolled back or destroyed
+// without committing. On commit the booked seats are claimed in the seat log, which
+// fails the transaction if another process sold one of them, then the transaction is
+// journaled. Its seats are settled and its reservation changes applied once it is durable.
+class Transaction
+{
+public:
+    Transaction();
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    // Seat changes; false if the flight or seat doesn't exist or the seat is in the wrong state
+    bool bookSeat(std::string_view flightNumber, const std::string& seatNumber);
+    bool releaseSeat(std::string_view flightNumber, const std::string& seatNumber);
+    bool moveSeat(std::string_view flightNumber, const std::string& fromSeat, const std::string& toSeat);
+
+    // Book a seat this process holds (see SeatInventory::holdSeat); false if it isn't held
+    bool bookHeldSeat(std::string_view flightNumber, const std::string& seatNumber);
+
+    // Waitlist changes. Joining and opening an offer take effect on commit; a claimed entry
+    // leaves the waitlist and a taken offer closes at once (so no one else offers the
+    // entry a seat or ends the offer too), and both return on rollback.
+    void joinWaitlist(const WaitlistEntry& entry);
+    std::optional<WaitlistEntry> claimFromWaitlist(std::string_view flightNumber, std::string_view cabinClass);
+    void openOffer(const WaitlistOffer& offer);
+    std::optional<WaitlistOffer> takeOffer(const std::string& entryId);
+
+    // Reservation changes
+    void recordBooking(const Reservation& reservation);
+    void recordBookings(const std::vector<Reservation>& group);   // stored with a single journal write
+    void recordUpdate(const Reservation& reservation);
+    void recordCancellation(const std::string& reservationId);
+
+    // Write the whole change as one intent record and apply it; rolls back and returns false on failure
+    bool commit();
+    void rollback();
+
+private:
+    struct SeatChange
+    {
+        std::string flightNumber;
+        int index;
+        bool booked;          // true if the change booked the seat
+    };
+
+    bool changeSeat(std::string_view flightNumber, const std::string& seatNumber, bool book);
+    void finish();
+
+    nlohmann::json operations = nlohmann::json::array();
+    std::vector<SeatChange> seatChanges;
+    std::vector<WaitlistEntry> claimedEntries;
+    std::vector<WaitlistOffer> takenOffers;
+    bool finished = false;
+};
+
+// Process-wide intent journal for transactions over the seats and the reservations.
+// Each committed transaction is one JSON line in this process's own journal
+// (transactions-<pid>.journal, locked for the process's lifetime) followed by a commit
+// line, both in one write. Its booked seats are claimed in the shared seat log just
+// before (see SeatInventory), and the seat log is synced with the journal. Concurrent
+// commits share the fsyncs: the first committer to arrive syncs everything written so
+// far while the others wait for it. A failed write or sync cuts the journal back to where
+// the failed records began and withdraws their claims, so a rolled-back transaction never
+// stays in it. The stores, seats.dat included, are only written at checkpoints, after
+// which the journal is emptied. Startup replays whatever the journal still holds, seats
+// included, so a crash between the stores' writes loses nothing; it also recovers and
+// removes the journals of processes that died without a checkpoint, and frees the seats
+// they claimed for transactions that never committed.
+class TransactionManager
+{
+public:
+    // Get the shared manager for this process's journal in data/ (recovers journals on first use)
+    static TransactionManager& instance();
+    ~TransactionManager();
+
+    // Claim the booked seats, append one transaction's operations and block until they
+    // are on disk, then settle its seats and apply the rest, stamped, after every earlier
+    // transaction's. False if another process has a booked seat; throws
+    // std::runtime_error if the journal can't be written.
+    bool commit(const nlohmann::json& operations);
+
+    // Save the seats and the waitlist, sync the reservation journal and empty the intent journal
+    void checkpoint();
+
+    // Apply one logged operation that isn't a seat change to the in-memory stores; with a
+    // stamp, only if the store hasn't yet
+    static void apply(const nlohmann::json& operation, const std::optional<TransactionStamp>& stamp = std::nullopt);
+    static bool isSeatOperation(const nlohmann::json& operation);
+
+    // Whether the intent journal with this ID still exists, so its transactions may be replayed
+    static bool hasJournal(const std::string& journalId);
+
+private:
+    friend class Transaction;
+
+    TransactionManager(const std::string& directory, const std::string& journalStem);
+
+    void recover(const std::string& directory, const std::string& journalStem);
+    size_t replay(const std::string& file);
+    static void redo(const nlohmann::json& record);
+    // Settle a replayed transaction's seats (see SeatInventory::commitSeats)
+    static void settleSeats(const nlohmann::json& operations, const std::optional<TransactionStamp>& stamp);
+    void openJournal();
+    void truncateJournal(std::uint64_t size);   // caller holds the mutex, no sync running
+    void withdrawClaims(std::uint64_t afterTxn);  // caller holds the mutex
+    void backgroundLoop();
+
+    // Open transactions hold off checkpoints, which would otherwise save half-made changes.
+    // A thread may open one inside another. Don't keep one open while waiting for user input.
+    void beginTransaction();
+    void endTransaction();
+
+    // Checkpoint policy
+    static constexpr std::chrono::milliseconds checkpointInterval{1000};
+    static constexpr size_t checkpointAfterTransactions = 256;
+
+    std::string journalFile;
+    std::string journalId;                 // this process's journal, unique across runs
+    std::unique_ptr<FileLock> ownerLock;   // marks the journal as live to other processes
+    std::FILE* journal = nullptr;          // unbuffered, so every record is one write
+    std::uint64_t appended = 0;        // transactions written to the journal
+    std::uint64_t durable = 0;         // transactions known to be on disk
+    std::uint64_t applied = 0;         // transactions applied to the stores, in order
+    std::uint64_t journalSize = 0;     // bytes written to the journal
+    std::uint64_t durableSize = 0;     // bytes known to be on disk
+    bool syncing = false;              // a committer is running the group's fsync
+    bool broken = false;               // a failed record couldn't be cut off; no commits until a checkpoint
+    std::vector<std::uint64_t> cutBackTo;  // durable count at each cut after a failed sync; later records were lost
+    std::vector<std::pair<std::uint64_t, nlohmann::json>> unsettled;   // applied transactions whose seats the log missed
+    size_t sinceCheckpoint = 0;        // transactions in the journal
+    size_t openTransactions = 0;
+    bool checkpointing = false;
+    bool stopping = false;
+
+    std::mutex mutex;
+    std::condition_variable synced;
+    std::condition_variable appliedInOrder;
+    std::condition_variable idle;
+    std::condition_variable wakeUp;
+    std::thread worker;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef TRANSACTIONSTAMP_HPP
+#define TRANSACTIONSTAMP_HPP
+
+#include <string>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <functional>
+#include <nlohmann/json.hpp>
+
+// Names one operation of a committed transaction: the intent journal that logged it
+// (see TransactionManager), the transaction's sequence number there and the
+// operation's position in it. Stores record the stamps of the operations they apply,
+// so replaying a journal can tell what already happened from what didn't.
+struct TransactionStamp
+{
+    std::string journal;
+    std::uint64_t txn = 0;
+    std::uint32_t index = 0;
+
+    nlohmann::json toJson() const;
+    static TransactionStamp fromJson(const nlohmann::json& j);
+};
+
+// The newest operation a store applied from each intent journal. A journal's
+// operations are applied in order, so one stamp per journal covers all of its earlier ones.
+class AppliedTransactions
+{
+public:
+    bool contains(const TransactionStamp& stamp) const;
+    void add(const TransactionStamp& stamp);
+    void merge(const AppliedTransactions& other);
+
+    // Forget the journals keep rejects (ones that can never be replayed again)
+    void prune(const std::function<bool(const std::string&)>& keep);
+
+    bool empty() const { return newest.empty(); }
+    void clear() { newest.clear(); }
+
+    // {"<journal>": [txn, index], ...}
+    nlohmann::json toJson() const;
+    static AppliedTransactions fromJson(const nlohmann::json& j);
+
+private:
+    std::map<std::string, std::pair<std::uint64_t, std::uint32_t>> newest;   // journal -> (txn, index)
+};
+
+#endif
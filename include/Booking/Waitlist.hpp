@@ -0,0 +1,160 @@
+#ifndef WAITLIST_HPP
+#define WAITLIST_HPP
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <tuple>
+#include <nlohmann/json.hpp>
+#include "TransactionStamp.hpp"
+#include "../Utils/JsonUtils.hpp"
+
+// Loyalty tiers, lowest first; a higher tier goes ahead on the waitlist
+enum class LoyaltyTier
+{
+    None,
+    Silver,
+    Gold,
+    Platinum
+};
+
+std::string_view loyaltyTierName(LoyaltyTier tier);
+LoyaltyTier parseLoyaltyTier(std::string_view name);   // case-insensitive, None if unknown
+LoyaltyTier loyaltyTierForPoints(int points);
+
+// A passenger waiting for a seat on a full flight
+struct WaitlistEntry
+{
+    std::string entryId;
+    std::string passengerId;
+    std::string passengerName;
+    std::string flightNumber;
+    std::string cabinClass;          // class of service wanted, empty for any
+    LoyaltyTier tier = LoyaltyTier::None;
+    std::int64_t requestedAt = 0;    // milliseconds since the epoch
+
+    nlohmann::json toJson() const;
+    static WaitlistEntry fromJson(const nlohmann::json& j);
+};
+
+// A cancelled seat kept for a waitlisted passenger, who left the queue for it, until they
+// accept and pay for it, turn it down or run out of time. The seat stays sold meanwhile.
+struct WaitlistOffer
+{
+    WaitlistEntry entry;             // the flight is the entry's
+    std::string seatNumber;
+    std::string gate;
+    std::string boardingTime;
+    double price = 0.0;
+    std::int64_t expiresAt = 0;      // milliseconds since the epoch
+
+    nlohmann::json toJson() const;
+    static WaitlistOffer fromJson(const nlohmann::json& j);
+};
+
+// Process-wide waitlists of every flight, saved to data/waitlist.json.
+// Each flight has one priority queue per cabin class plus one for passengers who take
+// any class, ordered by loyalty tier (highest first), then request time. The next
+// passenger for a freed seat is the better of the two queue heads for its class, so
+// promotion costs O(log n) and never looks at the reservations.
+// Changes go through transactions (see Transaction::joinWaitlist and
+// Transaction::claimFromWaitlist) and the file is written at checkpoints. Other
+// processes save the same file; entries are merged by ID like the seat maps are:
+// entries this process added or removed since it last synced keep that, the rest
+// follow the file. The file also keeps the stamps of the transactions applied to it
+// (see TransactionStamp), so a replayed transaction isn't applied twice.
+// Open offers are kept and merged the same way, so every process sees them and any of
+// them can pass on an offer whose time is up.
+class Waitlist
+{
+public:
+    // Get the shared waitlist for data/waitlist.json
+    static Waitlist& instance();
+
+    // Put an entry in its queue; false if the ID is taken, the passenger already waits
+    // for the flight or the stamp's change was applied already
+    bool add(const WaitlistEntry& entry, const std::optional<TransactionStamp>& stamp = std::nullopt);
+
+    // Take an entry off its queue (false if it isn't waiting or the stamp's change was applied already)
+    bool remove(const std::string& entryId, const std::optional<TransactionStamp>& stamp = std::nullopt);
+
+    // Take the first passenger in line for a seat of cabinClass off the waitlist
+    std::optional<WaitlistEntry> claimNext(std::string_view flightNumber, std::string_view cabinClass);
+
+    bool isWaiting(std::string_view flightNumber, const std::string& passengerId) const;
+
+    // A flight's entries in the order they'd be offered seats of their class
+    std::vector<WaitlistEntry> getEntries(std::string_view flightNumber) const;
+    size_t size() const;
+
+    // Open an offer (false if the entry already has one or the stamp's change was applied already)
+    bool openOffer(const WaitlistOffer& offer, const std::optional<TransactionStamp>& stamp = std::nullopt);
+
+    // Close an offer (false if it isn't open or the stamp's change was applied already)
+    bool closeOffer(const std::string& entryId, const std::optional<TransactionStamp>& stamp = std::nullopt);
+
+    // Close an open offer and return it
+    std::optional<WaitlistOffer> takeOffer(const std::string& entryId);
+
+    // A passenger's open offers, and the entry IDs of the offers open past now (milliseconds since the epoch)
+    std::vector<WaitlistOffer> getOffers(const std::string& passengerId) const;
+    std::vector<std::string> getExpiredOffers(std::int64_t now) const;
+
+    // Save the waitlists to the file (replaced atomically)
+    void save();
+
+    // Merge in entries another process saved since this one last read or wrote the file
+    void refresh();
+
+private:
+    explicit Waitlist(const std::string& filename);
+
+    // Queue order: higher tier first, then earlier request, then entry ID
+    struct QueueKey
+    {
+        int priority;   // minus the tier
+        std::int64_t requestedAt;
+        std::string entryId;
+
+        bool operator<(const QueueKey& other) const
+        {
+            return std::tie(priority, requestedAt, entryId) < std::tie(other.priority, other.requestedAt, other.entryId);
+        }
+    };
+    using Queue = std::set<QueueKey>;
+
+    static QueueKey keyOf(const WaitlistEntry& entry);
+    static std::string passengerKey(std::string_view flightNumber, const std::string& passengerId);
+
+    // Expect the mutex to be held
+    bool insert(const WaitlistEntry& entry);
+    bool erase(const std::string& entryId);
+    std::unordered_map<std::string, WaitlistEntry> readFile(AppliedTransactions& fileApplied,
+                                                            std::unordered_map<std::string, WaitlistOffer>& fileOffers) const;
+    bool stampApplied(const std::optional<TransactionStamp>& stamp);
+    void mergeFromFile();
+
+    std::string filename;
+    std::unordered_map<std::string, WaitlistEntry> entries;                 // entry ID -> entry
+    std::map<std::string, std::map<std::string, Queue, std::less<>>, std::less<>> queues; // flight -> cabin class -> queue
+    std::unordered_set<std::string> waitingPassengers;                       // flight + passenger ID
+    std::map<std::string, WaitlistOffer> offers;                             // entry ID -> open offer
+    AppliedTransactions applied;
+    bool changed = false;                                                    // since the last save
+    mutable std::mutex mutex;
+    std::mutex fileMutex;
+
+    // Entry and offer IDs in the file as this process last read or wrote it, the base for merging
+    JsonUtils::FileVersion syncedVersion{};
+    std::unordered_set<std::string> syncedIds;
+    std::unordered_set<std::string> syncedOfferIds;
+};
+
+#endif
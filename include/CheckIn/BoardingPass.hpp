@@ -24,12 +24,12 @@ public:
                  const std::string &seatNumber, const std::string &gate, const std::string &boardingTime);
 
     // Getters
-    std::string getReservationId() const { return reservationId; }
-    std::string getPassengerName() const { return passengerName; }
-    std::string getFlightNumber() const { return flightNumber; }
-    std::string getSeatNumber() const { return seatNumber; }
-    std::string getGate() const { return gate; }
-    std::string getBoardingTime() const { return boardingTime; }
+    const std::string& getReservationId() const { return reservationId; }
+    const std::string& getPassengerName() const { return passengerName; }
+    const std::string& getFlightNumber() const { return flightNumber; }
+    const std::string& getSeatNumber() const { return seatNumber; }
+    const std::string& getGate() const { return gate; }
+    const std::string& getBoardingTime() const { return boardingTime; }
 
     // Display boarding pass
     void display() const;
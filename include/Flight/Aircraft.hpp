@@ -5,45 +5,50 @@
 #include <stdexcept>
 #include <vector>
 #include <utility>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include "../Utils/JsonUtils.hpp"
+#include "../Utils/JsonStreamReader.hpp"
+#include "../Utils/Reflection.hpp"
+#include "MaintenanceRepository.hpp"
+#include "CabinLayout.hpp"
 
 class Aircraft
 {
 private:
     std::string aircraftId;
     std::string aircraftType;
-    int capacity;
+    int capacity = 0;
     std::string maintenanceDue;
     std::string status;
-    std::vector<std::string> maintenanceSchedule; // List of scheduled maintenance dates
-    std::vector<std::pair<std::string, std::string>> maintenanceLogs;    // Details of maintenance activities
-    double utilization; // Percentage of time in use
+    double utilization = 0.0; // Percentage of time in use
 
-
-    void loadMaintenanceLogs();
-    void loadMaintenanceSchedule();
-    void saveMaintenanceLogs() const;
-    void saveMaintenanceSchedule() const;
 public:
-    Aircraft(const std::string& aircraftId,const std::string& aircraftType,int capacity,
-            const std::string& maintenanceDue, const std::string& status);
+    Aircraft() = default;
+    Aircraft(std::string aircraftId, std::string aircraftType, int capacity,
+            std::string maintenanceDue, std::string status);
     ~Aircraft() = default;
 
      // Getters
-     std::string getId() const { return aircraftId; }
-     std::string getAircraftType() const { return aircraftType; }
+     const std::string& getId() const { return aircraftId; }
+     const std::string& getAircraftType() const { return aircraftType; }
      int getCapacity() const { return capacity; }
-     int getRows() const { return capacity/6 ;}
-     std::string getMaintenanceDue() const { return maintenanceDue; }
+     int getRows() const { return getLayout().getRows(); }
+     int getSeatCount() const { return getLayout().getSeatCount(); }
+
+     // Cabin layout of the aircraft type, or a standard six-abreast cabin for its capacity
+     const CabinLayout& getLayout() const { return CabinLayout::forAircraft(aircraftType, capacity); }
+     const std::string& getMaintenanceDue() const { return maintenanceDue; }
      double getUtilization() const { return utilization; }
-     std::string getStatus() const { return status; }
+     const std::string& getStatus() const { return status; }
 
-     // Get maintenance logs
-    const std::vector<std::pair<std::string, std::string>>& getMaintenanceLogs() const { return maintenanceLogs; }
+     // Get maintenance logs (shared per aircraft ID, loaded on first access)
+    const std::vector<std::pair<std::string, std::string>>& getMaintenanceLogs() const
+    { return MaintenanceRepository::instance().getLogs(aircraftId); }
 
     // Get maintenance schedule
-    const std::vector<std::string>& getMaintenanceSchedule() const { return maintenanceSchedule; }
+    const std::vector<std::string>& getMaintenanceSchedule() const
+    { return MaintenanceRepository::instance().getSchedule(aircraftId); }
  
      // Setters
      void setId(const std::string& newId) { aircraftId = newId; }
@@ -67,6 +72,20 @@ public:
     // Serialization
     static Aircraft fromJson(const nlohmann::json& j);
     nlohmann::json toJson() const;
+
+    // Persisted fields; drives toJson, the streaming loader and the binary format
+    static constexpr auto fields()
+    {
+        using Reflection::field;
+        return std::make_tuple(
+            field("aircraftId", &Aircraft::aircraftId),
+            field("aircraftType", &Aircraft::aircraftType),
+            field("capacity", &Aircraft::capacity),
+            field("maintenanceDue", &Aircraft::maintenanceDue),
+            field("status", &Aircraft::status));
+    }
+
+    using Builder = Reflection::Builder<Aircraft>;
 };
 
 
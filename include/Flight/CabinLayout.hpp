@@ -0,0 +1,194 @@
+#ifndef CABINLAYOUT_HPP
+#define CABINLAYOUT_HPP
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// One class of service, a run of rows from the front of the cabin
+struct CabinClass
+{
+    std::string_view name;
+    int rows = 0;
+};
+
+// Seat arrangement of an aircraft type: the letters of its columns, the aisles between
+// them, its cabin classes front to back and the row numbers it skips (often 13).
+// Every cabin uses the full width of the aircraft.
+//
+// A seat map stores seat (row, col) at bit row * cols + col, with rows and columns
+// counted from 0. The layout's tables translate between those positions and labels
+// ("14C") in both directions by array lookup. Layouts for known aircraft types are
+// constexpr, so their tables are built by the compiler; other cabins get a standard
+// layout (rows from 1, letters from A) made once per size.
+class CabinLayout
+{
+public:
+    static constexpr int maxColumns = 26;
+    static constexpr int maxRows = 999;
+    static constexpr int maxClasses = 4;
+    static constexpr int maxSkippedRows = 16;
+
+    constexpr CabinLayout(std::string_view aircraftType, std::string_view columnLetters, std::string_view aislesAfter,
+                          std::initializer_list<CabinClass> cabinClasses, std::initializer_list<int> skippedRows = {})
+        : name(aircraftType), cols(static_cast<int>(columnLetters.size()))
+    {
+        if (cols <= 0 || cols > maxColumns || cabinClasses.size() == 0 || cabinClasses.size() > maxClasses ||
+            skippedRows.size() > maxSkippedRows)
+        {
+            throw std::invalid_argument("Invalid cabin layout");
+        }
+
+        for (int col = 0; col < cols; col++)
+        {
+            char letter = columnLetters[col];
+            if (letter < 'A' || letter > 'Z' || columnOfLetter[letter - 'A'] >= 0)
+            {
+                throw std::invalid_argument("Invalid cabin column letter");
+            }
+            letters[col] = letter;
+            columnOfLetter[letter - 'A'] = static_cast<std::int8_t>(col);
+        }
+        for (char letter : aislesAfter)
+        {
+            int col = letter >= 'A' && letter <= 'Z' ? columnOfLetter[letter - 'A'] : -1;
+            if (col < 0 || col + 1 >= cols)
+            {
+                throw std::invalid_argument("Aisle outside the cabin");
+            }
+            aisleMask |= std::uint64_t{1} << col;
+        }
+
+        for (const CabinClass &cabinClass : cabinClasses)
+        {
+            classes[classCount++] = cabinClass;
+            rows += cabinClass.rows;
+        }
+        if (rows < 0 || rows > maxRows)
+        {
+            throw std::invalid_argument("Invalid cabin row count");
+        }
+
+        // Number the rows, stepping over the skipped numbers
+        int number = 1;
+        for (int row = 0; row < rows; row++, number++)
+        {
+            while (isSkipped(number, skippedRows))
+            {
+                number++;
+            }
+            rowNumbers[row] = static_cast<std::uint16_t>(number);
+            rowOfNumber[number] = static_cast<std::int16_t>(row);
+        }
+    }
+
+    // Layout for an aircraft type, nullptr if it has none
+    static const CabinLayout* find(std::string_view aircraftType);
+
+    // Layout rows by cols, rows numbered from 1 and columns lettered from A, aisles as
+    // usual for the width: one in the middle up to six abreast, two from seven on
+    static const CabinLayout& standard(int rows, int cols);
+
+    // The aircraft type's layout, or a six-abreast standard layout holding capacity
+    static const CabinLayout& forAircraft(std::string_view aircraftType, int capacity);
+
+    // Aircraft type, empty for a standard layout
+    constexpr std::string_view getName() const { return name; }
+    constexpr int getRows() const { return rows; }
+    constexpr int getCols() const { return cols; }
+    constexpr int getSeatCount() const { return rows * cols; }
+
+    // Label tables
+    constexpr int rowNumber(int row) const { return rowNumbers[row]; }
+    constexpr char columnLetter(int col) const { return letters[col]; }
+    constexpr int rowOf(int number) const { return number > 0 && number < maxRowNumber ? rowOfNumber[number] : -1; }
+    constexpr int columnOf(char letter) const
+    {
+        if (letter >= 'a' && letter <= 'z')
+        {
+            letter = static_cast<char>(letter - 'a' + 'A');
+        }
+        return letter >= 'A' && letter <= 'Z' ? columnOfLetter[letter - 'A'] : -1;
+    }
+
+    // Seat index of a label such as "14C", -1 if the cabin has no such seat
+    constexpr int seatIndex(std::string_view label) const
+    {
+        if (label.size() < 2 || label.size() > 5)
+        {
+            return -1;
+        }
+        int number = 0;
+        for (size_t i = 0; i + 1 < label.size(); i++)
+        {
+            if (label[i] < '0' || label[i] > '9')
+            {
+                return -1;
+            }
+            number = number * 10 + (label[i] - '0');
+        }
+        int row = rowOf(number);
+        int col = columnOf(label.back());
+        return row < 0 || col < 0 ? -1 : row * cols + col;
+    }
+
+    std::string seatLabel(int index) const;
+
+    // Aisles: bit col set means there is an aisle between col and col + 1
+    std::uint64_t getAisleMask() const { return aisleMask; }
+    bool hasAisleAfter(int col) const { return (aisleMask >> col) & 1; }
+
+    // Cabin classes front to back
+    int getClassCount() const { return classCount; }
+    const CabinClass& getClass(int index) const { return classes[index]; }
+
+    // Class of service of a row (0-based)
+    std::string_view cabinClassOf(int row) const;
+
+    // First and one-past-last row (0-based) of a class, {0, 0} if the layout has no such class
+    std::pair<int, int> rowsOfClass(std::string_view className) const;
+
+private:
+    static constexpr int maxRowNumber = maxRows + maxSkippedRows + 1;
+
+    static constexpr bool isSkipped(int number, std::initializer_list<int> skippedRows)
+    {
+        for (int skipped : skippedRows)
+        {
+            if (skipped == number)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string_view name;
+    int rows = 0;
+    int cols = 0;
+    std::uint64_t aisleMask = 0;
+    std::array<CabinClass, maxClasses> classes{};
+    int classCount = 0;
+
+    std::array<char, maxColumns> letters{};
+    std::array<std::int8_t, maxColumns> columnOfLetter = filled<std::int8_t, maxColumns>(-1);
+    std::array<std::uint16_t, maxRows> rowNumbers{};
+    std::array<std::int16_t, maxRowNumber> rowOfNumber = filled<std::int16_t, maxRowNumber>(-1);
+
+    template <typename T, size_t N>
+    static constexpr std::array<T, N> filled(T value)
+    {
+        std::array<T, N> values{};
+        for (auto &entry : values)
+        {
+            entry = value;
+        }
+        return values;
+    }
+};
+
+#endif
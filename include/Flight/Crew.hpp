@@ -4,6 +4,8 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
+#include "../Utils/Reflection.hpp"
 
 class Crew
 {
@@ -11,24 +13,82 @@ private:
     std::string crewId;
     std::string name;
     std::string role;
-    double totalFlightHours;
+    double totalFlightHours = 0;
     std::vector<std::string> assignedFlights;
 
 public:
+    Crew() = default;
     Crew(const std::string& id, const std::string& name, const std::string& role, double totalFlightHours = 0);
     ~Crew()= default;
 
 
     // Getters
-    std::string getCrewId() const { return crewId; }
-    std::string getName() const { return name; }
-    std::string getRole() const { return role; }
+    const std::string& getCrewId() const { return crewId; }
+    const std::string& getName() const { return name; }
+    const std::string& getRole() const { return role; }
     double getTotalFlightHours() const { return totalFlightHours; }
     const std::vector<std::string>& getAssignedFlights() const { return assignedFlights; }
 
     // Assign a flight
     bool assignFlight(const std::string& flightNumber, double flightDuration);
 
+    // Fields of a crew roster entry (crew.json keeps the role implicit in which list holds it)
+    static constexpr auto fields()
+    {
+        using Reflection::field;
+        return std::make_tuple(
+            field("id", &Crew::crewId),
+            field("name", &Crew::name),
+            field("role", &Crew::role),
+            field("totalFlightHours", &Crew::totalFlightHours),
+            field("assignedFlights", &Crew::assignedFlights));
+    }
+
+    using Builder = Reflection::Builder<Crew>;
+};
+
+// Crew embedded in a flight record as {"id", "name", "role"}
+template <>
+struct Reflection::Codec<std::shared_ptr<Crew>>
+{
+    static nlohmann::json toJson(const std::shared_ptr<Crew>& crew)
+    {
+        return {{"id", crew->getCrewId()}, {"name", crew->getName()}, {"role", crew->getRole()}};
+    }
+
+    static void read(std::shared_ptr<Crew>& target, nlohmann::json&& crewJson)
+    {
+        if (crewJson.is_null())
+        {
+            target.reset();
+            return;
+        }
+        target = std::make_shared<Crew>(crewJson.at("id").get<std::string>(), crewJson.at("name").get<std::string>(),
+                                        crewJson.at("role").get<std::string>());
+    }
+
+    static void writeBinary(BinaryWriter& out, const std::shared_ptr<Crew>& crew)
+    {
+        out.writeU8(crew ? 1 : 0);
+        if (crew)
+        {
+            out.writeString(crew->getCrewId());
+            out.writeString(crew->getName());
+            out.writeString(crew->getRole());
+        }
+    }
+
+    static void readBinary(BinaryReader& in, std::shared_ptr<Crew>& target)
+    {
+        target.reset();
+        if (in.readU8())
+        {
+            std::string id(in.readString());
+            std::string name(in.readString());
+            std::string role(in.readString());
+            target = std::make_shared<Crew>(id, name, role);
+        }
+    }
 };
 
 
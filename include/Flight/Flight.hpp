@@ -9,27 +9,33 @@
 #include <iomanip>
 #include <sstream>
 #include <ctime>
+#include <cstdint>
+#include <string_view>
 #include "Crew.hpp" 
+#include "../Utils/Timestamp.hpp"
+#include "../Utils/Symbol.hpp"
+#include "../Utils/JsonStreamReader.hpp"
+#include "../Utils/Reflection.hpp"
 
 class Flight
 {
 private:
-    std::string FlightNumber;
-    std::string Origin;
-    std::string Destination;
-    std::string DepartureDate;
-    std::string ArrivalDate;
-    std::string AircraftType;
-    std::string Status;
-    int duration;
-    int TotalSeats;
-    int availableSeats;
-    double price;
+    // Repeated values are interned; each is a 4-byte symbol
+    Symbol FlightNumber;
+    Symbol Origin;
+    Symbol Destination;
+    Reflection::StoredTimestamp departureTime;   // UTC epoch seconds
+    Reflection::StoredTimestamp arrivalTime;
+    Symbol AircraftType;
+    Symbol Status;
+    int TotalSeats = 0;
+    int availableSeats = 0;
+    double price = 0.0;
     std::shared_ptr<Crew> pilot; // Only 1 pilot
     std::vector<std::shared_ptr<Crew>> flightAttendants; // Multiple flight attendants
 
-    // Method to calculate flight duration
-    int calculateFlightDuration() ;
+    // Parse a timestamp from the data files, reporting bad input
+    static Reflection::StoredTimestamp parseTime(const std::string &text);
 public:
     Flight()=default;
     Flight(std::string FlightNum, std::string origin, std::string destination,
@@ -38,30 +44,41 @@ public:
     ~Flight()= default;
 
     // Getters
-    std::string getFlightNumber() const { return FlightNumber; }
-    std::string getOrigin() const { return Origin; }
-    std::string getDestination() const { return Destination; }
-    std::string getDepartureDateAndTime() const { return DepartureDate; }
-    std::string getArrivalDate() const { return ArrivalDate; }
-    std::string getAircraftType() const { return AircraftType; }
-    std::string getStatus() const { return Status; }
+    std::string_view getFlightNumber() const { return FlightNumber.view(); }
+    std::string_view getOrigin() const { return Origin.view(); }
+    std::string_view getDestination() const { return Destination.view(); }
+    std::string getDepartureDateAndTime() const { return Timestamp::format(departureTime.time); }
+    std::string getArrivalDate() const { return Timestamp::format(arrivalTime.time); }
+    std::string_view getAircraftType() const { return AircraftType.view(); }
+    std::string_view getStatus() const { return Status.view(); }
     int getTotalSeats() const { return TotalSeats; }
     int getAvailableSeats() const { return availableSeats; }
     double getPrice() const { return price; }
-    int getDuration() const { return duration; }
+    std::int64_t getDepartureTime() const { return departureTime.time; }
+    std::int64_t getArrivalTime() const { return arrivalTime.time; }
+    std::int64_t getDepartureDay() const { return Timestamp::dayOf(departureTime.time); }
 
-    std::string getPilotName() const { return pilot->getName(); }
-    std::string getPilotId() const { return pilot->getCrewId(); }
+    // Flight duration in whole hours, -1 if a time is missing
+    int getDuration() const;
+
+    // Interned values for integer compares in filters and indexes
+    Symbol getFlightNumberSymbol() const { return FlightNumber; }
+    Symbol getOriginSymbol() const { return Origin; }
+    Symbol getDestinationSymbol() const { return Destination; }
+    Symbol getStatusSymbol() const { return Status; }
+
+    const std::string& getPilotName() const { return pilot->getName(); }
+    const std::string& getPilotId() const { return pilot->getCrewId(); }
     std::vector<std::string> getFlightAttendantNames() const;
     std::vector<std::string> getFlightAttendantIds() const;
-    std::string getDepartureDate() const;
+    std::string getDepartureDate() const { return Timestamp::formatDate(departureTime.time); }
 
     // Setters
     void setFlightNumber(const std::string &flightNum) { FlightNumber = flightNum; }
     void setOrigin(const std::string &origin) { Origin = origin; }
     void setDestination(const std::string &destination) { Destination = destination; }
-    void setDepartureDate(const std::string &departureDate) { DepartureDate = departureDate; }
-    void setArrivalDate(const std::string &arrivalDate) { ArrivalDate = arrivalDate; }
+    void setDepartureDate(const std::string &departureDate) { departureTime = parseTime(departureDate); }
+    void setArrivalDate(const std::string &arrivalDate) { arrivalTime = parseTime(arrivalDate); }
     void setAircraftType(const std::string &aircraftType) { AircraftType = aircraftType; }
     void setStatus(const std::string &status) { Status = status; }
     void setTotalSeats(int totalSeats) { TotalSeats = totalSeats; }
@@ -79,7 +96,27 @@ public:
     nlohmann::json toJson() const;
     static Flight fromJson(const nlohmann::json &j);
 
-    
+    // Persisted fields; drives toJson, the streaming loader and the binary format
+    static constexpr auto fields()
+    {
+        using Reflection::field;
+        using Reflection::optionalField;
+        return std::make_tuple(
+            field("flightNumber", &Flight::FlightNumber),
+            field("origin", &Flight::Origin),
+            field("destination", &Flight::Destination),
+            field("departure", &Flight::departureTime),
+            field("arrival", &Flight::arrivalTime),
+            field("aircraftModel", &Flight::AircraftType),
+            field("status", &Flight::Status),
+            field("totalSeats", &Flight::TotalSeats),
+            field("availableSeats", &Flight::availableSeats),
+            field("price", &Flight::price),
+            optionalField("pilot", &Flight::pilot),
+            optionalField("flightAttendants", &Flight::flightAttendants));
+    }
+
+    using Builder = Reflection::Builder<Flight>;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef FLIGHTCATALOG_HPP
+#define FLIGHTCATALOG_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <shared_mutex>
+#include "Flight.hpp"
+#include "SeatInventory.hpp"
+#include "../Utils/JsonUtils.hpp"
+
+// Process-wide resident copy of the flight schedule.
+// The file is parsed once and only read again when its version changes, i.e. when
+// this or another process has saved it. Changes are made under the file's exclusive
+// lock on top of the latest saved schedule, so concurrent admins don't undo each other.
+// The schedule is copy-on-write: a change or reload builds a new one and swaps it in
+// under the mutex, so the flights and lists handed out are immutable snapshots that
+// stay valid for as long as the caller keeps them. Look a flight up again to see changes.
+class FlightCatalog
+{
+public:
+    using FlightHandle = std::shared_ptr<const Flight>;
+    using FlightList = std::shared_ptr<const std::vector<FlightHandle>>;
+
+    // Get the shared catalog for data/flights.json
+    static FlightCatalog& instance();
+
+    // Get all flights in file order (reloads first if the file was modified)
+    FlightList getFlights();
+
+    // Find a flight by its number, nullptr if it doesn't exist
+    FlightHandle findFlight(std::string_view flightNumber);
+
+    // Find the flights on a route departing on a given day (YYYY-MM-DD); never null
+    FlightList findFlightsByRoute(const std::string& origin, const std::string& destination, const std::string& departureDate);
+
+    // Add, update or remove a single flight, keeping every index in step, and save
+    bool addFlight(const Flight& flight);
+    bool updateFlight(std::string_view flightNumber, const Flight& updatedFlight);
+    bool removeFlight(std::string_view flightNumber);
+
+    // Save the resident flights to the file
+    void save();
+
+private:
+    // Interned origin and destination plus the departure day; compared as integers
+    struct RouteKey
+    {
+        Symbol origin;
+        Symbol destination;
+        std::int64_t departureDay;
+
+        bool operator==(const RouteKey& other) const
+        {
+            return origin == other.origin && destination == other.destination && departureDay == other.departureDay;
+        }
+    };
+
+    struct RouteKeyHash
+    {
+        size_t operator()(const RouteKey& key) const noexcept
+        {
+            std::uint64_t hash = (static_cast<std::uint64_t>(key.origin.getId()) << 32) ^ key.destination.getId();
+            return std::hash<std::uint64_t>{}(hash * 0x9E3779B97F4A7C15ULL ^ static_cast<std::uint64_t>(key.departureDay));
+        }
+    };
+
+    // One version of the schedule with its indexes; never changed once published
+    struct Schedule
+    {
+        std::vector<FlightHandle> flights;
+        std::unordered_map<Symbol, FlightHandle> flightsByNumber;
+        std::unordered_map<RouteKey, std::vector<FlightHandle>, RouteKeyHash> flightsByRoute;
+
+        void indexRoute(const FlightHandle& flight);
+        void unindexRoute(const FlightHandle& flight);
+    };
+
+    explicit FlightCatalog(const std::string& filename);
+
+    std::shared_ptr<const Schedule> current();
+    void reloadIfChanged();
+    void loadFlightsFromJson();
+    template <typename Change>
+    bool modify(Change change);
+    void saveSchedule(const Schedule& toSave);
+    static std::shared_ptr<const Schedule> rebuild(std::vector<Flight>&& newFlights);
+
+    std::string filename;
+    std::string lockFilename;   // kept so the per-call version check doesn't allocate
+    std::shared_mutex mutex;    // guards the members below; taken before the file lock
+    std::shared_ptr<const Schedule> schedule;
+    JsonUtils::FileVersion loadedVersion{};
+    bool loaded = false;
+};
+
+#endif
@@ -5,8 +5,12 @@
 #include <optional>
 #include <sstream>
 #include "Flight.hpp"
+#include "FlightCatalog.hpp"
+#include "SeatInventory.hpp"
+#include "SeatFinder.hpp"
 #include "../Utils/JsonUtils.hpp"
 #include "../Utils/Utils.hpp"
+#include "../Booking/SeatHoldManager.hpp"
 
 class FlightService
 {
@@ -19,22 +23,34 @@ public:
     void searchFlights(const std::string &origin, const std::string &destination, const std::string &departureDate) const;
 
     // Display seats in a flight
-    void displayAvailableSeats(const std::string& flightNumber) const;
+    void displayAvailableSeats(std::string_view flightNumber) const;
 
-    // Marking seat as booked after reservation
-    bool markSeatAsBooked(const std::string& flightNumber, const std::string& seatNumber);
+    // Hold a seat while the customer pays; prints why if it can't be held
+    std::optional<SeatHold> holdSeat(std::string_view flightNumber, const std::string& seatNumber);
 
-    // Change seats for a passenger
-    bool changeSeat(const std::string &flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber);
+    // Find and hold the best available seats for a request (empty, with a message, if none fit)
+    std::vector<SeatHold> autoAssignSeats(std::string_view flightNumber, const SeatRequest& request);
+
+    // Claim a seat for a booking; it is freed again unless the transaction commits
+    bool markSeatAsBooked(std::string_view flightNumber, const std::string& seatNumber, Transaction& transaction);
+
+    // Available seats derived from the flight's seat map
+    int getAvailableSeats(const Flight& flight) const;
+
+    // Cabin class of the flight's layout matching text (case-insensitive); empty text means
+    // any class and gives an empty name. nullopt, with the classes listed, if there is no such class.
+    std::optional<std::string> findCabinClass(std::string_view flightNumber, const std::string& text) const;
+
+    // Change seats for a passenger, on its own or as part of a larger transaction (committed by the caller)
+    bool changeSeat(std::string_view flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber);
+    bool changeSeat(std::string_view flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber, Transaction& transaction);
     
-    // Find a specific flight
-    std::optional<std::reference_wrapper<Flight>> findFlight(const std::string& flightNumber) const;
+    // Find a specific flight (the handle stays valid across catalog reloads)
+    FlightCatalog::FlightHandle findFlight(std::string_view flightNumber) const;
 
 protected:
-    std::vector<Flight> loadFlightsFromJson(const std::string &filename) const;
-    
-    // Get flights
-    std::vector<Flight> getFlights() const;
+    // Get flights from the shared catalog
+    FlightCatalog::FlightList getFlights() const;
 };
 
 #endif
\ No newline at end of file
@@ -8,7 +8,7 @@ class FlightServiceAdmin : public FlightService
 
 public:
     // Get flights
-    std::vector<Flight> getFlightsForReport() const;
+    FlightCatalog::FlightList getFlightsForReport() const;
 };
 
 
@@ -0,0 +1,103 @@
+#ifndef MAINTENANCEREPOSITORY_HPP
+#define MAINTENANCEREPOSITORY_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "../Utils/JsonUtils.hpp"
+
+// Process-wide maintenance data. maintenance_logs.json and maintenance_schedule.json
+// are parsed once, on first access, and indexed by aircraft ID. Aircraft objects read
+// their logs and schedule from here instead of parsing both files per instance.
+//
+// Changes are appended to maintenance.journal (one JSON line each) instead of
+// rewriting the JSON files. Compaction folds the journal back into the two files in
+// their usual layout. The journal's first line records a hash of each file it was
+// started against, so records that a compaction already folded into a file are
+// never applied twice, even if the process stopped halfway through compacting.
+//
+// Several processes share the journal. Its lock file guards it and both JSON files:
+// appends and compactions hold it exclusive and first read the records other processes
+// appended since, and compaction replaces the files and the journal atomically and
+// bumps the journal's generation, which sends the other processes back to the files.
+class MaintenanceRepository
+{
+public:
+    using MaintenanceLogs = std::vector<std::pair<std::string, std::string>>;   // (date, description)
+
+    // Get the shared repository for the files under data/
+    static MaintenanceRepository& instance();
+    ~MaintenanceRepository();
+
+    // Logs and scheduled dates of one aircraft (empty if it has none), as of the other
+    // processes' latest changes; valid until the next call
+    const MaintenanceLogs& getLogs(const std::string& aircraftId);
+    const std::vector<std::string>& getSchedule(const std::string& aircraftId);
+
+    // Change one aircraft's entries; each appends a single journal record
+    void addLog(const std::string& aircraftId, const std::string& aircraftType, const std::string& date, const std::string& description);
+    void addScheduledDate(const std::string& aircraftId, const std::string& aircraftType, const std::string& date);
+    void removeScheduledDate(const std::string& aircraftId, const std::string& aircraftType, const std::string& date);
+
+    // Rewrite both JSON files from the current state and start an empty journal
+    void compact();
+
+private:
+    MaintenanceRepository(const std::string& logsFile, const std::string& scheduleFile, const std::string& journalFile);
+
+    void loadIfNeeded();
+    void loadLogs();
+    void loadSchedule();
+
+    // Expect the lock file to be held (exclusive if repairTornRecord or writing)
+    void reload(bool repairTornRecord);
+    void catchUp(bool repairTornRecord);
+    void catchUpForWrite();
+    void writeCompacted();
+    void startJournal();
+
+    void record(const nlohmann::json& change);
+    void apply(const nlohmann::json& change);
+    void applyLog(const std::string& aircraftId, const std::string& aircraftType, const std::string& date, const std::string& description);
+    void applySchedule(const std::string& aircraftId, const std::string& aircraftType, const std::string& date);
+    void applyUnschedule(const std::string& aircraftId, const std::string& aircraftType, const std::string& date);
+
+    void openJournal();
+    static std::string readFile(const std::string& filename);
+    static std::uint64_t hashContents(const std::string& contents);
+
+    // Fold the journal into the JSON files after this many records
+    static constexpr size_t compactAfterRecords = 500;
+
+    std::string logsFile;
+    std::string scheduleFile;
+    std::string journalFile;
+    std::string lockFile;
+    bool loaded = false;
+
+    // Parsed documents and the hash and version of the file each was read from or written to
+    nlohmann::json logsJson;
+    nlohmann::json scheduleJson;
+    std::uint64_t logsHash = 0;
+    std::uint64_t scheduleHash = 0;
+    JsonUtils::FileVersion logsVersion{};
+    JsonUtils::FileVersion scheduleVersion{};
+
+    // Whether the journal's base matches the files, so its records of each kind apply
+    bool logsMatchBase = false;
+    bool scheduleMatchesBase = false;
+
+    std::FILE* journal = nullptr;      // opened for appending on the first write
+    size_t journalRecords = 0;
+    std::uint64_t readOffset = 0;      // journal bytes applied so far
+    std::uint64_t generation = 0;      // journal generation they were read from
+
+    std::unordered_map<std::string, MaintenanceLogs> logsByAircraft;
+    std::unordered_map<std::string, std::vector<std::string>> scheduleByAircraft;
+};
+
+#endif
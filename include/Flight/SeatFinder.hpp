@@ -0,0 +1,63 @@
+#ifndef SEATFINDER_HPP
+#define SEATFINDER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SeatMap.hpp"
+
+// Where in the row a passenger would like to sit
+enum class SeatPosition
+{
+    Any,
+    Window,
+    Aisle
+};
+
+// What a party asks for when seats are assigned automatically
+struct SeatRequest
+{
+    int partySize = 1;
+    SeatPosition position = SeatPosition::Any;
+    bool together = true;   // one block of adjacent seats in a row
+    int firstRow = 1;       // row range counted from the front from 1; lastRow 0 means the last row
+    int lastRow = 0;
+};
+
+// Best-available seat assignment on a SeatMap's per-row bitmasks.
+// The cabin is split by aisles into sections; the outer columns are windows and the
+// columns next to an aisle are aisle seats. For a party of k the start columns of k
+// free adjacent seats are found with k shifted ANDs of the row's free mask, so a row
+// costs a handful of word operations whatever its size.
+// Together, the blocks tried in order are: inside one section with the position
+// preference, inside one section, across an aisle with the preference, across an aisle;
+// the frontmost row wins, then the leftmost block. Apart, the seats are filled front to
+// back, preferred positions first.
+class SeatFinder
+{
+public:
+    // Layout of a cabin cols wide with an aisle after each column in aisleAfter
+    SeatFinder(int cols, const std::vector<int>& aisleAfter);
+
+    // The cabin's own aisles
+    explicit SeatFinder(const CabinLayout& layout);
+
+    // "window", "aisle" or anything else for no preference (case-insensitive)
+    static SeatPosition parsePosition(const std::string& text);
+
+    // Seat indexes for the request, empty if it can't be met
+    std::vector<int> findSeats(const SeatMap& seatMap, const SeatRequest& request) const;
+
+private:
+    std::uint64_t blockStarts(std::uint64_t freeSeats, int size, std::uint64_t links) const;
+    std::uint64_t blocksCovering(std::uint64_t columns, int size) const;
+    std::uint64_t positionMask(SeatPosition position) const;
+
+    int cols;
+    std::uint64_t allSeats;
+    std::uint64_t windowSeats;
+    std::uint64_t aisleSeats;
+    std::uint64_t sectionLinks;   // bit c: columns c and c + 1 are in the same section
+};
+
+#endif
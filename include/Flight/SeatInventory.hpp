@@ -0,0 +1,142 @@
+#ifndef SEATINVENTORY_HPP
+#define SEATINVENTORY_HPP
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <set>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include "SeatMap.hpp"
+#include "../Utils/JsonUtils.hpp"
+#include "../Booking/TransactionStamp.hpp"
+
+// Process-wide store of every flight's SeatMap, kept in a compact binary file.
+// The first run converts the legacy string-valued seats.json.
+// The lock only guards adding and removing flights; booking seats on a
+// SeatMap handle is lock-free.
+// Other processes share the seats through seats.dat and an append-only seat log next to
+// it (seats.log), both under seats.dat's file lock. A transaction claims its seats in the
+// log before its intent record is written (see TransactionManager), which fails if the log
+// already has one of them taken; once the record is durable, a commit record makes the
+// claims final and frees the seats it released, and a claim whose transaction failed is
+// withdrawn by an abort record. Pending claims count as taken. seats.dat holds only final
+// seats and is rewritten at checkpoints (save()), which also cut the log back to the
+// claims still pending and the transactions already settled.
+// A held seat (see holdSeat) is booked in its SeatMap, so nobody in this process can
+// take it, but not sold, so it is saved as free until it is claimed; a crash never leaves
+// it taken. Holding and releasing a seat are lock-free. Reading the files (refresh() and
+// before every write) sells the seats they have taken and frees the other ones not held here.
+class SeatInventory
+{
+public:
+    // A seat by flight number and bit index
+    using SeatRef = std::pair<std::string, int>;
+
+    // Get the shared inventory for data/seats.dat
+    static SeatInventory& instance();
+
+    // Find a flight's seat map, nullptr if the flight has none
+    std::shared_ptr<SeatMap> findSeatMap(std::string_view flightNumber) const;
+
+    // Create an empty seat map, standard or laid out for the aircraft (false if the flight already has one)
+    bool createSeatMap(const std::string& flightNumber, int rows, int cols);
+    bool createSeatMap(const std::string& flightNumber, const CabinLayout& layout);
+
+    // Remove a flight's seat map (false if it had none)
+    bool removeSeatMap(const std::string& flightNumber);
+
+    // Add or replace a flight's seat map
+    void putSeatMap(const std::string& flightNumber, SeatMap&& seatMap);
+
+    // Hold a free seat: book it here without selling it (false if it doesn't exist or is taken)
+    bool holdSeat(std::string_view flightNumber, int seatIndex);
+    bool isHeldSeat(std::string_view flightNumber, int seatIndex) const;
+
+    // Free a held seat (false if it isn't held)
+    bool releaseHeldSeat(std::string_view flightNumber, int seatIndex);
+
+    // Claim held seats for transaction txn of an intent journal, in the seat log, all or
+    // none. False if any of them isn't held or is taken in the files; the seats taken there
+    // stop being held (they stay booked), the others are still held. The claim reaches
+    // the disk with the next syncLog().
+    bool claimSeats(const std::vector<SeatRef>& seats, const std::string& journal, std::uint64_t txn);
+
+    // The transaction is durable: make its claims final (claiming the booked seats again if
+    // its claim was withdrawn or never made) and free the released seats. Nothing happens
+    // if the stamp was settled already.
+    void commitSeats(const std::optional<TransactionStamp>& stamp, const std::vector<SeatRef>& booked,
+                     const std::vector<SeatRef>& released);
+
+    // Withdraw a journal's claims for transactions after txn; our own seats are held again
+    void abortClaims(const std::string& journal, std::uint64_t afterTxn);
+
+    // Withdraw the pending claims of every journal dead says can no longer commit them
+    void abortDeadClaims(const std::function<bool(const std::string&)>& dead);
+
+    // Force everything appended to the seat log so far to disk
+    void syncLog();
+
+    // Every flight's seat map, ordered by flight number
+    std::vector<std::pair<std::string, std::shared_ptr<SeatMap>>> getSeatMaps() const;
+
+    // Save every seat map to seats.dat (replaced atomically and synced to disk) and cut the
+    // seat log back to what the file doesn't hold
+    void save();
+
+    // Merge in seat maps and claims other processes saved since this one last read the files
+    void refresh();
+
+private:
+    SeatInventory(const std::string& filename, const std::string& logFile, const std::string& legacyJsonFile);
+
+    using SeatMaps = std::map<std::string, std::shared_ptr<SeatMap>, std::less<>>;
+    using Claims = std::map<std::string, std::map<std::uint64_t, std::vector<SeatRef>>, std::less<>>;
+
+    void load();
+    SeatMaps readFile() const;
+    // Callers hold fileMutex and the file lock (exclusive to write)
+    void catchUp(bool repairTornRecord);
+    void mergeFromFile();
+    void mergeFromFile(const SeatMaps& fileMaps, JsonUtils::FileVersion version);
+    void readLog(SeatMaps* fileMaps, bool repairTornRecord);
+    void applyRecord(const nlohmann::json& record, SeatMaps* fileMaps);
+    void appendLog(const nlohmann::json& record);
+    void openLog();
+    void writeFile();
+    void importFromJson();
+
+    // A seat sold or freed by a log record, in fileMaps or (null) in this process's own
+    // seat maps, where a held seat sold elsewhere stops being held and is never freed
+    void takeSeat(SeatMaps* fileMaps, const SeatRef& seat);
+    void freeSeat(SeatMaps* fileMaps, const SeatRef& seat);
+    std::shared_ptr<SeatMap> logged(SeatMaps* fileMaps, const SeatRef& seat) const;
+
+    std::string filename;
+    std::string logFile;
+    std::string legacyJsonFile;
+    SeatMaps seatMaps;   // std::less<> allows string_view lookups
+    mutable std::shared_mutex seatMapsMutex;
+    mutable std::mutex fileMutex;
+
+    // The file as this process last read or wrote it, to tell added flights from removed ones
+    JsonUtils::FileVersion syncedVersion{};
+    std::set<std::string, std::less<>> syncedFlights;
+
+    // The seat log as far as this process has read it (under fileMutex)
+    Claims pendingClaims;                  // journal -> txn -> seats claimed but not yet settled
+    AppliedTransactions settled;           // newest transaction settled from each journal
+    std::uint64_t logOffset = 0;
+    std::shared_ptr<std::FILE> log;        // unbuffered, so every record is one write
+};
+
+#endif
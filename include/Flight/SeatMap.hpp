@@ -0,0 +1,86 @@
+#ifndef SEATMAP_HPP
+#define SEATMAP_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <iostream>
+#include "CabinLayout.hpp"
+
+// Seat state of one flight's cabin, stored as a packed bitset.
+// Seat (row, col) lives at bit row * cols + col; a set bit means booked.
+// Seat labels come from the cabin's layout (a standard one unless given).
+// Book, release and move are lock-free compare-and-swap operations on the
+// 64-seat word holding the seat, so threads can book the same flight at once.
+// A second bitset marks the booked seats that are sold for good (see SeatInventory);
+// a booked seat that isn't sold is only held by this process.
+class SeatMap
+{
+private:
+    int rows = 0;
+    int cols = 0;
+    const CabinLayout* layout = nullptr;
+    std::vector<std::atomic<std::uint64_t>> words;
+    std::vector<std::atomic<std::uint64_t>> soldWords;
+
+public:
+    SeatMap() = default;
+    SeatMap(int rows, int cols);
+    explicit SeatMap(const CabinLayout& layout);
+    SeatMap(SeatMap&&) = default;
+    SeatMap& operator=(SeatMap&&) = default;
+
+    // Getters
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getSeatCount() const { return rows * cols; }
+    const CabinLayout& getLayout() const { return *layout; }
+
+    // Switch to another layout of the same size
+    void setLayout(const CabinLayout& newLayout);
+
+    // Convert between seat labels ("14C") and bit indexes (-1 if the label is invalid)
+    int seatIndex(std::string_view label) const;
+    std::string seatLabel(int index) const;
+
+    // Seat state (all O(1))
+    bool isBooked(int index) const;
+    bool book(int index);       // false if the seat was already booked
+    bool release(int index);    // false if the seat was already free
+    bool move(int fromIndex, int toIndex); // book toIndex then free fromIndex, false if toIndex is taken
+
+    // Sold seats, also lock-free. A held seat is booked but not sold; selling a held seat
+    // ends the hold, and releasing a hold fails once the seat is sold.
+    bool isSold(int index) const;
+    bool isHeld(int index) const;
+    void sell(int index);                        // sold and booked
+    void unsell(int index, bool keepHeld);       // no longer sold; free unless kept held
+    bool releaseHold(int index);                 // false if the seat isn't held
+    std::vector<std::uint64_t> getSoldWords() const;
+
+    // Take the sold seats from elsewhere: booked seats are then the sold ones and the ones held here
+    void setSoldWords(const std::vector<std::uint64_t>& sold);
+
+    // Booked seats of one row (0-based) as a mask: bit col set means booked
+    std::uint64_t getRowMask(int row) const;
+
+    // Seat counts
+    int getBookedCount() const;
+    int getAvailableCount() const { return getSeatCount() - getBookedCount(); }
+
+    // Copy of the raw bitset words
+    std::vector<std::uint64_t> getWords() const;
+
+    // Three-way merge with another copy of this cabin that started from the same base:
+    // seats whose state here differs from base keep it, every other seat takes other's state
+    void merge(const std::vector<std::uint64_t>& base, const std::vector<std::uint64_t>& other);
+
+    // Compact binary serialization: rows, cols and the raw bitset (read back as sold)
+    void writeTo(std::ostream& out) const;
+    static void writeTo(std::ostream& out, int rows, int cols, const std::vector<std::uint64_t>& words);
+    static SeatMap readFrom(std::istream& in);
+};
+
+#endif
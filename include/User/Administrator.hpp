@@ -10,6 +10,7 @@
 #include "../Flight/Aircraft.hpp"
 #include "../Flight/Flight.hpp"
 #include "../Flight/FlightService.hpp"
+#include "../Flight/FlightCatalog.hpp"
 #include "../Flight/CrewService.hpp"
 #include "../Booking/ReservationServiceAdmin.hpp"
 #include "../Reporting/ReportGenerator.hpp"
@@ -37,8 +38,7 @@ private:
     static inline ActivityLogger activityLogger{};
  
     // Helper methods for JSON file handling
-    void loadFlightsFromJson(const std::string &filename);
-    void saveFlightsToJson(const std::string &filename);
+    void loadFlights();
     void loadAircraftFromJson(const std::string &filename);
     void saveAircraftToJson(const std::string &filename);
 
@@ -50,6 +50,12 @@ private:
     void loadUsersFromJson(const std::string &filename);
     void saveUsersToJson(const std::string &filename);
 
+    // Reload users / aircraft if another process saved them since we last read them
+    void refreshUsers();
+    void refreshAircraft();
+    JsonUtils::FileVersion usersVersion{};
+    JsonUtils::FileVersion aircraftVersion{};
+
     void createSeatsForNewFlight(const std::string& flightNumber, const std::string& aircraftType);
     void removeFlightSeats(const std::string &flightNumber);
     void viewCrewForFlight(const std::string &flightNumber);
@@ -90,7 +96,7 @@ public:
     
     // Flight management
     void addFlight(const Flight& flight);
-    void updateFlight(const std::string &flightNumber, const Flight& updatedFlight);
+    void updateFlight(std::string_view flightNumber, const Flight& updatedFlight);
     void updateFlightStatus(Flight& flight, const std::string& newStatus);
     void deleteFlight(const std::string &flightNumber);
     const std::vector<Flight>& getFlights() const{ return flights; }
@@ -18,7 +18,6 @@
 class BookingAgent: public User
 {
 private:
-    std::vector<Reservation> reservations;
     std::vector<BoardingPass> scannedPasses;
 
     //Static flight service member to handle viewing flights
@@ -35,13 +34,11 @@ private:
 
     bool isValidBoardingPass(const BoardingPass& boardingPass) const;
 
-    // Helper methods for JSON file handling
-    void loadReservationsFromJson(const std::string &filename);
-    void saveReservationsToJson(const std::string &filename);
-
     // Helper methods for menu functionality
     void searchFlightsMenu();
     void bookFlightMenu();
+    void bookGroupMenu();
+    void joinWaitlistMenu(const std::string &passengerId, const std::string &passengerName, const std::string &flightNumber);
     void modifyReservationMenu();
     void cancelReservationMenu();
 
@@ -52,23 +49,35 @@ public:
     void searchFlights(const std::string &origin, const std::string &destination, const std::string &departureDate) const;
     
     // Reservation management
-    bool bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt);
+    bool bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt,
+                    const std::optional<SeatHold>& seatHold = std::nullopt);
+    bool bookGroup(std::vector<Reservation> &reservations, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt,
+                   const std::vector<SeatHold>& seatHolds = {});
+    bool joinWaitlist(WaitlistEntry &entry);
     void updateReservation(const std::string &reservationId, const Reservation &updatedReservation);
     void cancelReservation(const std::string &reservationId);
-    const std::vector<Reservation>& getReservations() const;
+    std::vector<Reservation> getReservations() const;
 
-    bool changeSeat(const std::string &flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber);
+    bool changeSeat(std::string_view flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber);
     // Find a reservation by ID
-    std::optional<std::reference_wrapper<Reservation>> findReservation(const std::string &reservationId);
+    std::optional<Reservation> findReservation(const std::string &reservationId);
 
-    void displayAvailableSeats(const std::string& flightNumber) const
+    void displayAvailableSeats(std::string_view flightNumber) const
     { flightService.displayAvailableSeats(flightNumber); }
 
+    // Hold a seat while payment details are entered
+    std::optional<SeatHold> holdSeat(std::string_view flightNumber, const std::string& seatNumber)
+    { return flightService.holdSeat(flightNumber, seatNumber); }
+
+    // Pick and hold the best available seats for a request
+    std::vector<SeatHold> autoAssignSeats(std::string_view flightNumber, const SeatRequest& request)
+    { return flightService.autoAssignSeats(flightNumber, request); }
+
     void scanBoardingPass(const BoardingPass& boardingPass);
     
     // Viewing flights
     void viewFlights() const;
-    std::optional<std::reference_wrapper<Flight>> findFlight(const std::string &flightNumber);
+    FlightCatalog::FlightHandle findFlight(const std::string &flightNumber);
 
     // Main Menu
     void bookingAgentMenu();
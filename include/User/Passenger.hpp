@@ -27,6 +27,7 @@ private:
 
     // Helper methods for menu functionality
     void searchFlightsMenu();
+    void waitlistOffersMenu();
 
 public:
     Passenger(const std::string& id, const std::string& username, const std::string& password);
@@ -35,16 +36,28 @@ public:
     void viewReservations() const;
 
     // Add reservation to travel history
-    bool bookFlight(Reservation& reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt);
+    bool bookFlight(Reservation& reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails = std::nullopt,
+                    const std::optional<SeatHold>& seatHold = std::nullopt);
 
     // Display the seat map of a flight
-    void displayAvailableSeats(const std::string& flightNumber) const
+    void displayAvailableSeats(std::string_view flightNumber) const
     {flightService.displayAvailableSeats(flightNumber);}
 
+    // Hold a seat while payment details are entered
+    std::optional<SeatHold> holdSeat(std::string_view flightNumber, const std::string& seatNumber)
+    {return flightService.holdSeat(flightNumber, seatNumber);}
+
+    // Pick and hold the best available seats for a request
+    std::vector<SeatHold> autoAssignSeats(std::string_view flightNumber, const SeatRequest& request)
+    {return flightService.autoAssignSeats(flightNumber, request);}
+
+    // Wait for a seat on a full flight; the loyalty tier comes from the passenger's points
+    bool joinWaitlist(std::string_view flightNumber, const std::string& passengerName, const std::string& cabinClass = "");
+
     // Find Reservation
-    std::optional<std::reference_wrapper<Reservation>> findReservation(const std::string &reservationId);
+    std::optional<Reservation> findReservation(const std::string &reservationId);
     // Find Flight
-    std::optional<std::reference_wrapper<Flight>> findFlight(const std::string &flightNumber);
+    FlightCatalog::FlightHandle findFlight(const std::string &flightNumber);
 
 
     // Redeem loyalty points for a discount
@@ -2,10 +2,13 @@
 #define USER_HPP
 
 #include "../Utils/JsonUtils.hpp"
+#include "../Utils/JsonStreamReader.hpp"
+#include "../Utils/Reflection.hpp"
 #include <string>
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <utility>
+#include <string_view>
 #include <iostream>
 #include "../Utils/Utils.hpp"
 
@@ -21,13 +24,14 @@ private:
     std::string password;
 
 public:
-    User(const std::string& id, const std::string& username, const std::string& role, const std::string& password);
+    User() = default;
+    User(std::string id, std::string username, std::string role, std::string password);
     ~User()= default;
 
     // Getters
-    std::string getUsername() const;
-    std::string getRole() const;
-    std::string getId() const;
+    const std::string& getUsername() const;
+    const std::string& getRole() const;
+    const std::string& getId() const;
 
     // Setters
     void setUsername(const std::string& userName) {username = userName;}
@@ -43,6 +47,19 @@ public:
     // Json Serialization
     static User fromJson(const nlohmann::json& j);
     nlohmann::json toJson() const;
+
+    // Persisted fields; drives toJson, the streaming loader and the binary format
+    static constexpr auto fields()
+    {
+        using Reflection::field;
+        return std::make_tuple(
+            field("id", &User::id),
+            field("username", &User::username),
+            field("password", &User::password),
+            field("role", &User::role));
+    }
+
+    using Builder = Reflection::Builder<User>;
 };
 
 
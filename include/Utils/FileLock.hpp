@@ -0,0 +1,45 @@
+#ifndef FILELOCK_HPP
+#define FILELOCK_HPP
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+// Advisory lock on a file, shared between processes. Held for the object's lifetime.
+// The lock file is created if it doesn't exist; use a dedicated ".lock" path so the
+// data file itself can still be replaced by rename.
+// Locks are reentrant per thread: taking a lock this thread already holds (or a shared
+// lock under an exclusive one) succeeds at once, so locked helpers can call each other.
+class FileLock
+{
+public:
+    enum class Mode
+    {
+        Shared,     // many readers
+        Exclusive   // one writer
+    };
+
+    // Blocks until the lock is granted; throws std::runtime_error if the file can't be opened
+    explicit FileLock(const std::string &path, Mode mode = Mode::Exclusive);
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    // Takes the lock only if nobody else holds it; nullptr if another process does
+    static std::unique_ptr<FileLock> tryAcquire(const std::string &path, Mode mode = Mode::Exclusive);
+
+private:
+    FileLock(const std::string &path, Mode mode, bool wait);
+
+    std::string path;
+    bool acquired = false;
+    bool nested = false;   // this thread already held the lock; nothing to release
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+#endif
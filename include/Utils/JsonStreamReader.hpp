@@ -0,0 +1,196 @@
+#ifndef JSONSTREAMREADER_HPP
+#define JSONSTREAMREADER_HPP
+
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Streaming construction of entities from JSON, without building a document first.
+//
+// An entity opts in with a nested Builder that receives the fields of one object:
+//     void setField(std::string_view key, std::string&& value);
+//     void setField(std::string_view key, double value);
+//     void setField(std::string_view key, nlohmann::json&& value);   // bool, null, objects, arrays
+//     Entity build();                                                // throws if a field is missing
+// Unknown keys are ignored by the builder. Reflection::Builder generates one from an
+// entity's field list.
+namespace JsonStream
+{
+    // Feed the members of an already parsed object to a builder
+    template <typename Builder>
+    void feed(Builder& builder, const nlohmann::json& object)
+    {
+        if (!object.is_object())
+        {
+            throw std::runtime_error("Expected a JSON object");
+        }
+        for (auto it = object.begin(); it != object.end(); ++it)
+        {
+            const auto& value = it.value();
+            if (value.is_string())
+            {
+                builder.setField(it.key(), value.get<std::string>());
+            }
+            else if (value.is_number())
+            {
+                builder.setField(it.key(), value.get<double>());
+            }
+            else
+            {
+                builder.setField(it.key(), nlohmann::json(value));
+            }
+        }
+    }
+
+    // SAX handler that turns an array of objects into entities as the parser reaches them.
+    // Only the object being read is held in a builder; nested values under one of its
+    // fields are collected into a small json value. Arrays around the objects are
+    // flattened, so [[{...}]] loads the same as [{...}].
+    template <typename Entity>
+    class EntityReader
+    {
+    public:
+        using json = nlohmann::json;
+
+        explicit EntityReader(std::vector<Entity>& entities) : entities(entities) {}
+
+        bool null() { return scalar(json(nullptr)); }
+        bool boolean(bool flag) { return scalar(json(flag)); }
+        bool number_integer(json::number_integer_t number) { return scalar(static_cast<double>(number)); }
+        bool number_unsigned(json::number_unsigned_t number) { return scalar(static_cast<double>(number)); }
+        bool number_float(json::number_float_t number, const json::string_t&) { return scalar(static_cast<double>(number)); }
+        bool string(json::string_t& text) { return scalar(std::move(text)); }
+        bool binary(json::binary_t&) { throw std::runtime_error("Unexpected binary value"); }
+
+        bool start_object(std::size_t)
+        {
+            if (builder)
+            {
+                return openNested(json::object());
+            }
+            if (arrays == 0)
+            {
+                throw std::runtime_error("Expected an array of objects");
+            }
+            builder.emplace();
+            return true;
+        }
+
+        bool key(json::string_t& name)
+        {
+            if (nested.empty())
+            {
+                fieldName = std::move(name);
+            }
+            else
+            {
+                nestedKey = std::move(name);
+            }
+            return true;
+        }
+
+        bool end_object()
+        {
+            if (!nested.empty())
+            {
+                return closeNested();
+            }
+            entities.push_back(builder->build());
+            builder.reset();
+            return true;
+        }
+
+        bool start_array(std::size_t)
+        {
+            if (builder)
+            {
+                return openNested(json::array());
+            }
+            arrays++;
+            return true;
+        }
+
+        bool end_array()
+        {
+            if (!nested.empty())
+            {
+                return closeNested();
+            }
+            arrays--;
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& error)
+        {
+            throw std::runtime_error(error.what());
+        }
+
+    private:
+        template <typename Value>
+        bool scalar(Value&& value)
+        {
+            if (!nested.empty())
+            {
+                addNested(json(std::forward<Value>(value)));
+                return true;
+            }
+            if (!builder)
+            {
+                throw std::runtime_error("Expected an array of objects");
+            }
+            builder->setField(fieldName, std::forward<Value>(value));
+            return true;
+        }
+
+        bool openNested(json&& container)
+        {
+            if (nested.empty())
+            {
+                nestedRoot = std::move(container);
+                nested.push_back(&nestedRoot);
+            }
+            else
+            {
+                nested.push_back(&addNested(std::move(container)));
+            }
+            return true;
+        }
+
+        bool closeNested()
+        {
+            nested.pop_back();
+            if (nested.empty())
+            {
+                builder->setField(fieldName, std::move(nestedRoot));
+            }
+            return true;
+        }
+
+        json& addNested(json&& value)
+        {
+            json& parent = *nested.back();
+            if (parent.is_array())
+            {
+                parent.push_back(std::move(value));
+                return parent.back();
+            }
+            return parent[nestedKey] = std::move(value);
+        }
+
+        std::vector<Entity>& entities;
+        std::optional<typename Entity::Builder> builder;
+        std::string fieldName;
+        int arrays = 0;
+
+        // Value under the current field while it is an object or array
+        json nestedRoot;
+        std::vector<json*> nested;
+        std::string nestedKey;
+    };
+}
+
+#endif
@@ -7,18 +7,107 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "JsonStreamReader.hpp"
+#include "FileLock.hpp"
 
+// Several processes share the data directory. Each data file has a lock file next to
+// it ("users.json.lock"): reads hold it shared, writes hold it exclusive. Writes go to a
+// temporary file that is synced and renamed into place, then bump a generation counter
+// kept in the lock file, so other processes can tell from getFileVersion() alone
+// whether they need to parse the file again.
 class JsonUtils
 {
 public:
+    // Identity and version of a data file; any committed write changes it
+    struct FileVersion
+    {
+        std::uint64_t device = 0;
+        std::uint64_t inode = 0;
+        std::uint64_t size = 0;
+        std::int64_t modified = 0;       // nanoseconds since the epoch
+        std::uint64_t generation = 0;    // writes committed through JsonUtils
+
+        bool operator==(const FileVersion &other) const
+        {
+            return device == other.device && inode == other.inode && size == other.size &&
+                   modified == other.modified && generation == other.generation;
+        }
+        bool operator!=(const FileVersion &other) const { return !(*this == other); }
+    };
+
     // Reads JSON data from a file
     static nlohmann::json readJsonFromFile(const std::string &filename);
 
+    // Reads an array of objects straight into entities with a streaming parser (no DOM)
+    template <typename Entity>
+    static std::vector<Entity> readEntitiesFromFile(const std::string &filename);
+
     // Saves JSON data to a file (overwrites the entire file)
     static void saveJsonToFile(const nlohmann::json &data, const std::string &filename);
 
+    // Reads, changes and saves a file under one exclusive lock so concurrent writers
+    // don't overwrite each other. A missing file starts out as null. Returns the saved data.
+    static nlohmann::json updateJsonFile(const std::string &filename, const std::function<void(nlohmann::json &)> &update);
+
+    // Replaces a file's contents: temporary file, fsync, rename, new generation
+    static void writeFileAtomically(const std::string &filename, const std::string &contents);
+
+    // Renames a file over another, even one other processes have open through openShared()
+    // (on Windows a plain rename fails while the target is open anywhere)
+    static void replaceFile(const std::string &from, const std::string &to);
+
+    // fopen whose file can be replaced or deleted while it stays open; use it for
+    // handles kept open across another process's replaceFile()
+    static std::FILE* openShared(const std::string &filename, const char *mode);
+
+    // Current version of a file (all zero if it doesn't exist); pass its lock file's name
+    // to check without allocating
+    static FileVersion getFileVersion(const std::string &filename);
+    static FileVersion getFileVersion(const std::string &filename, const std::string &lockFile);
+
+    // Lock file guarding a data file
+    static std::string lockFileFor(const std::string &filename) { return filename + ".lock"; }
+
+    // Announce a change made in place (e.g. an append or truncation); the caller holds the exclusive lock
+    static void bumpGeneration(const std::string &filename);
+
+    // Flushes a file opened for appending and forces it to disk (fsync); throws if either fails
+    static void syncFile(std::FILE *file);
+
+    // Second descriptor for a file, so it can be synced with syncAndClose() without holding
+    // whatever guards the FILE (which may be closed meanwhile); throws on failure
+    static int duplicateDescriptor(std::FILE *file);
+    static void syncAndClose(int descriptor);   // closes it even if the sync fails, then throws
+
     // Deletes an entry from a JSON file by key and ID
     static bool deleteFromJsonFile(const std::string &filename, const std::string &key, const std::string &id);
 };
 
+template <typename Entity>
+std::vector<Entity> JsonUtils::readEntitiesFromFile(const std::string &filename)
+{
+    FileLock lock(lockFileFor(filename), FileLock::Mode::Shared);
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    std::vector<Entity> entities;
+    JsonStream::EntityReader<Entity> reader(entities);
+    try
+    {
+        nlohmann::json::sax_parse(file, &reader);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Failed to parse JSON from file: " + std::string(e.what()));
+    }
+    return entities;
+}
+
 #endif 
\ No newline at end of file
@@ -8,14 +8,91 @@
 #include <chrono>
 #include <iomanip>
 #include <ctime>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "MpscQueue.hpp"
 
 class ActivityLogger
 {
 public:
+    // What logActivity does when the queue is full
+    enum class OverflowPolicy
+    {
+        Drop,   // discard the entry and count it
+        Block   // wait for the writer to catch up
+    };
+
+    struct Options
+    {
+        std::chrono::milliseconds flushLatency{200};
+        size_t maxQueuedEntries = 10000;
+        OverflowPolicy overflowPolicy = OverflowPolicy::Drop;
+    };
+
     ActivityLogger()=default;
 
+    // Queue an entry; the background writer appends it to the log
     void logActivity(const std::string& userId, const std::string& role, const std::string& action, const std::string& details = "");
+
+    // Change the batching and overflow settings of the shared writer
+    static void configure(const Options& options);
+
+    // Block until every queued entry has been written
+    static void flush();
+
+    // Read the whole log (older entries from the JSON array first, then the JSON Lines log)
+    static nlohmann::json readLog();
+};
+
+// Process-wide writer behind ActivityLogger. Producers push entries on a lock-free
+// queue; one thread drains it and appends them to user_activity.jsonl in batches.
+class ActivityLogWriter
+{
+public:
+    struct Entry
+    {
+        std::string userId;
+        std::string role;
+        std::string action;
+        std::string details;
+        std::chrono::system_clock::time_point time;
+    };
+
+    static ActivityLogWriter& instance();
+    ~ActivityLogWriter();
+
+    void submit(Entry&& entry);
+    void configure(const ActivityLogger::Options& options);
+    void flush();
+
+    static constexpr const char* legacyLogFile = "data/reports/user_activity.json";
+    static constexpr const char* logFile = "data/reports/user_activity.jsonl";
+
+private:
+    ActivityLogWriter();
+
+    void backgroundLoop();
+    size_t writeBatch(std::ofstream& out);
+    static std::string formatTimestamp(std::chrono::system_clock::time_point time);
+
+    MpscQueue<Entry> queue;
+    std::atomic<size_t> queuedEntries{0};
+    std::atomic<unsigned long long> submittedEntries{0};
+    std::atomic<unsigned long long> droppedEntries{0};
+    unsigned long long writtenEntries = 0;
+
+    std::atomic<long long> flushLatencyMs{200};
+    std::atomic<size_t> maxQueuedEntries{10000};
+    std::atomic<ActivityLogger::OverflowPolicy> overflowPolicy{ActivityLogger::OverflowPolicy::Drop};
+
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable written;
+    std::thread worker;
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+// Read-only memory mapping of a whole file. Nothing is read up front; the OS pages
+// the contents in as they are touched. Held for the object's lifetime.
+class MappedFile
+{
+public:
+    // Throws std::runtime_error if the file can't be opened or mapped
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view data() const { return {static_cast<const char*>(address), size}; }
+
+private:
+    const void* address = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+#endif
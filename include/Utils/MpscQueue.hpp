@@ -0,0 +1,72 @@
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free multi-producer / single-consumer queue.
+// Producers link a new node in with one atomic exchange; only the consumer
+// thread may call pop(). The caller is responsible for bounding its size.
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value))
+        {
+        }
+        if (tail != &stub)
+        {
+            delete tail;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Safe to call from any thread
+    void push(T value)
+    {
+        Node* node = new Node;
+        node->value = std::move(value);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer thread only; false if nothing is ready yet
+    bool pop(T& value)
+    {
+        Node* current = tail;
+        Node* next = current->next.load(std::memory_order_acquire);
+        if (!next)
+        {
+            return false;
+        }
+
+        // The popped node becomes the new placeholder tail
+        value = std::move(next->value);
+        tail = next;
+        if (current != &stub)
+        {
+            delete current;
+        }
+        return true;
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    Node stub;
+    std::atomic<Node*> head;
+    Node* tail;
+};
+
+#endif
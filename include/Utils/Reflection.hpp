@@ -0,0 +1,518 @@
+#ifndef REFLECTION_HPP
+#define REFLECTION_HPP
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Symbol.hpp"
+#include "Timestamp.hpp"
+
+// Compile-time field lists for the entities.
+//
+// An entity declares its persisted fields once:
+//     static constexpr auto fields()
+//     {
+//         return std::make_tuple(Reflection::field("price", &Reservation::price), ...);
+//     }
+// and gets from it a JSON writer (toJson), a builder for the streaming loader whose
+// key dispatch is a perfect hash built at compile time (Builder), and a compact
+// binary encoding in declaration order (writeBinary / readBinary).
+//
+// How a member type is converted is decided by Codec<T>, or by the codec passed to
+// field<Codec>(). A codec provides toJson, writeBinary and readBinary, plus
+// read(T&, std::string&&), read(T&, double) or read(T&, nlohmann::json&&) for the
+// parsed value kinds it accepts; values of any other kind leave the field unset.
+// Codecs whose binary form is always 8 bytes set fixedSlot, so fixed-layout records
+// (see Snapshot.hpp) can hold the value inline.
+namespace Reflection
+{
+    template <typename Class, typename T, typename FieldCodec>
+    struct Field
+    {
+        using Type = T;
+        using Codec = FieldCodec;
+
+        std::string_view name;
+        T Class::*member;
+        bool required;   // optional fields may be missing and are left out of toJson when empty
+    };
+
+    template <typename T, typename Enable = void>
+    struct Codec;
+
+    template <typename FieldCodec = void, typename Class, typename T>
+    constexpr auto field(std::string_view name, T Class::*member)
+    {
+        using Resolved = std::conditional_t<std::is_void_v<FieldCodec>, Codec<T>, FieldCodec>;
+        return Field<Class, T, Resolved>{name, member, true};
+    }
+
+    template <typename FieldCodec = void, typename Class, typename T>
+    constexpr auto optionalField(std::string_view name, T Class::*member)
+    {
+        using Resolved = std::conditional_t<std::is_void_v<FieldCodec>, Codec<T>, FieldCodec>;
+        return Field<Class, T, Resolved>{name, member, false};
+    }
+
+    // Little-endian, length-prefixed encoding used by the binary codecs
+    class BinaryWriter
+    {
+    public:
+        explicit BinaryWriter(std::string &out) : out(out) {}
+
+        void writeU8(std::uint8_t value) { out.push_back(static_cast<char>(value)); }
+        void writeU32(std::uint32_t value) { writeLittleEndian(value, 4); }
+        void writeI64(std::int64_t value) { writeLittleEndian(static_cast<std::uint64_t>(value), 8); }
+
+        void writeDouble(double value)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof bits);
+            writeLittleEndian(bits, 8);
+        }
+
+        void writeString(std::string_view text)
+        {
+            writeU32(static_cast<std::uint32_t>(text.size()));
+            out.append(text.data(), text.size());
+        }
+
+    private:
+        void writeLittleEndian(std::uint64_t value, int bytes)
+        {
+            for (int i = 0; i < bytes; i++)
+            {
+                out.push_back(static_cast<char>(value >> (8 * i)));
+            }
+        }
+
+        std::string &out;
+    };
+
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(std::string_view in) : in(in) {}
+
+        std::uint8_t readU8() { return static_cast<std::uint8_t>(readLittleEndian(1)); }
+        std::uint32_t readU32() { return static_cast<std::uint32_t>(readLittleEndian(4)); }
+        std::int64_t readI64() { return static_cast<std::int64_t>(readLittleEndian(8)); }
+
+        double readDouble()
+        {
+            std::uint64_t bits = readLittleEndian(8);
+            double value;
+            std::memcpy(&value, &bits, sizeof value);
+            return value;
+        }
+
+        // The view points into the input buffer
+        std::string_view readString()
+        {
+            std::uint32_t size = readU32();
+            require(size);
+            std::string_view text = in.substr(0, size);
+            in.remove_prefix(size);
+            return text;
+        }
+
+        size_t remaining() const { return in.size(); }
+
+    private:
+        void require(size_t bytes) const
+        {
+            if (in.size() < bytes)
+            {
+                throw std::runtime_error("Truncated binary record");
+            }
+        }
+
+        std::uint64_t readLittleEndian(int bytes)
+        {
+            require(static_cast<size_t>(bytes));
+            std::uint64_t value = 0;
+            for (int i = 0; i < bytes; i++)
+            {
+                value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[static_cast<size_t>(i)])) << (8 * i);
+            }
+            in.remove_prefix(static_cast<size_t>(bytes));
+            return value;
+        }
+
+        std::string_view in;
+    };
+
+    template <>
+    struct Codec<std::string>
+    {
+        static nlohmann::json toJson(const std::string &value) { return value; }
+        static void read(std::string &target, std::string &&text) { target = std::move(text); }
+        static void writeBinary(BinaryWriter &out, const std::string &value) { out.writeString(value); }
+        static void readBinary(BinaryReader &in, std::string &target) { target = in.readString(); }
+    };
+
+    template <>
+    struct Codec<Symbol>
+    {
+        static nlohmann::json toJson(Symbol value) { return value.view(); }
+        static void read(Symbol &target, std::string &&text) { target = Symbol(text); }
+        static void writeBinary(BinaryWriter &out, Symbol value) { out.writeString(value.view()); }
+        static void readBinary(BinaryReader &in, Symbol &target) { target = Symbol(in.readString()); }
+    };
+
+    template <>
+    struct Codec<int>
+    {
+        static constexpr bool fixedSlot = true;
+        static nlohmann::json toJson(int value) { return value; }
+        static void read(int &target, double number) { target = static_cast<int>(number); }
+        static void writeBinary(BinaryWriter &out, int value) { out.writeI64(value); }
+        static void readBinary(BinaryReader &in, int &target) { target = static_cast<int>(in.readI64()); }
+    };
+
+    template <>
+    struct Codec<double>
+    {
+        static constexpr bool fixedSlot = true;
+        static nlohmann::json toJson(double value) { return value; }
+        static void read(double &target, double number) { target = number; }
+        static void writeBinary(BinaryWriter &out, double value) { out.writeDouble(value); }
+        static void readBinary(BinaryReader &in, double &target) { target = in.readDouble(); }
+    };
+
+    // Null in JSON when there is no value
+    template <>
+    struct Codec<std::optional<std::string>>
+    {
+        static nlohmann::json toJson(const std::optional<std::string> &value) { return value ? nlohmann::json(*value) : nlohmann::json(); }
+        static void read(std::optional<std::string> &target, std::string &&text) { target = std::move(text); }
+
+        static void writeBinary(BinaryWriter &out, const std::optional<std::string> &value)
+        {
+            out.writeU8(value.has_value());
+            out.writeString(value.value_or(std::string()));
+        }
+
+        static void readBinary(BinaryReader &in, std::optional<std::string> &target)
+        {
+            bool present = in.readU8() != 0;
+            std::string_view text = in.readString();
+            target = present ? std::optional<std::string>(std::string(text)) : std::nullopt;
+        }
+    };
+
+    // Element codecs must accept nlohmann::json&& to be usable here
+    template <typename T>
+    struct Codec<std::vector<T>>
+    {
+        static nlohmann::json toJson(const std::vector<T> &values)
+        {
+            nlohmann::json array = nlohmann::json::array();
+            for (const auto &value : values)
+            {
+                array.push_back(Codec<T>::toJson(value));
+            }
+            return array;
+        }
+
+        static void read(std::vector<T> &target, nlohmann::json &&array)
+        {
+            target.clear();
+            for (auto &element : array)
+            {
+                T value{};
+                Codec<T>::read(value, std::move(element));
+                target.push_back(std::move(value));
+            }
+        }
+
+        static void writeBinary(BinaryWriter &out, const std::vector<T> &values)
+        {
+            out.writeU32(static_cast<std::uint32_t>(values.size()));
+            for (const auto &value : values)
+            {
+                Codec<T>::writeBinary(out, value);
+            }
+        }
+
+        static void readBinary(BinaryReader &in, std::vector<T> &target)
+        {
+            std::uint32_t count = in.readU32();
+            target.clear();
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                T value{};
+                Codec<T>::readBinary(in, value);
+                target.push_back(std::move(value));
+            }
+        }
+    };
+
+    // Epoch seconds, plus the original text when it couldn't be parsed
+    struct StoredTimestamp
+    {
+        std::int64_t time = Timestamp::invalid;
+        Symbol unparsed;   // only set while time is invalid
+    };
+
+    // "YYYY-MM-DD HH:MM:SSZ" text in JSON. Text that doesn't parse is written back
+    // unchanged, so loading and saving legacy data never loses it.
+    template <>
+    struct Codec<StoredTimestamp>
+    {
+        static nlohmann::json toJson(const StoredTimestamp &value)
+        {
+            return value.time != Timestamp::invalid ? Timestamp::format(value.time) : std::string(value.unparsed.view());
+        }
+
+        static void read(StoredTimestamp &target, std::string &&text)
+        {
+            target.time = Timestamp::parse(text);
+            target.unparsed = Symbol();
+            if (target.time == Timestamp::invalid)
+            {
+                std::cerr << "Failed to parse timestamp: " << text << std::endl;
+                target.unparsed = Symbol(text);
+            }
+        }
+
+        static void writeBinary(BinaryWriter &out, const StoredTimestamp &value)
+        {
+            out.writeI64(value.time);
+            out.writeString(value.unparsed.view());
+        }
+
+        static void readBinary(BinaryReader &in, StoredTimestamp &target)
+        {
+            target.time = in.readI64();
+            std::string_view text = in.readString();
+            target.unparsed = text.empty() ? Symbol() : Symbol(text);
+        }
+    };
+
+    template <typename T>
+    bool isEmpty(const T &) { return false; }
+
+    inline bool isEmpty(const std::string &value) { return value.empty(); }
+
+    template <typename T>
+    bool isEmpty(const std::optional<T> &value) { return !value; }
+
+    template <typename T>
+    bool isEmpty(const std::shared_ptr<T> &value) { return !value; }
+
+    template <typename T>
+    bool isEmpty(const std::vector<T> &values) { return values.empty(); }
+
+    template <typename Entity, typename Visitor>
+    void forEachField(Visitor &&visit)
+    {
+        std::apply([&visit](const auto &...fields) { (visit(fields), ...); }, Entity::fields());
+    }
+
+    template <typename Entity>
+    nlohmann::json toJson(const Entity &entity)
+    {
+        nlohmann::json object = nlohmann::json::object();
+        forEachField<Entity>([&](const auto &field)
+        {
+            using FieldType = std::decay_t<decltype(field)>;
+            const auto &value = entity.*field.member;
+            if (!field.required && isEmpty(value))
+            {
+                return;
+            }
+            object[std::string(field.name)] = FieldType::Codec::toJson(value);
+        });
+        return object;
+    }
+
+    template <typename Entity>
+    void writeBinary(BinaryWriter &out, const Entity &entity)
+    {
+        forEachField<Entity>([&](const auto &field)
+        {
+            using FieldType = std::decay_t<decltype(field)>;
+            FieldType::Codec::writeBinary(out, entity.*field.member);
+        });
+    }
+
+    template <typename Entity>
+    Entity readBinary(BinaryReader &in)
+    {
+        Entity entity;
+        forEachField<Entity>([&](const auto &field)
+        {
+            using FieldType = std::decay_t<decltype(field)>;
+            FieldType::Codec::readBinary(in, entity.*field.member);
+        });
+        return entity;
+    }
+
+    namespace detail
+    {
+        constexpr std::uint32_t hashKey(std::string_view key, std::uint32_t seed)
+        {
+            std::uint32_t hash = 2166136261u ^ seed;
+            for (char c : key)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        template <typename... Fields>
+        constexpr auto fieldNames(const std::tuple<Fields...> &fields)
+        {
+            return std::apply([](const auto &...field) { return std::array<std::string_view, sizeof...(Fields)>{field.name...}; },
+                              fields);
+        }
+
+        // Smallest power of two with at least twice as many slots as keys
+        constexpr size_t tableSize(size_t keys)
+        {
+            size_t size = 1;
+            while (size < keys * 2)
+            {
+                size *= 2;
+            }
+            return size;
+        }
+
+        template <size_t Slots>
+        struct KeyTable
+        {
+            std::uint32_t seed = 0;
+            std::array<int, Slots> slots{};
+        };
+
+        // Try seeds until every key lands in its own slot
+        template <size_t Slots, size_t Keys>
+        constexpr KeyTable<Slots> makeKeyTable(const std::array<std::string_view, Keys> &names)
+        {
+            for (std::uint32_t seed = 0;; seed++)
+            {
+                KeyTable<Slots> table{};
+                table.seed = seed;
+                for (size_t slot = 0; slot < Slots; slot++)
+                {
+                    table.slots[slot] = -1;
+                }
+
+                bool collision = false;
+                for (size_t i = 0; i < Keys && !collision; i++)
+                {
+                    size_t slot = hashKey(names[i], seed) & (Slots - 1);
+                    collision = table.slots[slot] >= 0;
+                    table.slots[slot] = static_cast<int>(i);
+                }
+                if (!collision)
+                {
+                    return table;
+                }
+            }
+        }
+
+        // True if FieldCodec has read(T&, Value) with exactly that signature, so no
+        // implicit conversion (such as json -> double) is ever picked
+        template <typename FieldCodec, typename = void>
+        struct HasFixedSlot : std::false_type {};
+
+        template <typename FieldCodec>
+        struct HasFixedSlot<FieldCodec, std::enable_if_t<FieldCodec::fixedSlot>> : std::true_type {};
+
+        template <typename FieldCodec, typename T, typename Value, typename = void>
+        struct CanRead : std::false_type {};
+
+        template <typename FieldCodec, typename T, typename Value>
+        struct CanRead<FieldCodec, T, Value, std::void_t<decltype(static_cast<void (*)(T &, Value)>(&FieldCodec::read))>>
+            : std::true_type {};
+    }
+
+    // Field name -> position in Entity::fields(), with one hash and one compare
+    template <typename Entity>
+    struct KeyIndex
+    {
+        static constexpr auto names = detail::fieldNames(Entity::fields());
+        static constexpr size_t slots = detail::tableSize(names.size());
+        static constexpr auto table = detail::makeKeyTable<slots>(names);
+
+        static int find(std::string_view key)
+        {
+            int index = table.slots[detail::hashKey(key, table.seed) & (slots - 1)];
+            return index >= 0 && names[static_cast<size_t>(index)] == key ? index : -1;
+        }
+    };
+
+    // Builder for JsonStream::EntityReader and JsonStream::feed (see JsonStreamReader.hpp)
+    template <typename Entity>
+    class Builder
+    {
+    public:
+        void setField(std::string_view key, std::string &&value) { assign(key, std::move(value)); }
+        void setField(std::string_view key, double value) { assign(key, value); }
+        void setField(std::string_view key, nlohmann::json &&value) { assign(key, std::move(value)); }
+
+        // Throws if a required field was missing or had the wrong type
+        Entity build()
+        {
+            size_t index = 0;
+            forEachField<Entity>([&](const auto &field)
+            {
+                if (field.required && !(seen & (std::uint64_t{1} << index)))
+                {
+                    throw std::runtime_error("Missing or invalid field: " + std::string(field.name));
+                }
+                index++;
+            });
+            seen = 0;
+            return std::move(entity);
+        }
+
+    private:
+        static_assert(std::tuple_size_v<decltype(Entity::fields())> <= 64, "Builder tracks at most 64 fields");
+
+        template <typename Value>
+        void assign(std::string_view key, Value &&value)
+        {
+            int target = KeyIndex<Entity>::find(key);
+            if (target < 0)
+            {
+                return; // Unknown keys are ignored
+            }
+
+            int index = 0;
+            forEachField<Entity>([&](const auto &field)
+            {
+                if (index++ != target)
+                {
+                    return;
+                }
+                using FieldType = std::decay_t<decltype(field)>;
+                using Parsed = std::conditional_t<std::is_same_v<std::decay_t<Value>, double>, double, std::decay_t<Value> &&>;
+                if constexpr (detail::CanRead<typename FieldType::Codec, typename FieldType::Type, Parsed>::value)
+                {
+                    FieldType::Codec::read(entity.*field.member, std::forward<Value>(value));
+                    seen |= std::uint64_t{1} << target;
+                }
+            });
+        }
+
+        Entity entity{};
+        std::uint64_t seen = 0;
+    };
+}
+
+#endif
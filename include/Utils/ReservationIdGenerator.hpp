@@ -0,0 +1,64 @@
+#ifndef RESERVATIONIDGENERATOR_HPP
+#define RESERVATIONIDGENERATOR_HPP
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include "FileLock.hpp"
+
+// Snowflake-style reservation IDs: 41 bits of milliseconds since 2024-01-01,
+// 10 bits of node and 12 bits of sequence. Every process leases its own node at
+// startup by locking that node's lock file until it exits, so processes never
+// collide and only nodes of dead processes are reused; threads share the
+// process's (timestamp, sequence) word and advance it with CAS.
+//
+// The state file also records a timestamp horizon that is reserved ahead of
+// use. After a restart, or if the clock goes backwards, IDs continue from the
+// horizon, so they never repeat and stay ordered by issue time.
+class ReservationIdGenerator
+{
+public:
+    // Get the shared generator backed by data/reservation_ids.json
+    static ReservationIdGenerator& instance();
+
+    // Next ID formatted as "R" + 13 base-36 digits (sorts in issue order)
+    std::string nextId();
+
+    // Next raw 63-bit ID
+    std::uint64_t nextValue();
+
+    static std::string format(std::uint64_t value);
+
+    std::uint64_t getNode() const { return node; }
+
+private:
+    explicit ReservationIdGenerator(const std::string &stateFile);
+
+    // Lock the first free node from the state file's round-robin position on
+    void leaseNode(std::uint64_t first);
+    std::string nodeLockFile(std::uint64_t candidate) const;
+
+    // Persist a horizon past timestamp before an ID using it is handed out
+    void reserveUntil(std::int64_t timestamp);
+
+    static std::int64_t currentMillis();
+
+    static constexpr std::int64_t epochMillis = 1704067200000LL;   // 2024-01-01T00:00:00Z
+    static constexpr int nodeBits = 10;
+    static constexpr int sequenceBits = 12;
+    static constexpr std::uint64_t nodeMask = (1ULL << nodeBits) - 1;
+    static constexpr std::uint64_t sequenceMask = (1ULL << sequenceBits) - 1;
+    static constexpr std::int64_t reserveAheadMillis = 10000;
+
+    std::string stateFile;
+    std::uint64_t node = 0;
+    std::unique_ptr<FileLock> nodeLease;   // held for the process's lifetime
+
+    std::atomic<std::uint64_t> lastIssued{0};        // (timestamp << sequenceBits) | sequence
+    std::atomic<std::int64_t> reservedUntil{0};
+    std::mutex reserveMutex;
+};
+
+#endif
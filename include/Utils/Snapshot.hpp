@@ -0,0 +1,330 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "JsonUtils.hpp"
+#include "MappedFile.hpp"
+#include "Reflection.hpp"
+
+// Binary snapshot of the data files, opened with mmap for fast cold starts.
+//
+// Layout (little-endian):
+//   header     "ARSSNAP\0", uint32 version, uint32 section count
+//   sections   one fixed 80-byte entry per section (see SectionEntry)
+//   uint32     CRC-32 of everything above
+//   per section, 8-byte aligned: fixed-size records, the section's string pool, then
+//              a uint32 CRC-32 for every page of records and pool
+//
+// A record has one 8-byte slot per field in the entity's Reflection field list.
+// Numbers sit in the slot; strings, timestamps (they keep any unparsed text) and
+// nested values are stored once in the pool and the slot holds their uint32 offset
+// and length. Opening a section checks only the CRC-32 of its page checksums; each
+// page is checked the first time a record reads from it, so looking up one record
+// touches only its own pages.
+//
+// JSON stays the source of truth. A section is named after the stem of the file it
+// was built from ("flights" for data/flights.json) and remembers that file's size and
+// modification time; loadEntities() only uses the section while the file is unchanged.
+namespace Snapshot
+{
+    constexpr const char* defaultFile = "data/snapshot.bin";
+    constexpr std::uint32_t formatVersion = 3;
+    constexpr size_t pageSize = 4096;   // bytes of records and pool per page checksum
+
+    // Size and modification time of a file, all zero if it doesn't exist
+    struct FileStamp
+    {
+        std::uint64_t size = 0;
+        std::int64_t modified = 0;
+
+        static FileStamp of(const std::string &path);
+        bool operator==(const FileStamp &other) const { return size == other.size && modified == other.modified; }
+    };
+
+    std::uint32_t crc32(std::string_view data);
+
+    // Changes whenever a field is added, removed, renamed or reordered
+    template <typename Entity>
+    std::uint32_t schemaHash()
+    {
+        std::uint32_t hash = 2166136261u;
+        for (std::string_view name : Reflection::KeyIndex<Entity>::names)
+        {
+            for (char c : name)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+            }
+            hash = (hash ^ 0xFFu) * 16777619u;
+        }
+        return hash;
+    }
+
+    template <typename Entity>
+    constexpr size_t fieldCount() { return std::tuple_size_v<decltype(Entity::fields())>; }
+
+    // One flight's seat map; the blob is SeatMap's own binary form and the layout is
+    // its cabin layout's name (empty for a standard layout)
+    struct SeatMapRecord
+    {
+        std::string flightNumber;
+        std::string layout;
+        std::string seatMap;
+
+        static constexpr auto fields()
+        {
+            using Reflection::field;
+            return std::make_tuple(field("flightNumber", &SeatMapRecord::flightNumber), field("layout", &SeatMapRecord::layout),
+                                   field("seatMap", &SeatMapRecord::seatMap));
+        }
+    };
+
+    // Collects sections in memory and writes the file in one go
+    class Writer
+    {
+    public:
+        template <typename Entity>
+        void addSection(const std::string &name, const std::vector<Entity> &entities, const FileStamp &source);
+
+        // Written to a temporary file and renamed over path, so readers never see a partial file
+        void save(const std::string &path) const;
+
+    private:
+        struct Section
+        {
+            std::string name;
+            std::uint32_t fieldCount = 0;
+            std::uint32_t schemaHash = 0;
+            std::uint64_t recordCount = 0;
+            std::string records;
+            std::string pool;
+            FileStamp source;
+        };
+
+        std::vector<Section> sections;
+    };
+
+    // Page checksums of one section's records and pool, each page checked on first use
+    class PageChecks
+    {
+    public:
+        PageChecks(std::string_view data, std::string_view checksums, size_t pageSize, std::string section);
+
+        // Throws std::runtime_error if a page holding any of data's bytes [offset, offset + length) is corrupt
+        void verify(size_t offset, size_t length) const;
+
+    private:
+        std::string_view data;
+        std::string_view checksums;
+        size_t pageSize;
+        std::string section;
+        std::unique_ptr<std::atomic<bool>[]> verified;
+    };
+
+    // Random access to the records of one section
+    template <typename Entity>
+    class Table
+    {
+    public:
+        Table(std::shared_ptr<const MappedFile> file, std::string_view records, std::string_view pool, size_t count,
+              std::shared_ptr<const PageChecks> pages)
+            : file(std::move(file)), records(records), pool(pool), count(count), pages(std::move(pages)) {}
+
+        size_t size() const { return count; }
+
+        // Decodes record index; only its slots and the pool bytes it refers to are read
+        Entity get(size_t index) const;
+
+        std::vector<Entity> loadAll() const;
+
+    private:
+        std::shared_ptr<const MappedFile> file;   // keeps the mapping alive
+        std::string_view records;
+        std::string_view pool;
+        size_t count;
+        std::shared_ptr<const PageChecks> pages;   // over records and pool, which are contiguous
+    };
+
+    class Reader
+    {
+    public:
+        // Maps the file and checks the header; throws std::runtime_error if it isn't a valid snapshot
+        explicit Reader(const std::string &path);
+
+        bool hasSection(std::string_view name) const { return findSection(name) != nullptr; }
+        FileStamp sourceOf(std::string_view name) const;
+        std::vector<std::string> sectionNames() const;
+
+        // Checks the section's schema and page checksums, then gives access to its records
+        template <typename Entity>
+        Table<Entity> table(std::string_view name) const;
+
+    private:
+        struct SectionEntry
+        {
+            std::string name;
+            std::uint32_t fieldCount;
+            std::uint32_t schemaHash;
+            std::uint64_t recordCount;
+            std::uint64_t recordsOffset;
+            std::uint64_t poolOffset;
+            std::uint64_t poolSize;
+            FileStamp source;
+            std::uint32_t checksum;        // of the page checksums
+            std::uint32_t pageSize;
+        };
+
+        const SectionEntry* findSection(std::string_view name) const;
+        const SectionEntry& openSection(std::string_view name, std::uint32_t fieldCount, std::uint32_t schemaHash) const;
+        std::string_view pageChecksumsOf(const SectionEntry& section) const;
+        std::shared_ptr<const PageChecks> pageChecks(const SectionEntry& section) const;
+
+        std::string path;
+        std::shared_ptr<const MappedFile> file;
+        std::vector<SectionEntry> sections;
+    };
+
+    // Section name for a source file: its stem
+    std::string sectionName(const std::string &sourceFile);
+
+    // Entities from the snapshot when its section was built from the current jsonFile,
+    // otherwise parsed from jsonFile
+    template <typename Entity>
+    std::vector<Entity> loadEntities(const std::string &jsonFile);
+
+
+    template <typename Entity>
+    void Writer::addSection(const std::string &name, const std::vector<Entity> &entities, const FileStamp &source)
+    {
+        Section section;
+        section.name = name;
+        section.fieldCount = static_cast<std::uint32_t>(fieldCount<Entity>());
+        section.schemaHash = schemaHash<Entity>();
+        section.recordCount = entities.size();
+        section.source = source;
+        section.records.reserve(entities.size() * section.fieldCount * 8);
+
+        // Identical values share one copy in the pool
+        std::unordered_map<std::string, std::uint32_t> pooled;
+        Reflection::BinaryWriter slots(section.records);
+        std::string encoded;
+        for (const auto &entity : entities)
+        {
+            Reflection::forEachField<Entity>([&](const auto &field)
+            {
+                using FieldType = std::decay_t<decltype(field)>;
+                encoded.clear();
+                Reflection::BinaryWriter value(encoded);
+                FieldType::Codec::writeBinary(value, entity.*field.member);
+                if constexpr (Reflection::detail::HasFixedSlot<typename FieldType::Codec>::value)
+                {
+                    section.records += encoded;
+                }
+                else
+                {
+                    auto [entry, added] = pooled.try_emplace(encoded, static_cast<std::uint32_t>(section.pool.size()));
+                    if (added)
+                    {
+                        section.pool += encoded;
+                    }
+                    slots.writeU32(entry->second);
+                    slots.writeU32(static_cast<std::uint32_t>(encoded.size()));
+                }
+            });
+        }
+        sections.push_back(std::move(section));
+    }
+
+    template <typename Entity>
+    Entity Table<Entity>::get(size_t index) const
+    {
+        if (index >= count)
+        {
+            throw std::out_of_range("Snapshot record out of range");
+        }
+
+        Entity entity;
+        const size_t recordSize = fieldCount<Entity>() * 8;
+        pages->verify(index * recordSize, recordSize);
+        std::string_view record = records.substr(index * recordSize, recordSize);
+        size_t slot = 0;
+        Reflection::forEachField<Entity>([&](const auto &field)
+        {
+            using FieldType = std::decay_t<decltype(field)>;
+            Reflection::BinaryReader slotReader(record.substr(8 * slot++, 8));
+            if constexpr (Reflection::detail::HasFixedSlot<typename FieldType::Codec>::value)
+            {
+                FieldType::Codec::readBinary(slotReader, entity.*field.member);
+            }
+            else
+            {
+                std::uint32_t offset = slotReader.readU32();
+                std::uint32_t length = slotReader.readU32();
+                if (offset > pool.size() || length > pool.size() - offset)
+                {
+                    throw std::runtime_error("Snapshot string pool offset out of range");
+                }
+                pages->verify(records.size() + offset, length);
+                Reflection::BinaryReader value(pool.substr(offset, length));
+                FieldType::Codec::readBinary(value, entity.*field.member);
+            }
+        });
+        return entity;
+    }
+
+    template <typename Entity>
+    std::vector<Entity> Table<Entity>::loadAll() const
+    {
+        pages->verify(0, records.size() + pool.size());
+        std::vector<Entity> entities;
+        entities.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            entities.push_back(get(i));
+        }
+        return entities;
+    }
+
+    template <typename Entity>
+    Table<Entity> Reader::table(std::string_view name) const
+    {
+        const SectionEntry &section = openSection(name, static_cast<std::uint32_t>(fieldCount<Entity>()), schemaHash<Entity>());
+        std::string_view data = file->data();
+        return Table<Entity>(file, data.substr(section.recordsOffset, section.recordCount * fieldCount<Entity>() * 8),
+                             data.substr(section.poolOffset, section.poolSize), section.recordCount, pageChecks(section));
+    }
+
+    template <typename Entity>
+    std::vector<Entity> loadEntities(const std::string &jsonFile)
+    {
+        const std::string section = sectionName(jsonFile);
+        std::error_code ec;
+        if (std::filesystem::exists(defaultFile, ec))
+        {
+            try
+            {
+                Reader reader(defaultFile);
+                if (reader.hasSection(section) && reader.sourceOf(section) == FileStamp::of(jsonFile))
+                {
+                    return reader.table<Entity>(section).loadAll();
+                }
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Ignoring snapshot: " << e.what() << std::endl;
+            }
+        }
+        return JsonUtils::readEntitiesFromFile<Entity>(jsonFile);
+    }
+}
+
+#endif
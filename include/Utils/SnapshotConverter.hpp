@@ -0,0 +1,24 @@
+#ifndef SNAPSHOTCONVERTER_HPP
+#define SNAPSHOTCONVERTER_HPP
+
+#include <string>
+#include "Snapshot.hpp"
+#include "../Flight/Flight.hpp"
+#include "../Flight/Aircraft.hpp"
+#include "../Flight/Crew.hpp"
+#include "../Flight/SeatInventory.hpp"
+#include "../Booking/Reservation.hpp"
+#include "../User/User.hpp"
+
+// Converts between the JSON data files and the binary snapshot (see Snapshot.hpp).
+// Sections: flights, reservations, users, aircraft, crew and seats.
+namespace SnapshotConverter
+{
+    // Build a snapshot from the current data files and seat inventory
+    void buildFromJson(const std::string &snapshotFile = Snapshot::defaultFile);
+
+    // Rewrite the data files and seat inventory from a snapshot
+    void restoreToJson(const std::string &snapshotFile = Snapshot::defaultFile);
+}
+
+#endif
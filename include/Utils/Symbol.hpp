@@ -0,0 +1,83 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Process-wide table of interned strings. Each distinct value (airport, aircraft type,
+// status, flight number, ...) is stored once and identified by a small integer ID.
+// Names live in fixed chunks that never move, so reading one needs no lock.
+class SymbolTable
+{
+public:
+    static SymbolTable& instance();
+    ~SymbolTable();
+
+    // ID of text, adding it if it's new
+    std::uint32_t intern(std::string_view text);
+
+    // ID of text if it was interned before (never adds)
+    std::optional<std::uint32_t> find(std::string_view text) const;
+
+    // Text of an ID returned by intern()
+    std::string_view name(std::uint32_t id) const
+    {
+        const std::string* chunk = chunks[id >> chunkBits].load(std::memory_order_acquire);
+        return chunk[id & (chunkSize - 1)];
+    }
+
+private:
+    SymbolTable();
+
+    static constexpr std::uint32_t chunkBits = 12;
+    static constexpr std::uint32_t chunkSize = 1u << chunkBits;
+    static constexpr std::uint32_t maxChunks = 1024;   // about 4M symbols
+
+    std::array<std::atomic<std::string*>, maxChunks> chunks{};
+    std::uint32_t count = 0;
+    std::unordered_map<std::string_view, std::uint32_t> ids;   // views into the chunks
+    mutable std::shared_mutex mutex;
+};
+
+// A 4-byte handle to an interned string. Comparing two symbols is an integer compare.
+// The default symbol is the empty string.
+class Symbol
+{
+public:
+    Symbol() = default;
+    Symbol(std::string_view text) : id(SymbolTable::instance().intern(text)) {}
+    Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+    Symbol(const char* text) : Symbol(std::string_view(text)) {}
+
+    // The symbol for text if it has ever been interned, so lookups don't grow the table
+    static std::optional<Symbol> find(std::string_view text);
+
+    std::string_view view() const { return SymbolTable::instance().name(id); }
+    std::string str() const { return std::string(view()); }
+    std::uint32_t getId() const { return id; }
+
+    friend bool operator==(Symbol a, Symbol b) { return a.id == b.id; }
+    friend bool operator!=(Symbol a, Symbol b) { return a.id != b.id; }
+
+private:
+    std::uint32_t id = 0;
+};
+
+namespace std
+{
+    template <>
+    struct hash<Symbol>
+    {
+        size_t operator()(Symbol symbol) const noexcept { return symbol.getId(); }
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timer wheel: scheduling, cancelling and expiring a timer are O(1).
+// Time advances in fixed ticks. Level 0 has one slot per tick for the next 64 ticks;
+// each higher level covers 64 times the span of the one below, one slot per span of
+// the level below. When level 0 wraps, the next slot of level 1 is spread over level 0
+// (and so on up), so a timer is moved at most once per level before it fires.
+// Deadlines beyond the top level wait in its furthest slot and are placed again when
+// that slot comes round. Not thread-safe; the owner serializes access.
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint64_t;   // 0 is never a valid timer
+
+    explicit TimerWheel(Clock::duration tick, Clock::time_point start = Clock::now());
+
+    // Arm a timer that hands payload back once deadline has passed
+    TimerId schedule(Clock::time_point deadline, std::uint64_t payload);
+
+    // Disarm a timer; false if it already fired or was cancelled
+    bool cancel(TimerId id);
+
+    // Move time forward to now and call expired(payload) for every timer that fell due.
+    // Returns the number of timers that fired.
+    template <typename Expired>
+    size_t advance(Clock::time_point now, Expired&& expired);
+
+    size_t size() const { return armed; }
+
+private:
+    static constexpr int slotBits = 6;
+    static constexpr std::uint32_t slotsPerLevel = 1u << slotBits;
+    static constexpr int levels = 4;
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    struct Timer
+    {
+        std::uint64_t deadline = 0;     // in ticks
+        std::uint64_t payload = 0;
+        std::uint32_t generation = 0;   // tells a reused node from the timer an old ID named
+        std::uint32_t slot = none;      // slot the timer is linked into, none if free
+        std::uint32_t prev = none;
+        std::uint32_t next = none;
+    };
+
+    std::uint64_t toTick(Clock::time_point time) const;
+    void place(std::uint32_t index, std::uint64_t earliest);
+    void link(std::uint32_t index, std::uint32_t slot);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+    void cascade(int level);
+
+    Clock::time_point start;
+    Clock::duration tick;
+    std::uint64_t currentTick = 0;
+    size_t armed = 0;
+
+    std::vector<Timer> timers;   // node pool; free nodes are chained through next
+    std::uint32_t freeList = none;
+    std::array<std::uint32_t, levels * slotsPerLevel> slots;
+};
+
+
+template <typename Expired>
+size_t TimerWheel::advance(Clock::time_point now, Expired&& expired)
+{
+    std::uint64_t target = toTick(now);
+    size_t fired = 0;
+    while (currentTick < target)
+    {
+        if (armed == 0)
+        {
+            currentTick = target; // Nothing to move or fire on the way
+            break;
+        }
+
+        currentTick++;
+        // Spread the slots that just came round, highest level first so their timers
+        // reach the lower slots before those are spread in turn
+        int top = 0;
+        while (top + 1 < levels && (currentTick & ((std::uint64_t(1) << (slotBits * (top + 1))) - 1)) == 0)
+        {
+            top++;
+        }
+        for (int level = top; level > 0; level--)
+        {
+            cascade(level);
+        }
+
+        std::uint32_t slot = static_cast<std::uint32_t>(currentTick & (slotsPerLevel - 1));
+        while (slots[slot] != none)
+        {
+            std::uint32_t index = slots[slot];
+            std::uint64_t payload = timers[index].payload;
+            unlink(index);
+            release(index);
+            fired++;
+            expired(payload);
+        }
+    }
+    return fired;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef TIMESTAMP_HPP
+#define TIMESTAMP_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Locale-free UTC timestamps stored as int64 seconds since 1970-01-01.
+// Parsing and formatting are hand-written for the fixed "YYYY-MM-DD HH:MM:SS[Z]"
+// layout used in the data files, so no stream, locale or time zone is involved.
+namespace Timestamp
+{
+    // Marks a time that couldn't be parsed
+    constexpr std::int64_t invalid = INT64_MIN;
+    constexpr std::int64_t secondsPerDay = 86400;
+
+    // Days since 1970-01-01 for a proleptic Gregorian date
+    constexpr std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day)
+    {
+        year -= month <= 2;
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+        const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+    }
+
+    constexpr std::int64_t fromCivil(std::int64_t year, unsigned month, unsigned day,
+                                     unsigned hour = 0, unsigned minute = 0, unsigned second = 0)
+    {
+        return daysFromCivil(year, month, day) * secondsPerDay + hour * 3600 + minute * 60 + second;
+    }
+
+    // Day number of a timestamp (floor division, so times before 1970 work too)
+    constexpr std::int64_t dayOf(std::int64_t time)
+    {
+        if (time == invalid)
+        {
+            return invalid;
+        }
+        return (time >= 0 ? time : time - (secondsPerDay - 1)) / secondsPerDay;
+    }
+
+    // "YYYY-MM-DD", "YYYY-MM-DD HH:MM" or "YYYY-MM-DD HH:MM:SS", optionally with 'T'
+    // instead of the space and a trailing 'Z'. Returns invalid on anything else.
+    std::int64_t parse(std::string_view text);
+
+    // Parse just a "YYYY-MM-DD" date into a day number, invalid on error
+    std::int64_t parseDay(std::string_view text);
+
+    // Midnight on the first day of the month after the one containing time
+    std::int64_t startOfNextMonth(std::int64_t time);
+
+    // "YYYY-MM-DD HH:MM:SSZ" (empty for invalid)
+    std::string format(std::int64_t time);
+
+    // "YYYY-MM-DD" (empty for invalid)
+    std::string formatDate(std::int64_t time);
+}
+
+#endif
@@ -8,7 +8,6 @@
 #include <conio.h>
 #include <sstream>
 #include <iomanip>
-#include <random>
 
 namespace Utils
 {
@@ -6,6 +6,8 @@
 #include "include/User/BookingAgent.hpp"
 #include "include/User/Passenger.hpp"
 #include "include/Utils/Utils.hpp"
+#include "include/Utils/SnapshotConverter.hpp"
+#include "include/Booking/TransactionManager.hpp"
 #include <conio.h>
 
 
@@ -19,8 +21,44 @@ void showMenu()
     std::cout << "Enter choice: ";
 }
 
-int main()
+// Offline conversion between the JSON data files and the binary snapshot
+int runSnapshotCommand(const std::string& command)
 {
+    try
+    {
+        if (command == "--build-snapshot")
+        {
+            SnapshotConverter::buildFromJson();
+            std::cout << "Snapshot written to " << Snapshot::defaultFile << std::endl;
+            return 0;
+        }
+        if (command == "--restore-snapshot")
+        {
+            SnapshotConverter::restoreToJson();
+            std::cout << "Data files restored from " << Snapshot::defaultFile << std::endl;
+            return 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Snapshot error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Usage: main [--build-snapshot | --restore-snapshot]" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    // Finish any transactions a crash left in the intent journal before reading the stores
+    TransactionManager::instance();
+
+    if (argc > 1)
+    {
+        return runSnapshotCommand(argv[1]);
+    }
+
     while (true)
     {
         Utils::clearScreen();
@@ -0,0 +1,516 @@
+#include "../../include/Booking/ReservationJournal.hpp"
+#include "../../include/Booking/TransactionManager.hpp"
+#include "../../include/Utils/Snapshot.hpp"
+#include "../../include/Utils/FileLock.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+ReservationJournal::ReservationJournal(const std::string& snapshotFile, const std::string& journalFile)
+    : snapshotFile(snapshotFile), journalFile(journalFile), lockFile(JsonUtils::lockFileFor(journalFile))
+{
+    {
+        FileLock fileLock(lockFile);
+        std::lock_guard<std::mutex> lock(mutex);
+        reload(true);
+    }
+    openJournal();
+    worker = std::thread(&ReservationJournal::backgroundLoop, this);
+}
+
+ReservationJournal::~ReservationJournal()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+    if (journal)
+    {
+        std::fclose(journal);
+    }
+}
+
+ReservationJournal& ReservationJournal::instance()
+{
+    static ReservationJournal reservationJournal("data/reservations.json", "data/reservations.journal");
+    return reservationJournal;
+}
+
+std::vector<Reservation> ReservationJournal::getReservations() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return reservations;
+}
+
+std::optional<Reservation> ReservationJournal::findReservation(const std::string& reservationId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto position = positions.find(reservationId);
+    if (position == positions.end())
+    {
+        return std::nullopt;
+    }
+    return reservations[position->second];
+}
+
+Reservation* ReservationJournal::find(const std::string& reservationId)
+{
+    auto position = positions.find(reservationId);
+    return position != positions.end() ? &reservations[position->second] : nullptr;
+}
+
+bool ReservationJournal::recordBooking(const Reservation& reservation, const std::optional<TransactionStamp>& stamp)
+{
+    nlohmann::json record = makeRecord({{"op", "book"}, {"reservation", reservation.toJson()}}, stamp);
+    FileLock fileLock(lockFile);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(true);
+    if (isApplied(stamp))
+    {
+        return false;
+    }
+    append(record);
+    apply(record);
+    return true;
+}
+
+bool ReservationJournal::recordBookings(const std::vector<Reservation>& group, const std::optional<TransactionStamp>& stamp)
+{
+    // Still one line per booking, so readers replay a group like single bookings
+    std::string lines;
+    std::vector<nlohmann::json> records;
+    records.reserve(group.size());
+    for (const auto &reservation : group)
+    {
+        records.push_back(makeRecord({{"op", "book"}, {"reservation", reservation.toJson()}}, stamp));
+        lines += records.back().dump();
+        lines.push_back('\n');
+    }
+
+    FileLock fileLock(lockFile);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(true);
+    if (isApplied(stamp))
+    {
+        return false;
+    }
+    appendLines(lines, records.size());
+    for (const auto &record : records)
+    {
+        apply(record);
+    }
+    return true;
+}
+
+bool ReservationJournal::recordUpdate(const Reservation& reservation, const std::optional<TransactionStamp>& stamp)
+{
+    FileLock fileLock(lockFile);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(true);
+    if (isApplied(stamp) || !find(reservation.getReservationId()))
+    {
+        return false;
+    }
+    nlohmann::json record = makeRecord({{"op", "update"}, {"reservation", reservation.toJson()}}, stamp);
+    append(record);
+    apply(record);
+    return true;
+}
+
+bool ReservationJournal::recordStatusChange(const std::string& reservationId, const std::string& status)
+{
+    FileLock fileLock(lockFile);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(true);
+    if (!find(reservationId))
+    {
+        return false;
+    }
+    nlohmann::json record = {{"op", "status"}, {"reservationId", reservationId}, {"status", status}};
+    append(record);
+    apply(record);
+    return true;
+}
+
+bool ReservationJournal::recordCancellation(const std::string& reservationId, const std::optional<TransactionStamp>& stamp)
+{
+    FileLock fileLock(lockFile);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(true);
+    if (isApplied(stamp) || !find(reservationId))
+    {
+        return false;
+    }
+    nlohmann::json record = makeRecord({{"op", "cancel"}, {"reservationId", reservationId}}, stamp);
+    append(record);
+    apply(record);
+    return true;
+}
+
+void ReservationJournal::refresh()
+{
+    auto version = JsonUtils::getFileVersion(journalFile);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (version.generation == generation && version.size == readOffset)
+        {
+            return; // Nothing appended or compacted elsewhere
+        }
+    }
+
+    FileLock fileLock(lockFile, FileLock::Mode::Shared);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(false);
+}
+
+void ReservationJournal::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    syncPending(lock);
+}
+
+void ReservationJournal::compact()
+{
+    // Take a consistent copy and remember where the journal ends
+    std::vector<Reservation> snapshot;
+    AppliedTransactions stamps;
+    std::uint64_t cut = 0;
+    std::uint64_t compactedGeneration = 0;
+    {
+        FileLock fileLock(lockFile);
+        std::unique_lock<std::mutex> lock(mutex);
+        catchUp(true);
+        syncPending(lock);
+        snapshot = reservations;
+        stamps = applied;
+        cut = readOffset;
+        compactedGeneration = generation;
+    }
+
+    // Serialize the snapshot without blocking new bookings
+    nlohmann::json reservationsJson = nlohmann::json::array();
+    for (const auto &reservation : snapshot)
+    {
+        reservationsJson.push_back(reservation.toJson());
+    }
+    std::string contents = reservationsJson.dump(4);
+
+    FileLock fileLock(lockFile);
+    std::lock_guard<std::mutex> lock(mutex);
+    catchUp(true);
+    if (generation != compactedGeneration)
+    {
+        return; // Another process compacted meanwhile
+    }
+    JsonUtils::writeFileAtomically(snapshotFile, contents);
+
+    // Keep only the records appended while the snapshot was being written
+    std::fflush(journal);
+
+    // The snapshot's stamps go first, for the intent journals that may still be replayed
+    stamps.prune(TransactionManager::hasJournal);
+    std::string tail;
+    if (!stamps.empty())
+    {
+        tail = nlohmann::json{{"op", "applied"}, {"transactions", stamps.toJson()}}.dump() + "\n";
+    }
+    {
+        std::ifstream in(journalFile, std::ios::binary);
+        in.seekg(static_cast<std::streamoff>(cut));
+        tail.append(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::string tempJournal = journalFile + ".tmp";
+    std::FILE* rewritten = std::fopen(tempJournal.c_str(), "wb");
+    if (!rewritten)
+    {
+        throw std::runtime_error("Failed to open file: " + tempJournal);
+    }
+    bool written = std::fwrite(tail.data(), 1, tail.size(), rewritten) == tail.size();
+    try
+    {
+        JsonUtils::syncFile(rewritten);
+    }
+    catch (const std::runtime_error &)
+    {
+        written = false;
+    }
+    std::fclose(rewritten);
+    if (!written)
+    {
+        // The snapshot already holds the records, and replaying them again is harmless
+        std::remove(tempJournal.c_str());
+        throw std::runtime_error("Failed to write file: " + tempJournal);
+    }
+
+    // Other processes keep the journal open, so it is replaced rather than renamed
+    std::fclose(journal);
+    journal = nullptr;
+    JsonUtils::replaceFile(tempJournal, journalFile);
+    JsonUtils::bumpGeneration(journalFile);
+    openJournal();
+    journalRecords = static_cast<size_t>(std::count(tail.begin(), tail.end(), '\n'));
+    readOffset = tail.size();
+    generation = JsonUtils::getFileVersion(journalFile).generation;
+}
+
+void ReservationJournal::reload(bool repairTornRecord)
+{
+    reservations.clear();
+    positions.clear();
+    applied.clear();
+    readOffset = 0;
+    journalRecords = 0;
+    generation = JsonUtils::getFileVersion(journalFile).generation;
+
+    // Start from the snapshot
+    try
+    {
+        reservations = Snapshot::loadEntities<Reservation>(snapshotFile);
+        for (size_t i = 0; i < reservations.size(); i++)
+        {
+            positions[reservations[i].getReservationId()] = i;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error loading reservations: " << e.what() << std::endl;
+    }
+
+    // The journal may have been replaced by another process's compaction
+    if (journal)
+    {
+        std::fclose(journal);
+        journal = nullptr;
+        openJournal();
+    }
+
+    // Then apply every journal record in order
+    catchUp(repairTornRecord);
+}
+
+void ReservationJournal::catchUp(bool repairTornRecord)
+{
+    auto version = JsonUtils::getFileVersion(journalFile);
+    if (version.generation != generation)
+    {
+        reload(repairTornRecord); // Compacted elsewhere: the snapshot now holds what we had read
+        externalChanges++;
+        return;
+    }
+    if (version.size <= readOffset)
+    {
+        return;
+    }
+
+    // Apply the records appended since the last look; a torn last line ends the pass
+    std::ifstream in(journalFile, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(readOffset));
+    std::string line;
+    std::uint64_t validBytes = 0;
+    bool torn = false;
+    while (std::getline(in, line))
+    {
+        nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+        if (in.eof() || record.is_discarded() || !record.contains("op"))
+        {
+            torn = true;
+            break;
+        }
+        validBytes += line.size() + 1;
+        try
+        {
+            apply(record);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Skipping bad journal record: " << e.what() << std::endl;
+        }
+        journalRecords++;
+    }
+    in.close();
+    readOffset += validBytes;
+    if (validBytes > 0)
+    {
+        externalChanges++;
+    }
+
+    // Cut the torn record off so new appends start on a clean line
+    if (torn && repairTornRecord)
+    {
+        std::cerr << "Discarding incomplete record at the end of " << journalFile << std::endl;
+        std::filesystem::resize_file(journalFile, static_cast<std::uintmax_t>(readOffset));
+    }
+}
+
+void ReservationJournal::apply(const nlohmann::json& record)
+{
+    const std::string op = record.at("op").get<std::string>();
+    if (record.contains("stamp"))
+    {
+        applied.add(TransactionStamp::fromJson(record.at("stamp")));
+    }
+
+    if (op == "applied")
+    {
+        applied.merge(AppliedTransactions::fromJson(record.at("transactions")));
+    }
+    else if (op == "book" || op == "update")
+    {
+        Reservation reservation = Reservation::fromJson(record.at("reservation"));
+        if (Reservation* existing = find(reservation.getReservationId()))
+        {
+            *existing = reservation;
+        }
+        else
+        {
+            positions[reservation.getReservationId()] = reservations.size();
+            reservations.push_back(reservation);
+        }
+    }
+    else if (op == "status")
+    {
+        if (Reservation* existing = find(record.at("reservationId").get<std::string>()))
+        {
+            existing->setStatus(record.at("status").get<std::string>());
+        }
+    }
+    else if (op == "cancel")
+    {
+        auto position = positions.find(record.at("reservationId").get<std::string>());
+        if (position != positions.end())
+        {
+            // Move the last reservation into the gap, so a cancellation is O(1)
+            size_t index = position->second;
+            positions.erase(position);
+            if (index + 1 != reservations.size())
+            {
+                reservations[index] = std::move(reservations.back());
+                positions[reservations[index].getReservationId()] = index;
+            }
+            reservations.pop_back();
+        }
+    }
+}
+
+bool ReservationJournal::isApplied(const std::optional<TransactionStamp>& stamp) const
+{
+    return stamp && applied.contains(*stamp);
+}
+
+nlohmann::json ReservationJournal::makeRecord(nlohmann::json record, const std::optional<TransactionStamp>& stamp)
+{
+    if (stamp)
+    {
+        record["stamp"] = stamp->toJson();
+    }
+    return record;
+}
+
+void ReservationJournal::append(const nlohmann::json& record)
+{
+    std::string line = record.dump();
+    line.push_back('\n');
+    appendLines(line, 1);
+}
+
+void ReservationJournal::appendLines(const std::string& lines, size_t count)
+{
+    // The journal is unbuffered, so this is written through before the file lock is
+    // released and other processes can read it. A failed append is cut off again, so
+    // neither this process nor another ever applies a change that was refused.
+    if (std::fwrite(lines.data(), 1, lines.size(), journal) != lines.size())
+    {
+        std::clearerr(journal);
+        std::error_code ec;
+        std::filesystem::resize_file(journalFile, static_cast<std::uintmax_t>(readOffset), ec);
+        throw std::runtime_error("Failed to append to file: " + journalFile);
+    }
+
+    readOffset += lines.size();
+    journalRecords += count;
+    pendingRecords += count;
+    if (pendingRecords >= maxPendingRecords)
+    {
+        wakeUp.notify_one();
+    }
+}
+
+void ReservationJournal::openJournal()
+{
+    journal = JsonUtils::openShared(journalFile, "ab");
+    if (!journal)
+    {
+        throw std::runtime_error("Failed to open file: " + journalFile);
+    }
+    std::setvbuf(journal, nullptr, _IONBF, 0);
+}
+
+void ReservationJournal::syncPending(std::unique_lock<std::mutex>& lock)
+{
+    if (pendingRecords == 0)
+    {
+        return;
+    }
+
+    // fsync a second descriptor without the mutex, so appends go on meanwhile (and a
+    // compaction may even close the journal); the records counted here are then on disk
+    const size_t synced = pendingRecords;
+    int descriptor = JsonUtils::duplicateDescriptor(journal);
+    lock.unlock();
+    try
+    {
+        JsonUtils::syncAndClose(descriptor);
+    }
+    catch (const std::exception &)
+    {
+        lock.lock();
+        throw;
+    }
+    lock.lock();
+    pendingRecords -= std::min(synced, pendingRecords);
+}
+
+void ReservationJournal::backgroundLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        wakeUp.wait_for(lock, flushInterval, [this] { return stopping || pendingRecords >= maxPendingRecords; });
+
+        try
+        {
+            syncPending(lock);
+            if (journalRecords >= compactAfterRecords && !stopping)
+            {
+                lock.unlock();
+                compact();
+                lock.lock();
+            }
+        }
+        catch (const std::exception &e)
+        {
+            if (!lock.owns_lock())
+            {
+                lock.lock();
+            }
+            std::cerr << "Reservation journal error: " << e.what() << std::endl;
+        }
+    }
+
+    try
+    {
+        syncPending(lock);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Reservation journal error: " << e.what() << std::endl;
+    }
+}
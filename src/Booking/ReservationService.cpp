@@ -1,45 +1,44 @@
 #include "../../include/Booking/ReservationService.hpp"
+#include "../../include/Booking/TransactionManager.hpp"
+#include "../../include/Utils/ReservationIdGenerator.hpp"
+#include <chrono>
+#include <algorithm>
  
 
 ReservationService::ReservationService()
 {
-    reservations = getReservations();
 }
 void ReservationService::displayReservations(const std::string &passengerId)
 { 
     bool found = false;
-    reservations = getReservations();
 
-    for (const auto &reservation : reservations)
+    for (const auto &reservation : getReservationsByPassenger(passengerId))
     {
-        if (reservation.getPassengerId() == passengerId)
-        {   
-            // Find the flight
-            auto flightOpt = flightService.findFlight(reservation.getFlightNumber());
-
-            // Check if the flight was found
-            if (!flightOpt)
-            {
-                std::cout << "Reservation ID: " << reservation.getReservationId() << std::endl;
-                std::cout << "Flight: " << reservation.getFlightNumber() << " (Flight details not found)" << std::endl;
-                std::cout << "Seat: " << reservation.getSeatNumber() << std::endl;
-                std::cout << "Status: " << reservation.getStatus() << std::endl;
-                std::cout << "-------------------------" << std::endl;
-                found = true;
-                continue; // Skip to the next reservation
-            }
-
-            // Flight was found, display details
-            Flight &flight = flightOpt.value().get();
+        // Find the flight
+        auto flightOpt = flightService.findFlight(reservation.getFlightNumber());
+
+        // Check if the flight was found
+        if (!flightOpt)
+        {
             std::cout << "Reservation ID: " << reservation.getReservationId() << std::endl;
-            std::cout << "Flight: " << reservation.getFlightNumber() << " from " << flight.getOrigin();
-            std::cout << " to " << flight.getDestination() << std::endl;
-            std::cout << "Departure: " << flight.getDepartureDateAndTime() << std::endl;
+            std::cout << "Flight: " << reservation.getFlightNumber() << " (Flight details not found)" << std::endl;
             std::cout << "Seat: " << reservation.getSeatNumber() << std::endl;
             std::cout << "Status: " << reservation.getStatus() << std::endl;
             std::cout << "-------------------------" << std::endl;
             found = true;
+            continue; // Skip to the next reservation
         }
+
+        // Flight was found, display details
+        const Flight &flight = *flightOpt;
+        std::cout << "Reservation ID: " << reservation.getReservationId() << std::endl;
+        std::cout << "Flight: " << reservation.getFlightNumber() << " from " << flight.getOrigin();
+        std::cout << " to " << flight.getDestination() << std::endl;
+        std::cout << "Departure: " << flight.getDepartureDateAndTime() << std::endl;
+        std::cout << "Seat: " << reservation.getSeatNumber() << std::endl;
+        std::cout << "Status: " << reservation.getStatus() << std::endl;
+        std::cout << "-------------------------" << std::endl;
+        found = true;
     }
 
     if (!found)
@@ -51,15 +50,15 @@ void ReservationService::displayReservations(const std::string &passengerId)
 
 void ReservationService::displayReservation(const Reservation &reservation)
 { 
-    std::optional<std::reference_wrapper<Flight>> flightOpt;
+    FlightCatalog::FlightHandle flightOpt;
     bool found = false;
-    reservations = getReservations();
-    for (const auto &reservationSearch : reservations)
+    if (ReservationJournal::instance().findReservation(reservation.getReservationId()))
     {
-        if (reservationSearch.getReservationId() == reservation.getReservationId())
-        {   
-            flightOpt = flightService.findFlight(reservation.getFlightNumber());
-            Flight &flight = flightOpt.value().get();
+        flightOpt = flightService.findFlight(reservation.getFlightNumber());
+        // Skip if the flight was removed from the schedule
+        if (flightOpt)
+        {
+            const Flight &flight = *flightOpt;
             std::cout << "Reservation ID: " << reservation.getReservationId() << std::endl;
             std::cout << "Flight: " << reservation.getFlightNumber() << " from "<<flight.getOrigin();
             std::cout << " to " << flight.getDestination() << std::endl;
@@ -77,112 +76,500 @@ void ReservationService::displayReservation(const Reservation &reservation)
     }
 }
 
-bool ReservationService::bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails)
+bool ReservationService::bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails,
+                                    const std::optional<SeatHold>& seatHold)
 {
+    // Whatever happens below, the held seat doesn't stay taken
+    auto releaseHold = [&seatHold]
+    {
+        if (seatHold)
+        {
+            SeatHoldManager::instance().release(*seatHold);
+        }
+    };
+
     // Check for duplicates
-    for (const auto &existingReservation : reservations)
+    if (ReservationJournal::instance().findReservation(reservation.getReservationId()))
+    {
+        std::cout << "A reservation with the same ID already exists." << std::endl;
+        releaseHold();
+        return false;
+    }
+    // Claim the seat before charging anything; the seat and the reservation are stored together or not at all
+    Transaction transaction;
+    bool seatBooked = false;
+    if (seatHold)
+    {
+        seatBooked = SeatHoldManager::instance().confirm(*seatHold, transaction);
+        if (!seatBooked)
+        {
+            std::cout << "The hold on seat " << seatHold->seatNumber << " has expired." << std::endl;
+        }
+    }
+    // Without a hold (or after it expired) the seat may still be free
+    if (!seatBooked)
+    {
+        seatBooked = flightService.markSeatAsBooked(reservation.getFlightNumber(), reservation.getSeatNumber(), transaction);
+    }
+    if (!seatBooked)
+    {
+        std::cout << "Booking failed." << std::endl;
+        return false;
+    }
+
+    return payAndRecord(reservation, transaction, paymentMethod, paymentDetails);
+}
+
+bool ReservationService::payAndRecord(Reservation& reservation, Transaction& transaction, const std::string& paymentMethod,
+                                      const std::optional<std::string>& paymentDetails)
+{
+    std::cout << "Processing payment of $" << reservation.getPrice() << " via " << paymentMethod << "..." << std::endl;
+    if (!paymentService.processPayment(paymentMethod, reservation.getPrice(), paymentDetails))
+    {
+        std::cout << "Booking failed. Payment could not be processed." << std::endl;
+        return false; // The transaction gives the seat back
+    }
+    std::cout << "Payment successful!" << std::endl;
+
+    reservation.setPaymentStatus("Paid");
+    reservation.setPaymentDetails(paymentMethod, paymentDetails);
+    transaction.recordBooking(reservation);
+    if (!transaction.commit())
+    {
+        std::cout << "Booking failed. The booking could not be saved." << std::endl;
+        paymentService.processRefund(paymentMethod, reservation.getPrice(), paymentDetails);
+        return false;
+    }
+
+    std::cout << "Booking successful!\nReservation ID: " << reservation.getReservationId() << std::endl;
+    indexReservation(reservation);
+    return true; // The menus wait for a key, once the transaction is closed
+}
+
+bool ReservationService::bookGroup(std::vector<Reservation> &reservations, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails,
+                                   const std::vector<SeatHold>& seatHolds)
+{
+    // Holds by flight and seat; whichever are left unconfirmed are released on the way out
+    std::unordered_map<std::string, const SeatHold*> holds;
+    for (const auto &seatHold : seatHolds)
+    {
+        holds.emplace(seatHold.flightNumber + ' ' + seatHold.seatNumber, &seatHold);
+    }
+    auto releaseHolds = [&holds]
     {
-        if (existingReservation.getReservationId() == reservation.getReservationId())
+        for (const auto &[seat, seatHold] : holds)
         {
-            std::cout << "A reservation with the same ID already exists." << std::endl;
+            SeatHoldManager::instance().release(*seatHold);
+        }
+    };
+
+    if (reservations.empty())
+    {
+        releaseHolds();
+        return false;
+    }
+
+    // Check for duplicates, within the group and against the stored reservations
+    ReservationJournal::instance().refresh();
+    std::set<std::string> reservationIds;
+    for (const auto &reservation : reservations)
+    {
+        if (!reservationIds.insert(reservation.getReservationId()).second || ReservationJournal::instance().findReservation(reservation.getReservationId()))
+        {
+            std::cout << "A reservation with the same ID (" << reservation.getReservationId() << ") already exists." << std::endl;
+            releaseHolds();
             return false;
         }
     }
-    // Process payment
-    if (paymentService.processPayment(paymentMethod, reservation.getPrice(), paymentDetails))
+
+    // Claim every seat before charging anything; one taken seat undoes them all
+    Transaction transaction;
+    double total = 0.0;
+    for (const auto &reservation : reservations)
     {
-        if (flightService.markSeatAsBooked(reservation.getFlightNumber(), reservation.getSeatNumber()))
+        bool seatBooked = false;
+        auto hold = holds.find(std::string(reservation.getFlightNumber()) + ' ' + reservation.getSeatNumber());
+        if (hold != holds.end())
         {
-            std::cout << "Processing payment of $" << reservation.getPrice() << " via " << paymentMethod << "..." << std::endl;
-            std::cout << "Payment successful!" << std::endl;
-            reservation.setPaymentStatus("Paid");
-            reservation.setPaymentDetails(paymentMethod, paymentDetails);
-            std::cout << "Booking successful!\nReservation ID: " << reservation.getReservationId() << std::endl;
-            reservations.push_back(reservation);
-            saveReservationsToJson("data/reservations.json");
-            std::cout << "Press any key to continue... " << std::endl;
-            std::cin.get(); // Waits for a single character (e.g., Enter)
-            return true;
+            seatBooked = SeatHoldManager::instance().confirm(*hold->second, transaction);
+            holds.erase(hold);
+        }
+        // Without a hold (or after it expired) the seat may still be free
+        if (!seatBooked)
+        {
+            seatBooked = transaction.bookSeat(reservation.getFlightNumber(), reservation.getSeatNumber());
         }
-        else
+        if (!seatBooked)
         {
-            std::cout << "Booking failed." << std::endl;
+            std::cout << "Group booking failed. Seat " << reservation.getSeatNumber() << " on flight " << reservation.getFlightNumber()
+                      << " is invalid or already booked." << std::endl;
+            transaction.rollback();
+            releaseHolds();
             return false;
         }
+        total += reservation.getPrice();
     }
-    else
+    releaseHolds(); // Holds for seats nobody in the group got
+
+    std::cout << "Processing payment of $" << total << " via " << paymentMethod << "..." << std::endl;
+    if (!paymentService.processPayment(paymentMethod, total, paymentDetails))
     {
         std::cout << "Booking failed. Payment could not be processed." << std::endl;
+        return false; // The transaction gives the seats back
+    }
+    std::cout << "Payment successful!" << std::endl;
+
+    for (auto &reservation : reservations)
+    {
+        reservation.setPaymentStatus("Paid");
+        reservation.setPaymentDetails(paymentMethod, paymentDetails);
+    }
+    transaction.recordBookings(reservations);
+    if (!transaction.commit())
+    {
+        std::cout << "Booking failed. The booking could not be saved." << std::endl;
+        paymentService.processRefund(paymentMethod, total, paymentDetails);
         return false;
     }
+
+    std::cout << "Group booking successful! " << reservations.size() << " reservations:" << std::endl;
+    for (const auto &reservation : reservations)
+    {
+        indexReservation(reservation);
+        std::cout << reservation.getReservationId() << "  " << reservation.getPassengerName() << "  seat " << reservation.getSeatNumber() << std::endl;
+    }
+    return true;
 }
 
-std::optional<std::reference_wrapper<Reservation>> ReservationService::findReservation(const std::string& reservationId)
+std::optional<Reservation> ReservationService::findReservation(const std::string& reservationId) const
 {
+    ReservationJournal::instance().refresh();
+    return ReservationJournal::instance().findReservation(reservationId);
+}
 
-    for (auto &reservation : reservations)
-    {
-        if (reservation.getReservationId() == reservationId)
+
+void ReservationService::updateReservationStatus(const std::string& reservationId, const std::string& status)
+{
+        // Status isn't an index key, so the indexes stay as they are
+        if (!ReservationJournal::instance().recordStatusChange(reservationId, status))
         {
-            return std::ref(reservation);
+            std::cout << "Reservation not found." << std::endl;
         }
+}
+
+bool ReservationService::updateReservation(const Reservation& reservation)
+{
+    auto previous = findReservation(reservation.getReservationId());
+    if (!previous || !ReservationJournal::instance().recordUpdate(reservation))
+    {
+        return false;
     }
 
-    // Return an empty reservation if not found
-    return std::nullopt; 
+    // Move the reservation if its passenger or flight changed
+    unindexReservation(*previous);
+    indexReservation(reservation);
+    return true;
 }
 
+bool ReservationService::changeSeat(Reservation& reservation, const std::string& newSeatNumber)
+{
+    Transaction transaction;
+    if (!findReservation(reservation.getReservationId()) ||
+        !flightService.changeSeat(reservation.getFlightNumber(), reservation.getSeatNumber(), newSeatNumber, transaction))
+    {
+        return false;
+    }
 
-void ReservationService::updateReservationStatus(const std::string& reservationId, const std::string& status)
+    // The seat isn't an index key, so the indexes stay as they are
+    Reservation moved = reservation;
+    moved.setSeatNumber(newSeatNumber);
+    transaction.recordUpdate(moved);
+    if (!transaction.commit())
+    {
+        return false;
+    }
+    reservation = std::move(moved);
+    return true;
+}
+
+bool ReservationService::cancelReservation(const std::string& reservationId)
 {
-        for (auto& reservation : reservations)
+    auto reservation = findReservation(reservationId);
+    if (!reservation)
+    {
+        return false;
+    }
+    expireWaitlistOffers();
+
+    // Drop the reservation and offer the seat on, or free it, in one transaction. An
+    // offered seat is never free on the way, so nobody else can take it meanwhile.
+    Transaction transaction;
+    auto seatMap = SeatInventory::instance().findSeatMap(reservation->getFlightNumber());
+    int seatIndex = seatMap ? seatMap->seatIndex(reservation->getSeatNumber()) : -1;
+    auto flight = FlightCatalog::instance().findFlight(reservation->getFlightNumber());
+    WaitlistOffer offer;
+    offer.seatNumber = reservation->getSeatNumber();
+    offer.gate = std::string(reservation->getGate());
+    offer.boardingTime = reservation->getBoardingTime();
+    offer.price = flight ? flight->getPrice() : reservation->getPrice();
+    bool offered = seatIndex >= 0 && seatMap->isBooked(seatIndex) &&
+                   offerToWaitlist(std::string(reservation->getFlightNumber()), offer, transaction);
+    if (!offered && !transaction.releaseSeat(reservation->getFlightNumber(), reservation->getSeatNumber()))
+    {
+        std::cout << "Flight or seat not found in the seat maps." << std::endl;
+    }
+    transaction.recordCancellation(reservationId);
+    if (!transaction.commit())
+    {
+        return false;
+    }
+
+    unindexReservation(*reservation);
+    if (offered)
+    {
+        std::cout << "Seat " << offer.seatNumber << " offered to waitlisted passenger " << offer.entry.passengerName
+                  << " for " << waitlistOfferTime.count() << " minutes." << std::endl;
+    }
+    return true;
+}
+
+bool ReservationService::offerToWaitlist(const std::string& flightNumber, WaitlistOffer& offer, Transaction& transaction)
+{
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    int seatIndex = seatMap ? seatMap->seatIndex(offer.seatNumber) : -1;
+    if (seatIndex < 0)
+    {
+        return false;
+    }
+    std::string_view cabinClass = seatMap->getLayout().cabinClassOf(seatIndex / seatMap->getCols());
+
+    // Passengers who got a seat on the flight some other way just leave the waitlist
+    std::optional<WaitlistEntry> entry;
+    while ((entry = transaction.claimFromWaitlist(flightNumber, cabinClass)) && hasReservationOn(entry->passengerId, flightNumber))
+    {
+    }
+    if (!entry)
+    {
+        return false;
+    }
+
+    offer.entry = *entry;
+    auto expiresAt = std::chrono::system_clock::now() + waitlistOfferTime;
+    offer.expiresAt = std::chrono::duration_cast<std::chrono::milliseconds>(expiresAt.time_since_epoch()).count();
+    transaction.openOffer(offer);
+    return true;
+}
+
+std::vector<WaitlistOffer> ReservationService::getWaitlistOffers(const std::string& passengerId) const
+{
+    expireWaitlistOffers();
+    return Waitlist::instance().getOffers(passengerId);
+}
+
+bool ReservationService::acceptWaitlistOffer(const std::string& entryId, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails)
+{
+    expireWaitlistOffers();
+
+    // The seat is still sold; a failed booking rolls back and the offer opens again
+    Transaction transaction;
+    auto offer = transaction.takeOffer(entryId);
+    if (!offer)
+    {
+        std::cout << "The offer is no longer open." << std::endl;
+        return false;
+    }
+
+    const WaitlistEntry &entry = offer->entry;
+    Reservation reservation(ReservationIdGenerator::instance().nextId(), entry.passengerId, entry.passengerName, entry.flightNumber,
+                            offer->seatNumber, offer->gate, offer->boardingTime, "Confirmed", offer->price);
+    return payAndRecord(reservation, transaction, paymentMethod, paymentDetails);
+}
+
+bool ReservationService::declineWaitlistOffer(const std::string& entryId)
+{
+    expireWaitlistOffers();
+    return passOn(entryId);
+}
+
+void ReservationService::expireWaitlistOffers()
+{
+    Waitlist &waitlist = Waitlist::instance();
+    waitlist.refresh();
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    for (const auto &entryId : waitlist.getExpiredOffers(now))
+    {
+        passOn(entryId);
+    }
+}
+
+bool ReservationService::passOn(const std::string& entryId)
+{
+    // Taking the offer closes it, so whoever gets here first passes the seat on
+    Transaction transaction;
+    auto offer = transaction.takeOffer(entryId);
+    if (!offer)
+    {
+        return false;
+    }
+
+    // The previous passenger isn't put back on the waitlist
+    std::string flightNumber = offer->entry.flightNumber;
+    if (!offerToWaitlist(flightNumber, *offer, transaction))
+    {
+        transaction.releaseSeat(flightNumber, offer->seatNumber);
+    }
+    return transaction.commit();
+}
+
+bool ReservationService::hasReservationOn(const std::string& passengerId, std::string_view flightNumber)
+{
+    // Only the passenger's own reservations are looked at
+    std::lock_guard<std::mutex> lock(indexMutex);
+    buildIndexes();
+    auto ids = reservationsByPassenger.find(passengerId);
+    if (ids == reservationsByPassenger.end())
+    {
+        return false;
+    }
+    for (const auto &reservationId : ids->second)
+    {
+        auto reservation = ReservationJournal::instance().findReservation(reservationId);
+        if (reservation && reservation->getFlightNumber() == flightNumber)
         {
-            if (reservation.getReservationId() == reservationId)
-            {
-                reservation.setStatus(status);
-                saveReservationsToJson("data/reservations.json");
-                return;
-            }
+            return true;
         }
+    }
+    return false;
+}
+
+bool ReservationService::joinWaitlist(WaitlistEntry& entry)
+{
+    if (!SeatInventory::instance().findSeatMap(entry.flightNumber))
+    {
+        std::cout << "Flight not found." << std::endl;
+        return false;
+    }
+    if (hasReservationOn(entry.passengerId, entry.flightNumber))
+    {
+        std::cout << "Passenger " << entry.passengerId << " already has a seat on flight " << entry.flightNumber << "." << std::endl;
+        return false;
+    }
+
+    Transaction transaction;
+    if (Waitlist::instance().isWaiting(entry.flightNumber, entry.passengerId))
+    {
+        std::cout << "Passenger " << entry.passengerId << " is already on the waitlist for flight " << entry.flightNumber << "." << std::endl;
+        return false;
+    }
+    entry.entryId = ReservationIdGenerator::instance().nextId();
+    entry.requestedAt = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    transaction.joinWaitlist(entry);
+    if (!transaction.commit())
+    {
+        return false;
+    }
 
-        std::cout << "Reservation not found." << std::endl;
+    std::cout << "Added to the waitlist for flight " << entry.flightNumber << " (" << loyaltyTierName(entry.tier) << " tier)." << std::endl;
+    return true;
+}
+
+std::vector<WaitlistEntry> ReservationService::getWaitlist(const std::string& flightNumber) const
+{
+    Waitlist::instance().refresh();
+    return Waitlist::instance().getEntries(flightNumber);
 }
 
 
 std::vector<Reservation> ReservationService::getReservations() const
 {
-    return loadReservationsFromJson("data/reservations.json");
+    ReservationJournal::instance().refresh();
+    return ReservationJournal::instance().getReservations();
 }
 
+std::vector<Reservation> ReservationService::getReservationsByPassenger(const std::string& passengerId) const
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    buildIndexes();
+    return collectReservations(reservationsByPassenger, passengerId);
+}
 
-
-std::vector<Reservation> ReservationService::loadReservationsFromJson(const std::string &filename) const
+std::vector<Reservation> ReservationService::getReservationsByFlight(const std::string& flightNumber) const
 {
-    std::vector<Reservation> reservations;
-    nlohmann::json reservationsJson = JsonUtils::readJsonFromFile(filename);
+    std::lock_guard<std::mutex> lock(indexMutex);
+    buildIndexes();
+    auto symbol = Symbol::find(flightNumber);
+    return symbol ? collectReservations(reservationsByFlight, *symbol) : std::vector<Reservation>{};
+}
 
-    // Ensure the JSON data is an array
-    if (!reservationsJson.is_array())
+void ReservationService::buildIndexes()
+{
+    // Built from the journal; afterwards every change made here updates them incrementally,
+    // while changes applied from other processes make them rebuild
+    ReservationJournal &journal = ReservationJournal::instance();
+    journal.refresh();
+    if (indexesBuilt && indexedChanges == journal.getExternalChanges())
     {
-        throw std::runtime_error("Invalid JSON format: Expected an array of reservations.");
+        return;
     }
-
-    for (const auto &reservationJson : reservationsJson)
+    reservationsByPassenger.clear();
+    reservationsByFlight.clear();
+    indexesBuilt = true;
+    indexedChanges = journal.getExternalChanges();
+    for (const auto &reservation : journal.getReservations())
     {
-        reservations.push_back(Reservation::fromJson(reservationJson));
+        reservationsByPassenger[reservation.getPassengerId()].insert(reservation.getReservationId());
+        reservationsByFlight[reservation.getFlightNumberSymbol()].insert(reservation.getReservationId());
     }
+}
 
-    return reservations;
+void ReservationService::indexReservation(const Reservation& reservation)
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    if (!indexesBuilt)
+    {
+        return;
+    }
+    reservationsByPassenger[reservation.getPassengerId()].insert(reservation.getReservationId());
+    reservationsByFlight[reservation.getFlightNumberSymbol()].insert(reservation.getReservationId());
 }
 
-void ReservationService::saveReservationsToJson(const std::string& filename) const 
+void ReservationService::unindexReservation(const Reservation& reservation)
 {
-    nlohmann::json reservationsJson;
+    std::lock_guard<std::mutex> lock(indexMutex);
+    auto removeFrom = [&reservation](auto& index, const auto& key)
+    {
+        auto entry = index.find(key);
+        if (entry == index.end())
+        {
+            return;
+        }
+        entry->second.erase(reservation.getReservationId());
+        if (entry->second.empty())
+        {
+            index.erase(entry);
+        }
+    };
+    removeFrom(reservationsByPassenger, reservation.getPassengerId());
+    removeFrom(reservationsByFlight, reservation.getFlightNumberSymbol());
+}
 
-    for (const auto &reservation : reservations)
+template <typename Key>
+std::vector<Reservation> ReservationService::collectReservations(const ReservationIndex<Key>& index, const Key& key)
+{
+    std::vector<Reservation> result;
+    auto entry = index.find(key);
+    if (entry == index.end())
     {
-        reservationsJson.push_back(reservation.toJson());
+        return result;
     }
 
-    JsonUtils::saveJsonToFile(reservationsJson, filename);
+    result.reserve(entry->second.size());
+    for (const auto &reservationId : entry->second)
+    {
+        if (auto reservation = ReservationJournal::instance().findReservation(reservationId))
+        {
+            result.push_back(std::move(*reservation));
+        }
+    }
+    return result;
 }
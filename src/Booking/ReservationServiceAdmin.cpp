@@ -5,15 +5,23 @@ std::pair<int, double> ReservationServiceAdmin::countReservationsAndRevenue(cons
     int count = 0;
     double revenue = 0.0;
 
-    auto reservations = getReservations();
-
-    for(const auto& reservation:reservations)
+    for(const auto& reservation:getReservationsByFlight(flightNumber))
     {
-        if(reservation.getFlightNumber() == flightNumber)
-        {
-            count++;
-            revenue += reservation.getPrice();
-        }
+        count++;
+        revenue += reservation.getPrice();
     }
     return {count, revenue};
-}
\ No newline at end of file
+}
+
+std::unordered_map<Symbol, std::pair<int, double>> ReservationServiceAdmin::countReservationsAndRevenueByFlight() const
+{
+    std::unordered_map<Symbol, std::pair<int, double>> totals;
+
+    for(const auto& reservation:getReservations())
+    {
+        auto& [count, revenue] = totals[reservation.getFlightNumberSymbol()];
+        count++;
+        revenue += reservation.getPrice();
+    }
+    return totals;
+}
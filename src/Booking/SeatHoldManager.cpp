@@ -0,0 +1,188 @@
+#include "../../include/Booking/SeatHoldManager.hpp"
+#include <iostream>
+
+SeatHoldManager::SeatHoldManager()
+{
+    // Held seats live in the inventory, which must outlive the expiry thread
+    SeatInventory::instance();
+    worker = std::thread(&SeatHoldManager::backgroundLoop, this);
+}
+
+SeatHoldManager::~SeatHoldManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+SeatHoldManager& SeatHoldManager::instance()
+{
+    static SeatHoldManager manager;
+    return manager;
+}
+
+std::optional<SeatHold> SeatHoldManager::hold(std::string_view flightNumber, const std::string& seatNumber, std::chrono::seconds ttl,
+                                              ExpiryHandler onExpire)
+{
+    SeatInventory &inventory = SeatInventory::instance();
+    auto seatMap = inventory.findSeatMap(flightNumber);
+    int seatIndex = seatMap ? seatMap->seatIndex(seatNumber) : -1;
+    if (seatIndex < 0 || !inventory.holdSeat(flightNumber, seatIndex))
+    {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return track(flightNumber, seatNumber, seatIndex, ttl, std::move(onExpire));
+}
+
+std::optional<SeatHold> SeatHoldManager::adopt(std::string_view flightNumber, const std::string& seatNumber, std::chrono::seconds ttl,
+                                               ExpiryHandler onExpire)
+{
+    SeatInventory &inventory = SeatInventory::instance();
+    auto seatMap = inventory.findSeatMap(flightNumber);
+    int seatIndex = seatMap ? seatMap->seatIndex(seatNumber) : -1;
+    if (seatIndex < 0 || !inventory.isHeldSeat(flightNumber, seatIndex))
+    {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &[id, active] : holds)
+    {
+        if (active.seatIndex == seatIndex && active.flightNumber.view() == flightNumber)
+        {
+            return std::nullopt;
+        }
+    }
+    return track(flightNumber, seatNumber, seatIndex, ttl, std::move(onExpire));
+}
+
+SeatHold SeatHoldManager::track(std::string_view flightNumber, const std::string& seatNumber, int seatIndex,
+                                std::chrono::seconds ttl, ExpiryHandler onExpire)
+{
+    SeatHold seatHold;
+    seatHold.id = nextId++;
+    seatHold.flightNumber = std::string(flightNumber);
+    seatHold.seatNumber = seatNumber;
+    seatHold.expiresAt = std::chrono::steady_clock::now() + ttl;
+
+    holds.emplace(seatHold.id, ActiveHold{Symbol(flightNumber), seatIndex, wheel.schedule(seatHold.expiresAt, seatHold.id),
+                                          seatHold, std::move(onExpire)});
+    return seatHold;
+}
+
+bool SeatHoldManager::confirm(const SeatHold& seatHold, Transaction& transaction)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto active = holds.find(seatHold.id);
+    if (active == holds.end())
+    {
+        return false;
+    }
+
+    ActiveHold ended = active->second;
+    wheel.cancel(ended.timer);
+    holds.erase(active);
+    if (!transaction.bookHeldSeat(seatHold.flightNumber, seatHold.seatNumber))
+    {
+        // Don't leave the seat taken by a hold nobody tracks any more
+        SeatInventory::instance().releaseHeldSeat(ended.flightNumber.view(), ended.seatIndex);
+        return false;
+    }
+    return true;
+}
+
+bool SeatHoldManager::release(const SeatHold& seatHold, bool keepSeatHeld)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto active = holds.find(seatHold.id);
+    if (active == holds.end())
+    {
+        return false;
+    }
+
+    wheel.cancel(active->second.timer);
+    if (!keepSeatHeld)
+    {
+        SeatInventory::instance().releaseHeldSeat(active->second.flightNumber.view(), active->second.seatIndex);
+    }
+    holds.erase(active);
+    return true;
+}
+
+bool SeatHoldManager::isActive(const SeatHold& seatHold) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return holds.count(seatHold.id) > 0;
+}
+
+size_t SeatHoldManager::getActiveCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return holds.size();
+}
+
+size_t SeatHoldManager::expire(std::chrono::steady_clock::time_point now)
+{
+    std::vector<std::pair<ExpiryHandler, SeatHold>> expired;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        count = wheel.advance(now, [this, &expired](std::uint64_t holdId)
+        {
+            auto active = holds.find(holdId);
+            if (active != holds.end())
+            {
+                if (active->second.onExpire)
+                {
+                    // The handler decides what becomes of the seat
+                    expired.emplace_back(std::move(active->second.onExpire), active->second.seatHold);
+                }
+                else
+                {
+                    SeatInventory::instance().releaseHeldSeat(active->second.flightNumber.view(), active->second.seatIndex);
+                }
+                holds.erase(active);
+            }
+        });
+    }
+
+    // Handlers may take new holds
+    for (const auto &[onExpire, seatHold] : expired)
+    {
+        try
+        {
+            onExpire(seatHold);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error handling expired hold on seat " << seatHold.seatNumber << " of flight "
+                      << seatHold.flightNumber << ": " << e.what() << std::endl;
+        }
+    }
+    return count;
+}
+
+void SeatHoldManager::backgroundLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        wakeUp.wait_for(lock, tick, [this] { return stopping; });
+        if (stopping)
+        {
+            break;
+        }
+
+        lock.unlock();
+        expire();
+        lock.lock();
+    }
+}
@@ -0,0 +1,865 @@
+#include "../../include/Booking/TransactionManager.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <set>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Where instance() keeps its journal: data/transactions-<pid>.journal
+    const char journalDirectory[] = "data";
+    const char journalStem[] = "transactions";
+
+    // Transactions the calling thread has open (they may nest)
+    thread_local int openOnThisThread = 0;
+
+    // The seats a transaction's operations book and release, by seat map index
+    struct SeatChanges
+    {
+        std::vector<SeatInventory::SeatRef> booked;
+        std::vector<SeatInventory::SeatRef> released;
+
+        bool empty() const { return booked.empty() && released.empty(); }
+    };
+
+    SeatChanges collectSeats(const nlohmann::json& operations)
+    {
+        SeatChanges changes;
+        for (const auto &operation : operations)
+        {
+            if (!TransactionManager::isSeatOperation(operation))
+            {
+                continue;
+            }
+            std::string flightNumber = operation.at("flightNumber").get<std::string>();
+            auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+            int seatIndex = seatMap ? seatMap->seatIndex(operation.at("seatNumber").get<std::string>()) : -1;
+            if (seatIndex < 0)
+            {
+                continue;
+            }
+            auto &seats = operation.at("op") == "bookSeat" ? changes.booked : changes.released;
+            seats.emplace_back(std::move(flightNumber), seatIndex);
+        }
+        return changes;
+    }
+}
+
+Transaction::Transaction()
+{
+    TransactionManager::instance().beginTransaction();
+    // Start from the seats and waitlist other processes have saved
+    SeatInventory::instance().refresh();
+    Waitlist::instance().refresh();
+}
+
+Transaction::~Transaction()
+{
+    rollback();
+}
+
+bool Transaction::bookSeat(std::string_view flightNumber, const std::string& seatNumber)
+{
+    return changeSeat(flightNumber, seatNumber, true);
+}
+
+bool Transaction::releaseSeat(std::string_view flightNumber, const std::string& seatNumber)
+{
+    return changeSeat(flightNumber, seatNumber, false);
+}
+
+bool Transaction::moveSeat(std::string_view flightNumber, const std::string& fromSeat, const std::string& toSeat)
+{
+    // Claim the new seat first so a taken seat leaves the old one untouched
+    if (!bookSeat(flightNumber, toSeat))
+    {
+        return false;
+    }
+    releaseSeat(flightNumber, fromSeat);
+    return true;
+}
+
+bool Transaction::bookHeldSeat(std::string_view flightNumber, const std::string& seatNumber)
+{
+    if (finished)
+    {
+        return false;
+    }
+
+    // The seat is already taken; it is claimed with the others on commit. Rolling back frees it.
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    int seatIndex = seatMap ? seatMap->seatIndex(seatNumber) : -1;
+    if (seatIndex < 0 || !SeatInventory::instance().isHeldSeat(flightNumber, seatIndex))
+    {
+        return false;
+    }
+
+    seatChanges.push_back({std::string(flightNumber), seatIndex, true});
+    operations.push_back({{"op", "bookSeat"}, {"flightNumber", flightNumber}, {"seatNumber", seatNumber}});
+    return true;
+}
+
+bool Transaction::changeSeat(std::string_view flightNumber, const std::string& seatNumber, bool book)
+{
+    if (finished)
+    {
+        return false;
+    }
+
+    SeatInventory &inventory = SeatInventory::instance();
+    auto seatMap = inventory.findSeatMap(flightNumber);
+    int seatIndex = seatMap ? seatMap->seatIndex(seatNumber) : -1;
+    if (seatIndex < 0)
+    {
+        return false;
+    }
+
+    if (book)
+    {
+        if (!inventory.holdSeat(flightNumber, seatIndex))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // Stays booked until the transaction is durable; only a sold seat can be released
+        bool releasing = std::any_of(seatChanges.begin(), seatChanges.end(), [&](const SeatChange& change)
+        {
+            return !change.booked && change.index == seatIndex && change.flightNumber == flightNumber;
+        });
+        if (releasing || !seatMap->isBooked(seatIndex) || inventory.isHeldSeat(flightNumber, seatIndex))
+        {
+            return false;
+        }
+    }
+
+    seatChanges.push_back({std::string(flightNumber), seatIndex, book});
+    operations.push_back({{"op", book ? "bookSeat" : "releaseSeat"}, {"flightNumber", flightNumber}, {"seatNumber", seatNumber}});
+    return true;
+}
+
+void Transaction::joinWaitlist(const WaitlistEntry& entry)
+{
+    operations.push_back({{"op", "waitlistAdd"}, {"entry", entry.toJson()}});
+}
+
+std::optional<WaitlistEntry> Transaction::claimFromWaitlist(std::string_view flightNumber, std::string_view cabinClass)
+{
+    if (finished)
+    {
+        return std::nullopt;
+    }
+
+    auto entry = Waitlist::instance().claimNext(flightNumber, cabinClass);
+    if (entry)
+    {
+        claimedEntries.push_back(*entry);
+        operations.push_back({{"op", "waitlistRemove"}, {"entryId", entry->entryId}});
+    }
+    return entry;
+}
+
+void Transaction::openOffer(const WaitlistOffer& offer)
+{
+    operations.push_back({{"op", "offerOpen"}, {"offer", offer.toJson()}});
+}
+
+std::optional<WaitlistOffer> Transaction::takeOffer(const std::string& entryId)
+{
+    if (finished)
+    {
+        return std::nullopt;
+    }
+
+    auto offer = Waitlist::instance().takeOffer(entryId);
+    if (offer)
+    {
+        takenOffers.push_back(*offer);
+        operations.push_back({{"op", "offerClose"}, {"entryId", entryId}});
+    }
+    return offer;
+}
+
+void Transaction::recordBooking(const Reservation& reservation)
+{
+    operations.push_back({{"op", "book"}, {"reservation", reservation.toJson()}});
+}
+
+void Transaction::recordBookings(const std::vector<Reservation>& group)
+{
+    nlohmann::json reservations = nlohmann::json::array();
+    for (const auto &reservation : group)
+    {
+        reservations.push_back(reservation.toJson());
+    }
+    operations.push_back({{"op", "bookGroup"}, {"reservations", std::move(reservations)}});
+}
+
+void Transaction::recordUpdate(const Reservation& reservation)
+{
+    operations.push_back({{"op", "update"}, {"reservation", reservation.toJson()}});
+}
+
+void Transaction::recordCancellation(const std::string& reservationId)
+{
+    operations.push_back({{"op", "cancel"}, {"reservationId", reservationId}});
+}
+
+bool Transaction::commit()
+{
+    if (finished)
+    {
+        return false;
+    }
+
+    if (!operations.empty())
+    {
+        // The manager claims the booked seats with the journal write: a seat another
+        // process sold fails the whole transaction
+        try
+        {
+            if (!TransactionManager::instance().commit(operations))
+            {
+                std::cerr << "Transaction failed: a seat was taken by another agent" << std::endl;
+                rollback();
+                return false;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Transaction failed: " << e.what() << std::endl;
+            rollback();
+            return false;
+        }
+    }
+
+    seatChanges.clear();
+    claimedEntries.clear();
+    takenOffers.clear();
+    finish();
+    return true;
+}
+
+void Transaction::rollback()
+{
+    if (finished)
+    {
+        return;
+    }
+
+    // Released seats were never freed; free the ones this transaction took
+    for (const auto &change : seatChanges)
+    {
+        if (change.booked)
+        {
+            SeatInventory::instance().releaseHeldSeat(change.flightNumber, change.index);
+        }
+    }
+    seatChanges.clear();
+    for (const auto &entry : claimedEntries)
+    {
+        Waitlist::instance().add(entry); // Back in line where it was
+    }
+    claimedEntries.clear();
+    for (const auto &offer : takenOffers)
+    {
+        Waitlist::instance().openOffer(offer); // Open again for the rest of its time
+    }
+    takenOffers.clear();
+    operations.clear();
+    finish();
+}
+
+void Transaction::finish()
+{
+    finished = true;
+    TransactionManager::instance().endTransaction();
+}
+
+
+TransactionManager::TransactionManager(const std::string& directory, const std::string& journalStem)
+    : journalFile(directory + "/" + journalStem + "-" + std::to_string(getpid()) + ".journal"),
+      journalId(std::to_string(getpid()) + "-" +
+                std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()))
+{
+    // The stores must exist before recovery and outlive the final checkpoint
+    SeatInventory::instance();
+    ReservationJournal::instance();
+    Waitlist::instance();
+
+    ownerLock = std::make_unique<FileLock>(JsonUtils::lockFileFor(journalFile));
+    openJournal();
+    recover(directory, journalStem);
+    worker = std::thread(&TransactionManager::backgroundLoop, this);
+}
+
+TransactionManager::~TransactionManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+
+    try
+    {
+        checkpoint();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Transaction journal error: " << e.what() << std::endl;
+    }
+    if (journal)
+    {
+        std::fclose(journal);
+        journal = nullptr;
+    }
+
+    // Everything is checkpointed; nothing is left to recover
+    std::error_code ec;
+    if (std::filesystem::file_size(journalFile, ec) == 0)
+    {
+        std::filesystem::remove(journalFile, ec);
+        std::filesystem::remove(JsonUtils::lockFileFor(journalFile), ec);
+    }
+}
+
+TransactionManager& TransactionManager::instance()
+{
+    static TransactionManager manager(journalDirectory, journalStem);
+    return manager;
+}
+
+bool TransactionManager::commit(const nlohmann::json& operations)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (broken)
+    {
+        throw std::runtime_error("Transaction journal unusable until the next checkpoint: " + journalFile);
+    }
+
+    // Claim the booked seats before the record goes out, so a seat another process sold
+    // fails the transaction while nothing is journaled yet
+    std::uint64_t sequence = appended + 1;
+    SeatChanges seats = collectSeats(operations);
+    if (!seats.booked.empty() && !SeatInventory::instance().claimSeats(seats.booked, journalId, sequence))
+    {
+        return false;
+    }
+
+    // The record and its commit line go out in one write; replay ignores a record without one
+    std::string lines = nlohmann::json{{"journal", journalId}, {"txn", sequence}, {"ops", operations}}.dump();
+    lines += "\n" + nlohmann::json{{"commit", sequence}}.dump() + "\n";
+    if (std::fwrite(lines.data(), 1, lines.size(), journal) != lines.size())
+    {
+        // Cut off whatever part of the record got written, once nobody is syncing the file
+        synced.wait(lock, [this] { return !syncing; });
+        truncateJournal(journalSize);
+        withdrawClaims(appended);
+        throw std::runtime_error("Failed to append to file: " + journalFile);
+    }
+    appended = sequence;
+    journalSize += lines.size();
+    sinceCheckpoint++;
+    const size_t cuts = cutBackTo.size();
+
+    // Group commit: whoever finds no sync running syncs for everyone written so far
+    while (durable < sequence || cutBackTo.size() > cuts)
+    {
+        if (cutBackTo.size() > cuts)
+        {
+            // A failed sync cut the journal back; our record went with it unless it was already durable
+            if (cutBackTo[cuts] < sequence)
+            {
+                throw std::runtime_error("Failed to sync file: " + journalFile);
+            }
+            break;
+        }
+        if (syncing)
+        {
+            synced.wait(lock);
+            continue;
+        }
+
+        syncing = true;
+        std::uint64_t target = appended;
+        std::uint64_t targetSize = journalSize;
+        lock.unlock();
+        try
+        {
+            // Claims first: a durable record must never find its claim lost
+            SeatInventory::instance().syncLog();
+            JsonUtils::syncFile(journal);
+        }
+        catch (...)
+        {
+            // Nothing past the last good sync is known to be on disk: drop it all, so
+            // no rolled-back transaction can be replayed later
+            lock.lock();
+            syncing = false;
+            cutBackTo.push_back(durable);
+            sinceCheckpoint -= static_cast<size_t>(appended - durable);
+            appended = durable;
+            truncateJournal(durableSize);
+            withdrawClaims(durable);
+            synced.notify_all();
+            throw;
+        }
+        lock.lock();
+        syncing = false;
+        durable = target;
+        durableSize = targetSize;
+        synced.notify_all();
+    }
+
+    if (sinceCheckpoint >= checkpointAfterTransactions || broken)
+    {
+        wakeUp.notify_one();
+    }
+
+    // Stores remember only the newest stamp of each journal, so apply in sequence order
+    appliedInOrder.wait(lock, [this, sequence] { return applied + 1 == sequence; });
+    lock.unlock();
+    bool seatsSettled = true;
+    try
+    {
+        if (!seats.empty())
+        {
+            SeatInventory::instance().commitSeats(TransactionStamp{journalId, sequence, 0}, seats.booked, seats.released);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        // The claims stay pending, so nobody else takes the seats; the checkpoint retries
+        std::cerr << "Error settling seats: " << e.what() << std::endl;
+        seatsSettled = false;
+    }
+    for (size_t index = 0; index < operations.size(); index++)
+    {
+        if (isSeatOperation(operations[index]))
+        {
+            continue; // Settled above
+        }
+        try
+        {
+            apply(operations[index], TransactionStamp{journalId, sequence, static_cast<std::uint32_t>(index)});
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error applying transaction: " << e.what() << std::endl;
+        }
+    }
+    lock.lock();
+    if (!seatsSettled)
+    {
+        unsettled.emplace_back(sequence, operations);
+    }
+    applied = sequence;
+    appliedInOrder.notify_all();
+    return true;
+}
+
+void TransactionManager::checkpoint()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !checkpointing; });
+    if (sinceCheckpoint == 0)
+    {
+        return;
+    }
+
+    // Keep new transactions out and wait for the open ones to finish
+    checkpointing = true;
+    idle.wait(lock, [this] { return openTransactions == 0; });
+
+    try
+    {
+        // Settle the seats a failed log write left pending and withdraw the claims of
+        // failed transactions an abort record couldn't reach
+        SeatInventory &inventory = SeatInventory::instance();
+        for (const auto &[sequence, operations] : unsettled)
+        {
+            SeatChanges seats = collectSeats(operations);
+            inventory.commitSeats(TransactionStamp{journalId, sequence, 0}, seats.booked, seats.released);
+        }
+        inventory.abortClaims(journalId, appended);
+
+        // Every journaled change is in memory; put it in the stores, then forget it
+        inventory.save();
+        unsettled.clear();
+        ReservationJournal::instance().flush();
+        Waitlist::instance().save();
+
+        if (journal)
+        {
+            std::fclose(journal);
+            journal = nullptr;
+        }
+        std::filesystem::resize_file(journalFile, 0);
+        openJournal();
+        sinceCheckpoint = 0;
+        broken = false;
+    }
+    catch (...)
+    {
+        if (!journal)
+        {
+            openJournal();
+        }
+        checkpointing = false;
+        idle.notify_all();
+        throw;
+    }
+
+    checkpointing = false;
+    idle.notify_all();
+}
+
+bool TransactionManager::isSeatOperation(const nlohmann::json& operation)
+{
+    const auto &op = operation.at("op").get_ref<const std::string&>();
+    return op == "bookSeat" || op == "releaseSeat";
+}
+
+bool TransactionManager::hasJournal(const std::string& journalId)
+{
+    // Journal IDs are "<pid>-<start time>" and the file is named by the pid
+    std::string pid = journalId.substr(0, journalId.find('-'));
+    std::error_code ec;
+    return std::filesystem::exists(std::string(journalDirectory) + "/" + journalStem + "-" + pid + ".journal", ec);
+}
+
+void TransactionManager::settleSeats(const nlohmann::json& operations, const std::optional<TransactionStamp>& stamp)
+{
+    SeatChanges seats = collectSeats(operations);
+    if (!seats.booked.empty() || !seats.released.empty())
+    {
+        SeatInventory::instance().commitSeats(stamp, seats.booked, seats.released);
+    }
+}
+
+void TransactionManager::apply(const nlohmann::json& operation, const std::optional<TransactionStamp>& stamp)
+{
+    const std::string op = operation.at("op").get<std::string>();
+
+    if (isSeatOperation(operation))
+    {
+        return; // Settled for the whole transaction at once (see settleSeats)
+    }
+
+    if (op == "book")
+    {
+        ReservationJournal::instance().recordBooking(Reservation::fromJson(operation.at("reservation")), stamp);
+    }
+    else if (op == "bookGroup")
+    {
+        std::vector<Reservation> group;
+        for (const auto &reservation : operation.at("reservations"))
+        {
+            group.push_back(Reservation::fromJson(reservation));
+        }
+        ReservationJournal::instance().recordBookings(group, stamp);
+    }
+    else if (op == "waitlistAdd")
+    {
+        Waitlist::instance().add(WaitlistEntry::fromJson(operation.at("entry")), stamp);
+    }
+    else if (op == "waitlistRemove")
+    {
+        // Claimed entries are already off the waitlist; replay takes them off again
+        Waitlist::instance().remove(operation.at("entryId").get<std::string>(), stamp);
+    }
+    else if (op == "offerOpen")
+    {
+        Waitlist::instance().openOffer(WaitlistOffer::fromJson(operation.at("offer")), stamp);
+    }
+    else if (op == "offerClose")
+    {
+        // Taken offers are already closed; replay closes them again
+        Waitlist::instance().closeOffer(operation.at("entryId").get<std::string>(), stamp);
+    }
+    else if (op == "update")
+    {
+        ReservationJournal::instance().recordUpdate(Reservation::fromJson(operation.at("reservation")), stamp);
+    }
+    else if (op == "cancel")
+    {
+        ReservationJournal::instance().recordCancellation(operation.at("reservationId").get<std::string>(), stamp);
+    }
+    else
+    {
+        throw std::runtime_error("Unknown transaction operation: " + op);
+    }
+}
+
+void TransactionManager::recover(const std::string& directory, const std::string& journalStem)
+{
+    // Our own journal is left over from an earlier process with the same ID.
+    // The others belong to running processes unless their lock can be taken.
+    size_t recovered = replay(journalFile);
+    std::error_code ec;
+    bool pending = std::filesystem::file_size(journalFile, ec) > 0;
+
+    std::vector<std::pair<std::string, std::unique_ptr<FileLock>>> abandoned;
+    std::set<std::string> deadPids = {std::to_string(getpid())};
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec))
+    {
+        std::string name = entry.path().filename().string();
+        std::string file = entry.path().string();
+        bool isJournal = name.rfind(journalStem, 0) == 0 && entry.path().extension() == ".journal";
+        if (!isJournal || std::filesystem::equivalent(file, journalFile, ec))
+        {
+            continue;
+        }
+        if (auto lock = FileLock::tryAcquire(JsonUtils::lockFileFor(file)))
+        {
+            recovered += replay(file);
+            pending = pending || std::filesystem::file_size(file, ec) > 0;
+            abandoned.emplace_back(file, std::move(lock));
+            deadPids.insert(entry.path().stem().string().substr(journalStem.size() + 1));
+        }
+    }
+
+    // Seats claimed by transactions that never got committed are free again, once every
+    // committed one is settled: claims of journals that are gone, that were just replayed,
+    // or that an earlier process with our pid left behind
+    try
+    {
+        SeatInventory::instance().abortDeadClaims([this, &deadPids](const std::string& journal)
+        {
+            return journal != journalId && (!hasJournal(journal) || deadPids.count(journal.substr(0, journal.find('-'))) > 0);
+        });
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error releasing abandoned seat claims: " << e.what() << std::endl;
+    }
+
+    if (pending)
+    {
+        // Write the recovered state to the stores and start an empty journal
+        std::cerr << "Recovered " << recovered << " transactions" << std::endl;
+        sinceCheckpoint = recovered > 0 ? recovered : 1;
+        checkpoint();
+    }
+
+    // Their transactions are in the stores now
+    for (auto &[file, lock] : abandoned)
+    {
+        std::filesystem::remove(file, ec);
+        std::filesystem::remove(JsonUtils::lockFileFor(file), ec);
+        lock.reset();
+    }
+}
+
+size_t TransactionManager::replay(const std::string& file)
+{
+    // Redo every transaction whose record is followed by its commit line, in order.
+    // Anything else (a torn write, or a record a failed append left behind) is skipped
+    // and the scan goes on, so it never hides the transactions after it.
+    std::ifstream in(file, std::ios::binary);
+    std::string line;
+    nlohmann::json pending;   // record waiting for its commit line
+    size_t recovered = 0;
+    size_t skipped = 0;
+    while (std::getline(in, line))
+    {
+        nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+        if (in.eof() || record.is_discarded() || !record.is_object())
+        {
+            skipped++; // No newline means the write was torn
+            continue;
+        }
+
+        if (record.contains("commit"))
+        {
+            if (pending.is_object() && pending.value("txn", std::uint64_t{0}) == record.value("commit", std::uint64_t{0}))
+            {
+                redo(pending);
+                recovered++;
+            }
+            else if (pending.is_object())
+            {
+                skipped++;
+            }
+            pending = nullptr;
+        }
+        else if (record.contains("ops"))
+        {
+            if (pending.is_object())
+            {
+                skipped++;
+            }
+            pending = nullptr;
+            if (record.contains("journal"))
+            {
+                pending = std::move(record);
+            }
+            else
+            {
+                redo(record); // Written before records had commit lines
+                recovered++;
+            }
+        }
+    }
+    if (pending.is_object())
+    {
+        skipped++;
+    }
+
+    if (skipped > 0)
+    {
+        std::cerr << "Skipped " << skipped << " uncommitted or incomplete records in " << file << std::endl;
+    }
+    return recovered;
+}
+
+void TransactionManager::redo(const nlohmann::json& record)
+{
+    // The seats are settled from the record like everything else. The stamps make the
+    // stores skip what they applied before the crash, so nothing newer is overwritten.
+    std::optional<TransactionStamp> stamp;
+    if (record.contains("journal"))
+    {
+        stamp = TransactionStamp{record.at("journal").get<std::string>(), record.at("txn").get<std::uint64_t>(), 0};
+    }
+    const nlohmann::json &operations = record.at("ops");
+    try
+    {
+        settleSeats(operations, stamp);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Skipping bad transaction record: " << e.what() << std::endl;
+    }
+    for (size_t index = 0; index < operations.size(); index++)
+    {
+        try
+        {
+            if (stamp)
+            {
+                apply(operations[index], TransactionStamp{stamp->journal, stamp->txn, static_cast<std::uint32_t>(index)});
+            }
+            else
+            {
+                apply(operations[index]);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Skipping bad transaction record: " << e.what() << std::endl;
+        }
+    }
+}
+
+void TransactionManager::openJournal()
+{
+    journal = std::fopen(journalFile.c_str(), "ab");
+    if (!journal)
+    {
+        throw std::runtime_error("Failed to open file: " + journalFile);
+    }
+    std::setvbuf(journal, nullptr, _IONBF, 0);
+
+    // Whatever the file already holds was synced by whoever wrote it
+    std::error_code ec;
+    journalSize = std::filesystem::file_size(journalFile, ec);
+    durableSize = journalSize;
+}
+
+void TransactionManager::truncateJournal(std::uint64_t size)
+{
+    if (journal)
+    {
+        std::fclose(journal);
+        journal = nullptr;
+    }
+    try
+    {
+        std::filesystem::resize_file(journalFile, size);
+        openJournal();
+        JsonUtils::syncFile(journal);
+    }
+    catch (const std::exception &e)
+    {
+        // The failed records may still be in the file; take no commits until a checkpoint empties it
+        std::cerr << "Transaction journal error: " << e.what() << std::endl;
+        broken = true;
+        sinceCheckpoint = std::max<size_t>(sinceCheckpoint, 1);
+    }
+}
+
+void TransactionManager::withdrawClaims(std::uint64_t afterTxn)
+{
+    try
+    {
+        SeatInventory::instance().abortClaims(journalId, afterTxn);
+    }
+    catch (const std::exception &e)
+    {
+        // Their sequence numbers will be used again; the checkpoint withdraws them first
+        std::cerr << "Error withdrawing seat claims: " << e.what() << std::endl;
+        broken = true;
+        sinceCheckpoint = std::max<size_t>(sinceCheckpoint, 1);
+    }
+}
+
+void TransactionManager::beginTransaction()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    // A checkpoint waiting for this thread's open transaction would wait forever for a
+    // nested one; it already can't start, so the nested one goes straight in
+    if (openOnThisThread == 0)
+    {
+        idle.wait(lock, [this] { return !checkpointing; });
+    }
+    openOnThisThread++;
+    openTransactions++;
+}
+
+void TransactionManager::endTransaction()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    openOnThisThread--;
+    if (--openTransactions == 0)
+    {
+        idle.notify_all();
+    }
+}
+
+void TransactionManager::backgroundLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        wakeUp.wait_for(lock, checkpointInterval, [this] { return stopping || sinceCheckpoint >= checkpointAfterTransactions; });
+        if (stopping || sinceCheckpoint == 0)
+        {
+            continue;
+        }
+
+        lock.unlock();
+        try
+        {
+            checkpoint();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Transaction journal error: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,67 @@
+#include "../../include/Booking/TransactionStamp.hpp"
+#include <algorithm>
+#include <iterator>
+
+nlohmann::json TransactionStamp::toJson() const
+{
+    return {{"journal", journal}, {"txn", txn}, {"index", index}};
+}
+
+TransactionStamp TransactionStamp::fromJson(const nlohmann::json& j)
+{
+    TransactionStamp stamp;
+    stamp.journal = j.at("journal").get<std::string>();
+    stamp.txn = j.at("txn").get<std::uint64_t>();
+    stamp.index = j.value("index", std::uint32_t{0});
+    return stamp;
+}
+
+
+bool AppliedTransactions::contains(const TransactionStamp& stamp) const
+{
+    auto found = newest.find(stamp.journal);
+    return found != newest.end() && std::make_pair(stamp.txn, stamp.index) <= found->second;
+}
+
+void AppliedTransactions::add(const TransactionStamp& stamp)
+{
+    auto &applied = newest[stamp.journal];
+    applied = std::max(applied, std::make_pair(stamp.txn, stamp.index));
+}
+
+void AppliedTransactions::merge(const AppliedTransactions& other)
+{
+    for (const auto &[journal, applied] : other.newest)
+    {
+        auto &ours = newest[journal];
+        ours = std::max(ours, applied);
+    }
+}
+
+void AppliedTransactions::prune(const std::function<bool(const std::string&)>& keep)
+{
+    for (auto it = newest.begin(); it != newest.end();)
+    {
+        it = keep(it->first) ? std::next(it) : newest.erase(it);
+    }
+}
+
+nlohmann::json AppliedTransactions::toJson() const
+{
+    nlohmann::json j = nlohmann::json::object();
+    for (const auto &[journal, applied] : newest)
+    {
+        j[journal] = {applied.first, applied.second};
+    }
+    return j;
+}
+
+AppliedTransactions AppliedTransactions::fromJson(const nlohmann::json& j)
+{
+    AppliedTransactions applied;
+    for (const auto &[journal, position] : j.items())
+    {
+        applied.newest[journal] = {position.at(0).get<std::uint64_t>(), position.at(1).get<std::uint32_t>()};
+    }
+    return applied;
+}
@@ -0,0 +1,476 @@
+#include "../../include/Booking/Waitlist.hpp"
+#include "../../include/Booking/TransactionManager.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+namespace
+{
+    constexpr std::string_view tierNames[] = {"None", "Silver", "Gold", "Platinum"};
+}
+
+std::string_view loyaltyTierName(LoyaltyTier tier)
+{
+    return tierNames[static_cast<int>(tier)];
+}
+
+LoyaltyTier parseLoyaltyTier(std::string_view name)
+{
+    for (int tier = 0; tier < static_cast<int>(std::size(tierNames)); tier++)
+    {
+        if (name.size() == tierNames[tier].size() &&
+            std::equal(name.begin(), name.end(), tierNames[tier].begin(),
+                       [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+        {
+            return static_cast<LoyaltyTier>(tier);
+        }
+    }
+    return LoyaltyTier::None;
+}
+
+LoyaltyTier loyaltyTierForPoints(int points)
+{
+    if (points >= 50000)
+    {
+        return LoyaltyTier::Platinum;
+    }
+    if (points >= 25000)
+    {
+        return LoyaltyTier::Gold;
+    }
+    return points >= 10000 ? LoyaltyTier::Silver : LoyaltyTier::None;
+}
+
+nlohmann::json WaitlistEntry::toJson() const
+{
+    return {{"entryId", entryId}, {"passengerId", passengerId}, {"passengerName", passengerName},
+            {"flightNumber", flightNumber}, {"cabinClass", cabinClass}, {"tier", loyaltyTierName(tier)},
+            {"requestedAt", requestedAt}};
+}
+
+WaitlistEntry WaitlistEntry::fromJson(const nlohmann::json& j)
+{
+    WaitlistEntry entry;
+    entry.entryId = j.at("entryId").get<std::string>();
+    entry.passengerId = j.at("passengerId").get<std::string>();
+    entry.passengerName = j.value("passengerName", "");
+    entry.flightNumber = j.at("flightNumber").get<std::string>();
+    entry.cabinClass = j.value("cabinClass", "");
+    entry.tier = parseLoyaltyTier(j.value("tier", "None"));
+    entry.requestedAt = j.value("requestedAt", std::int64_t{0});
+    return entry;
+}
+
+nlohmann::json WaitlistOffer::toJson() const
+{
+    return {{"entry", entry.toJson()}, {"seatNumber", seatNumber}, {"gate", gate}, {"boardingTime", boardingTime},
+            {"price", price}, {"expiresAt", expiresAt}};
+}
+
+WaitlistOffer WaitlistOffer::fromJson(const nlohmann::json& j)
+{
+    WaitlistOffer offer;
+    offer.entry = WaitlistEntry::fromJson(j.at("entry"));
+    offer.seatNumber = j.at("seatNumber").get<std::string>();
+    offer.gate = j.value("gate", "");
+    offer.boardingTime = j.value("boardingTime", "");
+    offer.price = j.value("price", 0.0);
+    offer.expiresAt = j.value("expiresAt", std::int64_t{0});
+    return offer;
+}
+
+
+Waitlist::Waitlist(const std::string& filename) : filename(filename)
+{
+    try
+    {
+        refresh();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error loading waitlist: " << e.what() << std::endl;
+    }
+}
+
+Waitlist& Waitlist::instance()
+{
+    static Waitlist waitlist("data/waitlist.json");
+    return waitlist;
+}
+
+Waitlist::QueueKey Waitlist::keyOf(const WaitlistEntry& entry)
+{
+    return {-static_cast<int>(entry.tier), entry.requestedAt, entry.entryId};
+}
+
+std::string Waitlist::passengerKey(std::string_view flightNumber, const std::string& passengerId)
+{
+    std::string key(flightNumber);
+    key.push_back(' ');
+    key += passengerId;
+    return key;
+}
+
+bool Waitlist::add(const WaitlistEntry& entry, const std::optional<TransactionStamp>& stamp)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !stampApplied(stamp) && insert(entry);
+}
+
+bool Waitlist::remove(const std::string& entryId, const std::optional<TransactionStamp>& stamp)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !stampApplied(stamp) && erase(entryId);
+}
+
+bool Waitlist::stampApplied(const std::optional<TransactionStamp>& stamp)
+{
+    // Expects the mutex to be held; records the stamp if it is new
+    if (!stamp)
+    {
+        return false;
+    }
+    if (applied.contains(*stamp))
+    {
+        return true;
+    }
+    applied.add(*stamp);
+    changed = true;
+    return false;
+}
+
+bool Waitlist::insert(const WaitlistEntry& entry)
+{
+    if (entries.count(entry.entryId) || !waitingPassengers.insert(passengerKey(entry.flightNumber, entry.passengerId)).second)
+    {
+        return false;
+    }
+    queues[entry.flightNumber][entry.cabinClass].insert(keyOf(entry));
+    entries.emplace(entry.entryId, entry);
+    changed = true;
+    return true;
+}
+
+bool Waitlist::erase(const std::string& entryId)
+{
+    auto found = entries.find(entryId);
+    if (found == entries.end())
+    {
+        return false;
+    }
+
+    const WaitlistEntry &entry = found->second;
+    auto flight = queues.find(entry.flightNumber);
+    auto queue = flight->second.find(entry.cabinClass);
+    queue->second.erase(keyOf(entry));
+    // Drop empty queues so flights that cleared their waitlist cost nothing
+    if (queue->second.empty())
+    {
+        flight->second.erase(queue);
+        if (flight->second.empty())
+        {
+            queues.erase(flight);
+        }
+    }
+    waitingPassengers.erase(passengerKey(entry.flightNumber, entry.passengerId));
+    entries.erase(found);
+    changed = true;
+    return true;
+}
+
+std::optional<WaitlistEntry> Waitlist::claimNext(std::string_view flightNumber, std::string_view cabinClass)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto flight = queues.find(flightNumber);
+    if (flight == queues.end())
+    {
+        return std::nullopt;
+    }
+
+    // The better of the heads of the class's own queue and the any-class queue
+    const QueueKey *next = nullptr;
+    for (std::string_view wanted : {cabinClass, std::string_view()})
+    {
+        auto queue = flight->second.find(wanted);
+        if (queue != flight->second.end() && (!next || *queue->second.begin() < *next))
+        {
+            next = &*queue->second.begin();
+        }
+        if (wanted.empty())
+        {
+            break;
+        }
+    }
+    if (!next)
+    {
+        return std::nullopt;
+    }
+
+    std::string entryId = next->entryId;
+    WaitlistEntry entry = entries.at(entryId);
+    erase(entryId);
+    return entry;
+}
+
+bool Waitlist::isWaiting(std::string_view flightNumber, const std::string& passengerId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return waitingPassengers.count(passengerKey(flightNumber, passengerId)) > 0;
+}
+
+std::vector<WaitlistEntry> Waitlist::getEntries(std::string_view flightNumber) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<WaitlistEntry> flightEntries;
+    auto flight = queues.find(flightNumber);
+    if (flight == queues.end())
+    {
+        return flightEntries;
+    }
+
+    std::vector<const QueueKey*> keys;
+    for (const auto &[cabinClass, queue] : flight->second)
+    {
+        for (const auto &key : queue)
+        {
+            keys.push_back(&key);
+        }
+    }
+    std::sort(keys.begin(), keys.end(), [](const QueueKey *a, const QueueKey *b) { return *a < *b; });
+    for (const QueueKey *key : keys)
+    {
+        flightEntries.push_back(entries.at(key->entryId));
+    }
+    return flightEntries;
+}
+
+size_t Waitlist::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+bool Waitlist::openOffer(const WaitlistOffer& offer, const std::optional<TransactionStamp>& stamp)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stampApplied(stamp) || !offers.emplace(offer.entry.entryId, offer).second)
+    {
+        return false;
+    }
+    changed = true;
+    return true;
+}
+
+bool Waitlist::closeOffer(const std::string& entryId, const std::optional<TransactionStamp>& stamp)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stampApplied(stamp) || !offers.erase(entryId))
+    {
+        return false;
+    }
+    changed = true;
+    return true;
+}
+
+std::optional<WaitlistOffer> Waitlist::takeOffer(const std::string& entryId)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto open = offers.find(entryId);
+    if (open == offers.end())
+    {
+        return std::nullopt;
+    }
+    WaitlistOffer offer = std::move(open->second);
+    offers.erase(open);
+    changed = true;
+    return offer;
+}
+
+std::vector<WaitlistOffer> Waitlist::getOffers(const std::string& passengerId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<WaitlistOffer> passengerOffers;
+    for (const auto &[entryId, offer] : offers)
+    {
+        if (offer.entry.passengerId == passengerId)
+        {
+            passengerOffers.push_back(offer);
+        }
+    }
+    return passengerOffers;
+}
+
+std::vector<std::string> Waitlist::getExpiredOffers(std::int64_t now) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> expired;
+    for (const auto &[entryId, offer] : offers)
+    {
+        if (offer.expiresAt <= now)
+        {
+            expired.push_back(entryId);
+        }
+    }
+    return expired;
+}
+
+void Waitlist::save()
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    {
+        std::lock_guard<std::mutex> entriesLock(mutex);
+        if (!changed)
+        {
+            return; // The file already holds what we have
+        }
+    }
+
+    FileLock lock(JsonUtils::lockFileFor(filename));
+    if (JsonUtils::getFileVersion(filename) != syncedVersion)
+    {
+        mergeFromFile(); // Don't overwrite what another process saved meanwhile
+    }
+
+    nlohmann::json data = nlohmann::json::array();
+    nlohmann::json openOffers = nlohmann::json::array();
+    std::unordered_set<std::string> written, writtenOffers;
+    AppliedTransactions stamps;
+    {
+        std::lock_guard<std::mutex> entriesLock(mutex);
+        changed = false;
+        stamps = applied;
+        for (const auto &[flightNumber, classQueues] : queues)
+        {
+            for (const auto &[cabinClass, queue] : classQueues)
+            {
+                for (const auto &key : queue)
+                {
+                    data.push_back(entries.at(key.entryId).toJson());
+                    written.insert(key.entryId);
+                }
+            }
+        }
+        for (const auto &[entryId, offer] : offers)
+        {
+            openOffers.push_back(offer.toJson());
+            writtenOffers.insert(entryId);
+        }
+    }
+
+    // Only stamps of intent journals that may still be replayed are worth keeping
+    stamps.prune(TransactionManager::hasJournal);
+    nlohmann::json file = {{"applied", stamps.toJson()}, {"entries", std::move(data)}, {"offers", std::move(openOffers)}};
+    JsonUtils::writeFileAtomically(filename, file.dump(4));
+    syncedIds = std::move(written);
+    syncedOfferIds = std::move(writtenOffers);
+    syncedVersion = JsonUtils::getFileVersion(filename);
+}
+
+void Waitlist::refresh()
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    if (JsonUtils::getFileVersion(filename) == syncedVersion)
+    {
+        return; // Nobody saved since we last synced
+    }
+
+    try
+    {
+        FileLock lock(JsonUtils::lockFileFor(filename), FileLock::Mode::Shared);
+        mergeFromFile();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error reloading waitlist: " << e.what() << std::endl;
+    }
+}
+
+std::unordered_map<std::string, WaitlistEntry> Waitlist::readFile(AppliedTransactions& fileApplied,
+                                                                  std::unordered_map<std::string, WaitlistOffer>& fileOffers) const
+{
+    std::unordered_map<std::string, WaitlistEntry> fileEntries;
+    std::error_code ec;
+    if (!std::filesystem::exists(filename, ec))
+    {
+        return fileEntries;
+    }
+
+    // Files written before stamps were kept are a bare array of entries
+    nlohmann::json file = JsonUtils::readJsonFromFile(filename);
+    if (file.is_object())
+    {
+        fileApplied = AppliedTransactions::fromJson(file.value("applied", nlohmann::json::object()));
+        for (const auto &item : file.value("offers", nlohmann::json::array()))
+        {
+            WaitlistOffer offer = WaitlistOffer::fromJson(item);
+            fileOffers.emplace(offer.entry.entryId, std::move(offer));
+        }
+    }
+    for (const auto &item : file.is_object() ? file.at("entries") : file)
+    {
+        WaitlistEntry entry = WaitlistEntry::fromJson(item);
+        fileEntries.emplace(entry.entryId, std::move(entry));
+    }
+    return fileEntries;
+}
+
+void Waitlist::mergeFromFile()
+{
+    // Caller holds fileMutex and the file lock
+    auto version = JsonUtils::getFileVersion(filename);
+    AppliedTransactions fileApplied;
+    std::unordered_map<std::string, WaitlistOffer> fileOffers;
+    auto fileEntries = readFile(fileApplied, fileOffers);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    bool hadChanges = changed;
+    applied.merge(fileApplied);
+
+    // Entries we had synced that are gone from the file were removed elsewhere
+    std::vector<std::string> removed;
+    for (const auto &entryId : syncedIds)
+    {
+        if (!fileEntries.count(entryId))
+        {
+            removed.push_back(entryId);
+        }
+    }
+    for (const auto &entryId : removed)
+    {
+        erase(entryId);
+    }
+
+    // New entries were added elsewhere, unless we removed them ourselves since the last sync
+    std::unordered_set<std::string> fileIds;
+    for (const auto &[entryId, entry] : fileEntries)
+    {
+        if (!syncedIds.count(entryId))
+        {
+            insert(entry);
+        }
+        fileIds.insert(entryId);
+    }
+
+    // Offers merge the same way
+    for (const auto &entryId : syncedOfferIds)
+    {
+        if (!fileOffers.count(entryId))
+        {
+            offers.erase(entryId);
+        }
+    }
+    std::unordered_set<std::string> fileOfferIds;
+    for (auto &[entryId, offer] : fileOffers)
+    {
+        if (!syncedOfferIds.count(entryId))
+        {
+            offers.emplace(entryId, std::move(offer));
+        }
+        fileOfferIds.insert(entryId);
+    }
+
+    syncedIds = std::move(fileIds);
+    syncedOfferIds = std::move(fileOfferIds);
+    syncedVersion = version;
+    changed = hadChanges; // Taking in the file's entries isn't a change of ours
+}
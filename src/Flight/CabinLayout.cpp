@@ -0,0 +1,110 @@
+#include "../../include/Flight/CabinLayout.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    // Cabins of the aircraft types the airline flies. Row 13 is left out where the
+    // operator does, and letters follow the manufacturer (no I on wide bodies).
+    constexpr CabinLayout boeing737("Boeing 737", "ABCDEF", "C", {{"Business", 4}, {"Economy", 26}}, {13});
+    constexpr CabinLayout airbusA320("Airbus A320", "ABCDEF", "C", {{"Business", 3}, {"Economy", 27}}, {13});
+    constexpr CabinLayout boeing777("Boeing 777", "ABCDEFGHJK", "CG", {{"Business", 5}, {"Premium Economy", 4}, {"Economy", 33}}, {13});
+    constexpr CabinLayout boeing747("Boeing 747", "ABCDEFGHJK", "CG", {{"Business", 6}, {"Economy", 40}}, {13});
+    constexpr CabinLayout airbusA350("Airbus A350", "ABCDEFHJK", "CF", {{"Business", 8}, {"Economy", 30}});
+    constexpr CabinLayout embraerE175("Embraer E175", "ACDF", "C", {{"First", 3}, {"Economy", 16}});
+
+    constexpr const CabinLayout* templates[] = {&boeing737, &airbusA320, &boeing777, &boeing747, &airbusA350, &embraerE175};
+
+    // The tables are worked out at compile time
+    static_assert(boeing737.getSeatCount() == 180);
+    static_assert(boeing737.seatIndex("12F") == 11 * 6 + 5 && boeing737.seatIndex("14A") == 12 * 6);
+    static_assert(boeing737.seatIndex("13A") == -1 && boeing737.seatIndex("31A") == 29 * 6 && boeing737.seatIndex("32A") == -1);
+    static_assert(boeing777.seatIndex("1K") == 9 && boeing777.seatIndex("1I") == -1);
+    static_assert(embraerE175.seatIndex("2c") == 4 + 1 && embraerE175.seatIndex("1B") == -1);
+}
+
+std::string CabinLayout::seatLabel(int index) const
+{
+    return std::to_string(rowNumbers[index / cols]) + letters[index % cols];
+}
+
+std::string_view CabinLayout::cabinClassOf(int row) const
+{
+    for (int i = 0; i < classCount; i++)
+    {
+        if (row < classes[i].rows)
+        {
+            return classes[i].name;
+        }
+        row -= classes[i].rows;
+    }
+    return {};
+}
+
+std::pair<int, int> CabinLayout::rowsOfClass(std::string_view className) const
+{
+    int first = 0;
+    for (int i = 0; i < classCount; i++)
+    {
+        if (classes[i].name == className)
+        {
+            return {first, first + classes[i].rows};
+        }
+        first += classes[i].rows;
+    }
+    return {0, 0};
+}
+
+const CabinLayout* CabinLayout::find(std::string_view aircraftType)
+{
+    for (const CabinLayout *layout : templates)
+    {
+        if (layout->name == aircraftType)
+        {
+            return layout;
+        }
+    }
+    return nullptr;
+}
+
+const CabinLayout& CabinLayout::standard(int rows, int cols)
+{
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::unique_ptr<CabinLayout>> layouts; // stable addresses for SeatMaps
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &layout = layouts[{rows, cols}];
+    if (!layout)
+    {
+        if (cols <= 0 || cols > maxColumns)
+        {
+            throw std::invalid_argument("Invalid cabin width");
+        }
+
+        // One aisle in the middle (3-3 for six abreast) up to six abreast, then two with
+        // the outer sections as wide as possible without outgrowing the middle one (2-3-2, 3-4-3)
+        static constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        std::string aisles;
+        if (cols > 6)
+        {
+            int outer = cols / 3;
+            aisles = {alphabet[outer - 1], alphabet[cols - outer - 1]};
+        }
+        else if (cols > 3)
+        {
+            aisles = {alphabet[(cols + 1) / 2 - 1]};
+        }
+        layout = std::make_unique<CabinLayout>("", alphabet.substr(0, cols), aisles, std::initializer_list<CabinClass>{{"Economy", rows}});
+    }
+    return *layout;
+}
+
+const CabinLayout& CabinLayout::forAircraft(std::string_view aircraftType, int capacity)
+{
+    if (const CabinLayout *layout = find(aircraftType))
+    {
+        return *layout;
+    }
+    return standard(capacity / 6, 6);
+}
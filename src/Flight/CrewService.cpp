@@ -1,5 +1,16 @@
 #include "../../include/Flight/CrewService.hpp"
 
+namespace
+{
+    // Compare against the stored strings in place instead of building a json per element
+    bool isAssignedTo(const nlohmann::json &crewMember, const std::string &flightNumber)
+    {
+        const auto &assignedFlights = crewMember["assignedFlights"];
+        return std::any_of(assignedFlights.begin(), assignedFlights.end(), [&flightNumber](const nlohmann::json &assigned)
+                           { return assigned.is_string() && assigned.get_ref<const std::string &>() == flightNumber; });
+    }
+}
+
 CrewService::CrewService(const std::string &crewFilePath) : crewFilePath(crewFilePath)
 {
     loadCrewData();
@@ -17,6 +28,10 @@ void CrewService::saveCrewData()
 
 void CrewService::assignCrewToFlight(const std::string &flightNumber, Flight &flight)
 {
+    // Assign from the latest saved crew list and save before another process can change it
+    FileLock lock(JsonUtils::lockFileFor(crewFilePath));
+    loadCrewData();
+
     auto flightDuration = flight.getDuration();
     assignPilot(flightNumber, flight, flightDuration);
     assignFlightAttendants(flightNumber, flight, flightDuration);
@@ -74,8 +89,7 @@ bool CrewService::isPilotAssigned(const std::string &flightNumber) const
 {
     for (const auto &pilot : crewData["pilots"])
     {
-        auto assignedFlights = pilot["assignedFlights"];
-        if (std::find(assignedFlights.begin(), assignedFlights.end(), flightNumber) != assignedFlights.end())
+        if (isAssignedTo(pilot, flightNumber))
         {
             return true; // Pilot is already assigned to the flight
         }
@@ -140,8 +154,7 @@ std::vector<std::shared_ptr<Crew>> CrewService::getCrewForFlight(const std::stri
     // Search for pilot
     for (const auto &pilot : crewData["pilots"])
     {
-        auto assignedFlights = pilot["assignedFlights"];
-        if (std::find(assignedFlights.begin(), assignedFlights.end(), flightNumber) != assignedFlights.end())
+        if (isAssignedTo(pilot, flightNumber))
         {
             crewMembers.push_back(std::make_shared<Crew>(
                 pilot["id"], pilot["name"], "Pilot"));
@@ -151,8 +164,7 @@ std::vector<std::shared_ptr<Crew>> CrewService::getCrewForFlight(const std::stri
     // Search for flight attendants
     for (const auto &fa : crewData["flight_attendants"])
     {
-        auto assignedFlights = fa["assignedFlights"];
-        if (std::find(assignedFlights.begin(), assignedFlights.end(), flightNumber) != assignedFlights.end())
+        if (isAssignedTo(fa, flightNumber))
         {
             crewMembers.push_back(std::make_shared<Crew>(
                 fa["id"], fa["name"], "Flight Attendant"));
@@ -0,0 +1,245 @@
+#include "../../include/Flight/FlightCatalog.hpp"
+#include "../../include/Utils/Snapshot.hpp"
+
+FlightCatalog::FlightCatalog(const std::string& filename)
+    : filename(filename), lockFilename(JsonUtils::lockFileFor(filename)), schedule(std::make_shared<const Schedule>()) {}
+
+FlightCatalog& FlightCatalog::instance()
+{
+    static FlightCatalog catalog("data/flights.json");
+    return catalog;
+}
+
+FlightCatalog::FlightList FlightCatalog::getFlights()
+{
+    auto snapshot = current();
+    return FlightList(snapshot, &snapshot->flights);
+}
+
+FlightCatalog::FlightHandle FlightCatalog::findFlight(std::string_view flightNumber)
+{
+    auto snapshot = current();
+    auto symbol = Symbol::find(flightNumber);
+    if (!symbol)
+    {
+        return nullptr; // Never seen, so no flight can have it
+    }
+    auto it = snapshot->flightsByNumber.find(*symbol);
+    return it != snapshot->flightsByNumber.end() ? it->second : nullptr;
+}
+
+FlightCatalog::FlightList FlightCatalog::findFlightsByRoute(const std::string& origin, const std::string& destination,
+                                                            const std::string& departureDate)
+{
+    static const std::vector<FlightHandle> noFlights;
+
+    auto snapshot = current();
+    std::int64_t departureDay = Timestamp::parseDay(departureDate);
+    auto originSymbol = Symbol::find(origin);
+    auto destinationSymbol = Symbol::find(destination);
+    if (departureDay == Timestamp::invalid || !originSymbol || !destinationSymbol)
+    {
+        return FlightList(snapshot, &noFlights);
+    }
+
+    // The list shares ownership of the schedule it belongs to
+    auto it = snapshot->flightsByRoute.find(RouteKey{*originSymbol, *destinationSymbol, departureDay});
+    return FlightList(snapshot, it != snapshot->flightsByRoute.end() ? &it->second : &noFlights);
+}
+
+std::shared_ptr<const FlightCatalog::Schedule> FlightCatalog::current()
+{
+    // A stat and a few bytes of the lock file; the schedule is only parsed after a save
+    auto version = JsonUtils::getFileVersion(filename, lockFilename);
+    {
+        std::shared_lock<std::shared_mutex> guard(mutex);
+        if (loaded && version == loadedVersion)
+        {
+            return schedule; // Resident copy is up to date
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> guard(mutex);
+    reloadIfChanged(); // Another thread may have reloaded meanwhile
+    return schedule;
+}
+
+template <typename Change>
+bool FlightCatalog::modify(Change change)
+{
+    // Apply the change to a copy of the latest saved schedule and save before anyone else can.
+    // Readers keep whichever schedule they already hold.
+    std::unique_lock<std::shared_mutex> guard(mutex);
+    FileLock lock(lockFilename);
+    reloadIfChanged();
+    auto changed = std::make_shared<Schedule>(*schedule);
+    if (!change(*changed))
+    {
+        return false;
+    }
+    saveSchedule(*changed);
+    schedule = std::move(changed);
+    return true;
+}
+
+bool FlightCatalog::addFlight(const Flight& flight)
+{
+    return modify([&](Schedule& changed)
+    {
+        if (changed.flightsByNumber.count(flight.getFlightNumberSymbol()))
+        {
+            return false; // Flight numbers are unique
+        }
+
+        FlightHandle entry = std::make_shared<const Flight>(flight);
+        changed.flights.push_back(entry);
+        changed.flightsByNumber.emplace(entry->getFlightNumberSymbol(), entry);
+        changed.indexRoute(entry);
+        return true;
+    });
+}
+
+bool FlightCatalog::updateFlight(std::string_view flightNumber, const Flight& updatedFlight)
+{
+    return modify([&](Schedule& changed)
+    {
+        auto symbol = Symbol::find(flightNumber);
+        auto it = symbol ? changed.flightsByNumber.find(*symbol) : changed.flightsByNumber.end();
+        if (it == changed.flightsByNumber.end())
+        {
+            return false;
+        }
+
+        bool renamed = updatedFlight.getFlightNumberSymbol() != *symbol;
+        if (renamed && changed.flightsByNumber.count(updatedFlight.getFlightNumberSymbol()))
+        {
+            return false; // Flight numbers are unique
+        }
+
+        // A new entry in the old one's place; holders of the old one keep their copy
+        FlightHandle old = it->second;
+        FlightHandle entry = std::make_shared<const Flight>(updatedFlight);
+        changed.unindexRoute(old);
+        changed.flightsByNumber.erase(it);
+        changed.flightsByNumber[entry->getFlightNumberSymbol()] = entry;
+        std::replace(changed.flights.begin(), changed.flights.end(), old, entry);
+        changed.indexRoute(entry);
+        return true;
+    });
+}
+
+bool FlightCatalog::removeFlight(std::string_view flightNumber)
+{
+    return modify([&](Schedule& changed)
+    {
+        auto symbol = Symbol::find(flightNumber);
+        auto it = symbol ? changed.flightsByNumber.find(*symbol) : changed.flightsByNumber.end();
+        if (it == changed.flightsByNumber.end())
+        {
+            return false;
+        }
+
+        FlightHandle entry = it->second;
+        changed.unindexRoute(entry);
+        changed.flightsByNumber.erase(it);
+        changed.flights.erase(std::remove(changed.flights.begin(), changed.flights.end(), entry), changed.flights.end());
+        return true;
+    });
+}
+
+void FlightCatalog::save()
+{
+    std::unique_lock<std::shared_mutex> guard(mutex);
+    saveSchedule(*schedule);
+}
+
+void FlightCatalog::saveSchedule(const Schedule& toSave)
+{
+    nlohmann::json flightsJson = nlohmann::json::array();
+    for (const auto &flight : toSave.flights)
+    {
+        // The stored seat count is only a snapshot of the flight's seat map
+        nlohmann::json flightJson = flight->toJson();
+        if (auto seatMap = SeatInventory::instance().findSeatMap(flight->getFlightNumber()))
+        {
+            flightJson["availableSeats"] = seatMap->getAvailableCount();
+        }
+        flightsJson.push_back(std::move(flightJson));
+    }
+    FileLock lock(lockFilename);
+    JsonUtils::saveJsonToFile(flightsJson, filename);
+
+    // Our own write must not trigger a reload
+    loadedVersion = JsonUtils::getFileVersion(filename, lockFilename);
+}
+
+void FlightCatalog::reloadIfChanged()
+{
+    // Called with the mutex held exclusively
+    auto version = JsonUtils::getFileVersion(filename, lockFilename);
+    if (loaded && version == loadedVersion)
+    {
+        return; // Resident copy is up to date
+    }
+
+    try
+    {
+        // Parse under the shared lock and take the version of exactly what was read
+        FileLock lock(lockFilename, FileLock::Mode::Shared);
+        loadFlightsFromJson();
+        loadedVersion = JsonUtils::getFileVersion(filename, lockFilename);
+        loaded = true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error loading flights from file: " << e.what() << std::endl;
+    }
+}
+
+void FlightCatalog::loadFlightsFromJson()
+{
+    // Flights are built while the file is parsed, no document is kept
+    schedule = rebuild(Snapshot::loadEntities<Flight>(filename));
+}
+
+std::shared_ptr<const FlightCatalog::Schedule> FlightCatalog::rebuild(std::vector<Flight>&& newFlights)
+{
+    auto rebuilt = std::make_shared<Schedule>();
+    rebuilt->flights.reserve(newFlights.size());
+    rebuilt->flightsByNumber.reserve(newFlights.size());
+
+    for (auto &flight : newFlights)
+    {
+        if (rebuilt->flightsByNumber.count(flight.getFlightNumberSymbol()))
+        {
+            continue; // Flight numbers are unique, keep the first entry
+        }
+
+        FlightHandle entry = std::make_shared<const Flight>(std::move(flight));
+        rebuilt->flightsByNumber.emplace(entry->getFlightNumberSymbol(), entry);
+        rebuilt->flights.push_back(entry);
+        rebuilt->indexRoute(entry);
+    }
+    return rebuilt;
+}
+
+void FlightCatalog::Schedule::indexRoute(const FlightHandle& flight)
+{
+    flightsByRoute[RouteKey{flight->getOriginSymbol(), flight->getDestinationSymbol(), flight->getDepartureDay()}].push_back(flight);
+}
+
+void FlightCatalog::Schedule::unindexRoute(const FlightHandle& flight)
+{
+    auto it = flightsByRoute.find(RouteKey{flight->getOriginSymbol(), flight->getDestinationSymbol(), flight->getDepartureDay()});
+    if (it == flightsByRoute.end())
+    {
+        return;
+    }
+
+    auto &routeFlights = it->second;
+    routeFlights.erase(std::remove(routeFlights.begin(), routeFlights.end(), flight), routeFlights.end());
+    if (routeFlights.empty())
+    {
+        flightsByRoute.erase(it);
+    }
+}
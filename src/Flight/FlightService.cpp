@@ -1,28 +1,31 @@
 #include "../../include/Flight/FlightService.hpp"
+#include "../../include/Booking/TransactionManager.hpp"
 
-std::vector<Flight> FlightService::getFlights() const 
+FlightCatalog::FlightList FlightService::getFlights() const 
 {
-    return loadFlightsFromJson("data/flights.json");
+    return FlightCatalog::instance().getFlights();
 }
 
 
 void FlightService::displayFlights() const
 {
-    std::vector<Flight> flights = getFlights();
+    auto flights = getFlights();
+    SeatInventory::instance().refresh(); // Pick up seats booked by other agents
 
-    if (flights.empty())
+    if (flights->empty())
     {
         std::cout << "No flights available." << std::endl;
         return;
     }
 
-    for (const auto &flight : flights)
+    for (const auto &flightEntry : *flights)
     {
+        const Flight &flight = *flightEntry;
         std::cout << "Flight Number: " << flight.getFlightNumber() << std::endl;
         std::cout << "Departure: "  << flight.getDepartureDateAndTime() << std::endl;
         std::cout << "Arrival: " << flight.getArrivalDate() << std::endl;
         std::cout << "Aircraft: " << flight.getAircraftType() << std::endl;
-        std::cout << "Available Seats: " << flight.getAvailableSeats() << std::endl;
+        std::cout << "Available Seats: " << getAvailableSeats(flight) << std::endl;
         std::cout << "Price: $" << std::fixed << std::setprecision(2) << flight.getPrice() << std::endl;
         std::cout << "-------------------------" << std::endl;
     }
@@ -32,9 +35,10 @@ void FlightService::displayFlights() const
 void FlightService::searchFlights(const std::string &origin, const std::string &destination, const std::string &departureDate) const
 {
     Utils::clearScreen();
-    std::vector<Flight> flights = getFlights();
+    auto flights = getFlights();
+    SeatInventory::instance().refresh(); // Pick up seats booked by other agents
 
-    if (flights.empty())
+    if (flights->empty())
     {
         std::cout << "No flights available" << std::endl;
         return;
@@ -45,19 +49,19 @@ void FlightService::searchFlights(const std::string &origin, const std::string &
 
     std::cout << "Available Flights:" << std::endl;
 
-    for (const auto &flight : flights)
+    // Only the flights on this route and day are visited
+    auto matchingFlights = FlightCatalog::instance().findFlightsByRoute(origin, destination, departureDate);
+    for (const auto &flightEntry : *matchingFlights)
     {
-        if (flight.getOrigin() == origin && flight.getDestination() == destination && flight.getDepartureDate() == departureDate)
-        {
-            std::cout << ++count << ". " << "Flight Number: " << flight.getFlightNumber() << std::endl;
-            std::cout << "\tDeparture: " << flight.getDepartureDate() << " " << flight.getDepartureDateAndTime() << std::endl;
-            std::cout << "\tArrival: " << flight.getArrivalDate() << " " << flight.getArrivalDate() << std::endl;
-            std::cout << "\tAircraft: " << flight.getAircraftType() << std::endl;
-            std::cout << "\tAvailable Seats: " << flight.getAvailableSeats() << std::endl;
-            std::cout << "\tPrice: $" << std::fixed << std::setprecision(2) << flight.getPrice() << std::endl;
-            std::cout << "-------------------------" << std::endl;
-            flightsFound = true;
-        }
+        const Flight &flight = *flightEntry;
+        std::cout << ++count << ". " << "Flight Number: " << flight.getFlightNumber() << std::endl;
+        std::cout << "\tDeparture: " << flight.getDepartureDate() << " " << flight.getDepartureDateAndTime() << std::endl;
+        std::cout << "\tArrival: " << flight.getArrivalDate() << " " << flight.getArrivalDate() << std::endl;
+        std::cout << "\tAircraft: " << flight.getAircraftType() << std::endl;
+        std::cout << "\tAvailable Seats: " << getAvailableSeats(flight) << std::endl;
+        std::cout << "\tPrice: $" << std::fixed << std::setprecision(2) << flight.getPrice() << std::endl;
+        std::cout << "-------------------------" << std::endl;
+        flightsFound = true;
     }
     if(flightsFound == false)
     {
@@ -65,13 +69,14 @@ void FlightService::searchFlights(const std::string &origin, const std::string &
         std::cout << "The available flights are:\n " << std::endl;
 
         //Display all flights instead
-        for (const auto &flight : flights)
+        for (const auto &flightEntry : *flights)
         {
+            const Flight &flight = *flightEntry;
             std::cout << "Flight Number: " << flight.getFlightNumber() << std::endl;
             std::cout << "Departure: " << flight.getDepartureDate() << " " << flight.getDepartureDateAndTime() << std::endl;
             std::cout << "Arrival: " << flight.getArrivalDate() << " " << flight.getArrivalDate() << std::endl;
             std::cout << "Aircraft: " << flight.getAircraftType() << std::endl;
-            std::cout << "Available Seats: " << flight.getAvailableSeats() << std::endl;
+            std::cout << "Available Seats: " << getAvailableSeats(flight) << std::endl;
             std::cout << "Price: $" << std::fixed << std::setprecision(2) << flight.getPrice() << std::endl;
             std::cout << "-------------------------" << std::endl;
         }
@@ -79,182 +84,206 @@ void FlightService::searchFlights(const std::string &origin, const std::string &
 }
 
 
-void FlightService::displayAvailableSeats(const std::string& flightNumber) const
+void FlightService::displayAvailableSeats(std::string_view flightNumber) const
 {
-    // Read seat data from JSON
-    nlohmann::json flights;
-    std::ifstream file("data/seats.json");
-    if (file.good())
-    {
-        file >> flights;
-        file.close();
-    }
-
-    if (!flights.contains(flightNumber))
+    SeatInventory::instance().refresh();
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    if (!seatMap)
     {
         std::cout << "Flight not found.\n";
         return;
     }
 
     std::cout << "--- Seat Map for Flight " << flightNumber << " (AVL: Available, BKD: booked) ---\n";
-    int rows = flights[flightNumber]["rows"];
-    int cols = flights[flightNumber]["cols"];
-    std::map<int, char> colMap = {{0, 'A'}, {1, 'B'}, {2, 'C'}, {3, 'D'}, {4, 'E'}, {5, 'F'}};
+    const CabinLayout &layout = seatMap->getLayout();
+    int rows = seatMap->getRows();
+    int cols = seatMap->getCols();
 
-    for (int row = 1; row <= rows; ++row)
+    std::string_view cabinClass;
+    for (int row = 0; row < rows; ++row)
     {
+        if (layout.cabinClassOf(row) != cabinClass)
+        {
+            cabinClass = layout.cabinClassOf(row);
+            std::cout << "[" << cabinClass << "]\n";
+        }
+
+        std::string rowNumber = std::to_string(layout.rowNumber(row));
         for (int col = 0; col < cols; ++col)
         {
-            std::string seat = std::to_string(row) + colMap[col];
-            std::cout << seat << (flights[flightNumber]["seats"][seat] == "available" ? " [AVL] " : " [BKD] ");
+            std::cout << rowNumber << layout.columnLetter(col) << (seatMap->isBooked(row * cols + col) ? " [BKD] " : " [AVL] ");
+            if (layout.hasAisleAfter(col))
+            {
+                std::cout << "   "; // Aisle
+            }
         }
         std::cout << "\n";
     }
 }
 
 
-bool FlightService::markSeatAsBooked(const std::string& flightNumber, const std::string& seatNumber)
+std::optional<SeatHold> FlightService::holdSeat(std::string_view flightNumber, const std::string& seatNumber)
 {
-    // Read the seats data from seats.json
-    nlohmann::json seatsData;
-    try {
-        seatsData = JsonUtils::readJsonFromFile("data/seats.json");
-    } catch (const std::runtime_error &e) {
-        std::cerr << e.what() << std::endl;
-        return false;
+    SeatInventory::instance().refresh();
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    if (!seatMap || seatMap->seatIndex(seatNumber) < 0)
+    {
+        std::cout << "Seat " << seatNumber << " is invalid. Please enter a valid seat number" << std::endl;
+        return std::nullopt;
     }
 
-    // Check if the flight exists in seats.json
-    if (!seatsData.contains(flightNumber) || !seatsData[flightNumber]["seats"].contains(seatNumber))
+    auto seatHold = SeatHoldManager::instance().hold(flightNumber, seatNumber);
+    if (!seatHold)
     {
-        std::cout << "Seat " << seatNumber << " is invalid. Please enter a valid seat number" << std::endl;
-        return false; // Seat does not exist
+        std::cout << "Seat " << seatNumber << " is already taken. Please choose another seat" << std::endl;
     }
+    return seatHold;
+}
 
-    // Check if the seat is available
-    if (seatsData[flightNumber]["seats"][seatNumber] == "available")
+std::vector<SeatHold> FlightService::autoAssignSeats(std::string_view flightNumber, const SeatRequest& request)
+{
+    SeatInventory::instance().refresh();
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    if (!seatMap)
     {
-        // Mark the seat as booked
-        seatsData[flightNumber]["seats"][seatNumber] = "booked";
-
-        // Now update the available seats in flights.json
-        nlohmann::json flightsData;
-        try {
-            flightsData = JsonUtils::readJsonFromFile("data/flights.json");
-        } catch (const std::runtime_error &e) {
-            std::cerr << e.what() << std::endl;
-            return false;
-        }
+        std::cout << "Flight not found.\n";
+        return {};
+    }
 
-        // Find the flight in flights.json
-        auto flightIt = std::find_if(flightsData.begin(), flightsData.end(), [&](const nlohmann::json &flight)
-                                      { return flight["flightNumber"] == flightNumber; });
+    // Another agent may take a seat between finding and holding it; then look again
+    SeatFinder finder(seatMap->getLayout());
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        std::vector<int> seats = finder.findSeats(*seatMap, request);
+        if (seats.empty())
+        {
+            break;
+        }
 
-        if (flightIt != flightsData.end())
+        std::vector<SeatHold> holds;
+        for (int seat : seats)
         {
-            // Decrement available seats
-            int availableSeats = (*flightIt)["availableSeats"];
-            if (availableSeats > 0)
+            auto seatHold = SeatHoldManager::instance().hold(flightNumber, seatMap->seatLabel(seat));
+            if (!seatHold)
             {
-                (*flightIt)["availableSeats"] = availableSeats - 1;
-            }
-            else
-            {
-                std::cout << "No available seats left." << std::endl;
-                return false; // No available seats left
-            }
-
-            // Write the modified flights.json back to the file
-            try {
-                JsonUtils::saveJsonToFile(flightsData, "data/flights.json");
-            } catch (const std::runtime_error &e) {
-                std::cerr << e.what() << std::endl;
-                return false;
+                break;
             }
+            holds.push_back(std::move(*seatHold));
         }
-        else
+        if (holds.size() == seats.size())
         {
-            std::cout << "Flight " << flightNumber << " not found in flights.json." << std::endl;
-            return false; // Flight not found
+            return holds;
         }
-
-        // Write the modified seats.json back to the file
-        try {
-            JsonUtils::saveJsonToFile(seatsData, "data/seats.json");
-        } catch (const std::runtime_error &e) {
-            std::cerr << e.what() << std::endl;
-            return false;
+        for (const auto &seatHold : holds)
+        {
+            SeatHoldManager::instance().release(seatHold);
         }
+    }
 
-        std::cout << "Seat " << seatNumber << " on flight " << flightNumber << " has been booked." << std::endl;
-        return true;
+    std::cout << "No available seats match the request." << std::endl;
+    return {};
+}
+
+bool FlightService::markSeatAsBooked(std::string_view flightNumber, const std::string& seatNumber, Transaction& transaction)
+{
+    // Find the seat in the flight's seat map
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    int seatIndex = seatMap ? seatMap->seatIndex(seatNumber) : -1;
+    if (seatIndex < 0)
+    {
+        std::cout << "Seat " << seatNumber << " is invalid. Please enter a valid seat number" << std::endl;
+        return false; // Seat does not exist
     }
-    else if (seatsData[flightNumber]["seats"][seatNumber] == "booked")
+
+    if (seatMap->getAvailableCount() == 0)
+    {
+        std::cout << "No available seats left. The passenger can join the waitlist." << std::endl;
+        return false; // No available seats left
+    }
+
+    // Claim the seat atomically; fails if another agent got there first.
+    // The seat is claimed in the seat log when the transaction commits.
+    if (!transaction.bookSeat(flightNumber, seatNumber))
     {
         std::cout << "Seat is already booked" << std::endl;
         return false; // Seat is already booked
     }
 
-    return false; // Default return in case of unexpected scenarios
+    std::cout << "Seat " << seatNumber << " on flight " << flightNumber << " has been booked." << std::endl;
+    return true;
 }
 
-bool FlightService::changeSeat(const std::string &flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber)
+bool FlightService::changeSeat(std::string_view flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber)
 {
-    nlohmann::json flights;
-    std::ifstream file("data/seats.json");
-    if (file.good())
+    Transaction transaction;
+    return changeSeat(flightNumber, oldSeatNumber, newSeatNumber, transaction) && transaction.commit();
+}
+
+bool FlightService::changeSeat(std::string_view flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber, Transaction& transaction)
+{
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    if (!seatMap)
     {
-        file >> flights;
-        file.close();
+        std::cout << "Flight doesn't exist! " << std::endl;
+        return false;
     }
 
-    if (flights.contains(flightNumber))
+    if (seatMap->seatIndex(newSeatNumber) < 0)
     {
-        if (flights[flightNumber]["seats"][newSeatNumber] == "available")
-        {
-            flights[flightNumber]["seats"][newSeatNumber] = "booked";
-            flights[flightNumber]["seats"][oldSeatNumber] = "available";
-            std::ofstream outFile("data/seats.json");
-            outFile << flights.dump(4);
-            outFile.close();
-            return true;
-        }
-        else if (flights[flightNumber]["seats"][newSeatNumber] == "booked")
-        {
-            return false;
-        }
+        return false; // Invalid seat
     }
 
-    std::cout << "Flight doesn't exist! " << std::endl;
-    return false;
+    // Move the booking in one step (or just claim the new seat if the old one is unknown)
+    return seatMap->seatIndex(oldSeatNumber) >= 0 ? transaction.moveSeat(flightNumber, oldSeatNumber, newSeatNumber)
+                                                  : transaction.bookSeat(flightNumber, newSeatNumber);
 }
 
 
-std::optional<std::reference_wrapper<Flight>> FlightService::findFlight(const std::string& flightNumber) const
+int FlightService::getAvailableSeats(const Flight& flight) const
 {
-    auto flights = getFlights();
-    for(auto& flight:flights)
-    {   
-        if(flight.getFlightNumber() == flightNumber)    // Found Flight
+    auto seatMap = SeatInventory::instance().findSeatMap(flight.getFlightNumber());
+    return seatMap ? seatMap->getAvailableCount() : flight.getAvailableSeats();
+}
+
+std::optional<std::string> FlightService::findCabinClass(std::string_view flightNumber, const std::string& text) const
+{
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    if (!seatMap)
+    {
+        std::cout << "Flight not found.\n";
+        return std::nullopt;
+    }
+    if (text.empty())
+    {
+        return std::string();
+    }
+
+    const CabinLayout &layout = seatMap->getLayout();
+    for (int i = 0; i < layout.getClassCount(); i++)
+    {
+        std::string name(layout.getClass(i).name);
+        if (Utils::toLowerCase(name) == Utils::toLowerCase(text))
         {
-            return flight;
+            return name;
         }
     }
-    
-    std::cout<<"Flight Not Found"<<std::endl;
+
+    std::cout << "Flight " << flightNumber << " has no " << text << " cabin. Its classes are:";
+    for (int i = 0; i < layout.getClassCount(); i++)
+    {
+        std::cout << " " << layout.getClass(i).name;
+    }
+    std::cout << std::endl;
     return std::nullopt;
-    
 }
 
-std::vector<Flight> FlightService::loadFlightsFromJson(const std::string& filename) const 
+FlightCatalog::FlightHandle FlightService::findFlight(std::string_view flightNumber) const
 {
-    std::vector<Flight> flights;
-    nlohmann::json flightsJson = JsonUtils::readJsonFromFile(filename);
-
-    for (const auto &flightJson : flightsJson)
+    // Constant-time lookup in the catalog's flight number index
+    auto flight = FlightCatalog::instance().findFlight(flightNumber);
+    if (!flight)
     {
-        flights.push_back(Flight::fromJson(flightJson));
+        std::cout<<"Flight Not Found"<<std::endl;
     }
-
-    return flights;
-}   
+    return flight;
+}
@@ -1,7 +1,6 @@
 #include "../../include/Flight/FlightServiceAdmin.hpp"
 
-std::vector<Flight> FlightServiceAdmin::getFlightsForReport() const
+FlightCatalog::FlightList FlightServiceAdmin::getFlightsForReport() const
 {
-    auto flights = getFlights();
-    return flights;
+    return getFlights();
 }
\ No newline at end of file
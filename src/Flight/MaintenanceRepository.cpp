@@ -0,0 +1,445 @@
+#include "../../include/Flight/MaintenanceRepository.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+
+MaintenanceRepository::MaintenanceRepository(const std::string& logsFile, const std::string& scheduleFile, const std::string& journalFile)
+    : logsFile(logsFile), scheduleFile(scheduleFile), journalFile(journalFile), lockFile(JsonUtils::lockFileFor(journalFile))
+{
+}
+
+MaintenanceRepository::~MaintenanceRepository()
+{
+    if (journal)
+    {
+        std::fclose(journal);
+    }
+}
+
+MaintenanceRepository& MaintenanceRepository::instance()
+{
+    static MaintenanceRepository repository("data/maintenance_logs.json", "data/maintenance_schedule.json", "data/maintenance.journal");
+    return repository;
+}
+
+const MaintenanceRepository::MaintenanceLogs& MaintenanceRepository::getLogs(const std::string& aircraftId)
+{
+    static const MaintenanceLogs noLogs;
+    loadIfNeeded();
+    auto logs = logsByAircraft.find(aircraftId);
+    return logs != logsByAircraft.end() ? logs->second : noLogs;
+}
+
+const std::vector<std::string>& MaintenanceRepository::getSchedule(const std::string& aircraftId)
+{
+    static const std::vector<std::string> noSchedule;
+    loadIfNeeded();
+    auto schedule = scheduleByAircraft.find(aircraftId);
+    return schedule != scheduleByAircraft.end() ? schedule->second : noSchedule;
+}
+
+void MaintenanceRepository::addLog(const std::string& aircraftId, const std::string& aircraftType, const std::string& date, const std::string& description)
+{
+    loadIfNeeded();
+    record({{"op", "log"}, {"aircraftId", aircraftId}, {"type", aircraftType}, {"date", date}, {"description", description}});
+}
+
+void MaintenanceRepository::addScheduledDate(const std::string& aircraftId, const std::string& aircraftType, const std::string& date)
+{
+    loadIfNeeded();
+    record({{"op", "schedule"}, {"aircraftId", aircraftId}, {"type", aircraftType}, {"date", date}});
+}
+
+void MaintenanceRepository::removeScheduledDate(const std::string& aircraftId, const std::string& aircraftType, const std::string& date)
+{
+    loadIfNeeded();
+    record({{"op", "unschedule"}, {"aircraftId", aircraftId}, {"type", aircraftType}, {"date", date}});
+}
+
+void MaintenanceRepository::compact()
+{
+    loadIfNeeded();
+    FileLock lock(lockFile);
+    catchUpForWrite();
+    writeCompacted();
+}
+
+void MaintenanceRepository::loadIfNeeded()
+{
+    try
+    {
+        if (loaded)
+        {
+            // Cheap unless another process changed the journal
+            auto version = JsonUtils::getFileVersion(journalFile, lockFile);
+            if (version.generation != generation || version.size != readOffset)
+            {
+                FileLock lock(lockFile, FileLock::Mode::Shared);
+                catchUp(false);
+            }
+            return;
+        }
+        loaded = true;
+
+        // Start a journal if there is none or it was left behind by a compaction that
+        // stopped halfway, and fold a long one into the files
+        FileLock lock(lockFile);
+        reload(true);
+        if (!logsMatchBase || !scheduleMatchesBase || journalRecords >= compactAfterRecords)
+        {
+            writeCompacted();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Error opening maintenance journal: " << e.what() << std::endl;
+    }
+}
+
+void MaintenanceRepository::loadLogs()
+{
+    logsByAircraft.clear();
+    std::string contents = readFile(logsFile);
+    logsHash = hashContents(contents);
+    logsVersion = JsonUtils::getFileVersion(logsFile);
+    logsJson = nlohmann::json::parse(contents, nullptr, false);
+
+    // Logs live in the first object of the array, keyed by aircraft ID
+    if (!logsJson.is_array() || logsJson.empty() || !logsJson[0].is_object())
+    {
+        if (!contents.empty())
+        {
+            std::cout << "Error loading maintenance logs: unexpected format in " << logsFile << std::endl;
+        }
+        logsJson = nlohmann::json::array();
+        logsJson.push_back(nlohmann::json::object());
+        return;
+    }
+
+    for (const auto &[aircraftId, aircraftLogs] : logsJson[0].items())
+    {
+        const auto logs = aircraftLogs.find("maintenance_logs");
+        if (logs == aircraftLogs.end() || !logs->is_array())
+        {
+            continue;
+        }
+
+        auto &entries = logsByAircraft[aircraftId];
+        for (const auto &log : *logs)
+        {
+            if (log.contains("date") && log.contains("description"))
+            {
+                entries.emplace_back(log["date"], log["description"]);
+            }
+        }
+    }
+}
+
+void MaintenanceRepository::loadSchedule()
+{
+    scheduleByAircraft.clear();
+    std::string contents = readFile(scheduleFile);
+    scheduleHash = hashContents(contents);
+    scheduleVersion = JsonUtils::getFileVersion(scheduleFile);
+    scheduleJson = nlohmann::json::parse(contents, nullptr, false);
+
+    if (!scheduleJson.is_object())
+    {
+        if (!contents.empty())
+        {
+            std::cout << "Error loading maintenance schedule: unexpected format in " << scheduleFile << std::endl;
+        }
+        scheduleJson = nlohmann::json::object();
+        return;
+    }
+
+    for (const auto &[aircraftId, aircraftSchedule] : scheduleJson.items())
+    {
+        const auto schedule = aircraftSchedule.find("schedule");
+        if (schedule == aircraftSchedule.end() || !schedule->is_array())
+        {
+            continue;
+        }
+
+        auto &dates = scheduleByAircraft[aircraftId];
+        for (const auto &entry : *schedule)
+        {
+            // Entries are {"date", "description"} objects; older saves wrote bare dates
+            if (entry.is_object() && entry.contains("date"))
+            {
+                dates.push_back(entry["date"]);
+            }
+            else if (entry.is_string())
+            {
+                dates.push_back(entry);
+            }
+        }
+    }
+}
+
+void MaintenanceRepository::reload(bool repairTornRecord)
+{
+    // The files and a new journal were written by another process's compaction
+    if (journal)
+    {
+        std::fclose(journal);
+        journal = nullptr;
+    }
+    loadLogs();
+    loadSchedule();
+    logsMatchBase = false;
+    scheduleMatchesBase = false;
+    journalRecords = 0;
+    readOffset = 0;
+    generation = JsonUtils::getFileVersion(journalFile, lockFile).generation;
+    catchUp(repairTornRecord);
+}
+
+void MaintenanceRepository::catchUp(bool repairTornRecord)
+{
+    auto version = JsonUtils::getFileVersion(journalFile, lockFile);
+    if (version.generation != generation)
+    {
+        reload(repairTornRecord);
+        return;
+    }
+    if (version.size <= readOffset)
+    {
+        return;
+    }
+
+    // Apply the records appended since the last look; a torn last line ends the pass
+    std::ifstream in(journalFile, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(readOffset));
+    std::string line;
+    std::uint64_t validBytes = 0;
+    bool torn = false;
+    while (std::getline(in, line))
+    {
+        nlohmann::json change = nlohmann::json::parse(line, nullptr, false);
+        if (in.eof() || change.is_discarded() || !change.contains("op"))
+        {
+            torn = true;
+            break;
+        }
+        bool isBase = readOffset + validBytes == 0;
+        validBytes += line.size() + 1;
+
+        // The first line says which file versions the records were written against
+        if (isBase)
+        {
+            logsMatchBase = change["op"] == "base" && change.value("logs", std::uint64_t{0}) == logsHash;
+            scheduleMatchesBase = change["op"] == "base" && change.value("schedule", std::uint64_t{0}) == scheduleHash;
+            continue;
+        }
+
+        journalRecords++;
+        bool isLog = change["op"] == "log";
+        if ((isLog && logsMatchBase) || (!isLog && scheduleMatchesBase))
+        {
+            try
+            {
+                apply(change);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Skipping bad maintenance record: " << e.what() << std::endl;
+            }
+        }
+    }
+    in.close();
+    readOffset += validBytes;
+
+    // Cut the torn record off so new appends start on a clean line
+    if (torn && repairTornRecord)
+    {
+        std::cout << "Discarding incomplete record at the end of " << journalFile << std::endl;
+        std::filesystem::resize_file(journalFile, static_cast<std::uintmax_t>(readOffset));
+    }
+}
+
+void MaintenanceRepository::catchUpForWrite()
+{
+    // A compaction that stopped halfway replaced a file without starting a new journal,
+    // so the files are checked as well as the journal
+    catchUp(true);
+    if (JsonUtils::getFileVersion(logsFile) != logsVersion || JsonUtils::getFileVersion(scheduleFile) != scheduleVersion)
+    {
+        reload(true);
+    }
+}
+
+void MaintenanceRepository::record(const nlohmann::json& change)
+{
+    try
+    {
+        FileLock lock(lockFile);
+        catchUpForWrite();
+        if (!logsMatchBase || !scheduleMatchesBase)
+        {
+            writeCompacted(); // Records after a stale base would be skipped
+        }
+
+        // Applied only once it is in the journal
+        if (!journal)
+        {
+            openJournal();
+        }
+        std::string line = change.dump();
+        line.push_back('\n');
+        if (std::fwrite(line.data(), 1, line.size(), journal) != line.size())
+        {
+            throw std::runtime_error("Failed to append to file: " + journalFile);
+        }
+        JsonUtils::syncFile(journal);
+        readOffset += line.size();
+        journalRecords++;
+        apply(change);
+
+        if (journalRecords >= compactAfterRecords)
+        {
+            writeCompacted();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Error saving maintenance record: " << e.what() << std::endl;
+    }
+}
+
+void MaintenanceRepository::apply(const nlohmann::json& change)
+{
+    const std::string op = change.at("op").get<std::string>();
+    const std::string aircraftId = change.at("aircraftId").get<std::string>();
+    const std::string aircraftType = change.at("type").get<std::string>();
+    const std::string date = change.at("date").get<std::string>();
+
+    if (op == "log")
+    {
+        applyLog(aircraftId, aircraftType, date, change.at("description").get<std::string>());
+    }
+    else if (op == "schedule")
+    {
+        applySchedule(aircraftId, aircraftType, date);
+    }
+    else if (op == "unschedule")
+    {
+        applyUnschedule(aircraftId, aircraftType, date);
+    }
+}
+
+void MaintenanceRepository::applyLog(const std::string& aircraftId, const std::string& aircraftType, const std::string& date, const std::string& description)
+{
+    logsByAircraft[aircraftId].emplace_back(date, description);
+
+    auto &logsObject = logsJson[0];
+    if (!logsObject.contains(aircraftId))
+    {
+        logsObject[aircraftId] = {
+            {"maintenance_logs", nlohmann::json::array()},
+            {"type", aircraftType}
+        };
+    }
+    logsObject[aircraftId]["maintenance_logs"].push_back({
+        {"date", date},
+        {"description", description}
+    });
+}
+
+void MaintenanceRepository::applySchedule(const std::string& aircraftId, const std::string& aircraftType, const std::string& date)
+{
+    scheduleByAircraft[aircraftId].push_back(date);
+
+    auto &aircraftSchedule = scheduleJson[aircraftId];
+    aircraftSchedule["type"] = aircraftType;
+    if (!aircraftSchedule["schedule"].is_array())
+    {
+        aircraftSchedule["schedule"] = nlohmann::json::array();
+    }
+    aircraftSchedule["schedule"].push_back({
+        {"date", date},
+        {"description", ""}
+    });
+}
+
+void MaintenanceRepository::applyUnschedule(const std::string& aircraftId, const std::string& aircraftType, const std::string& date)
+{
+    auto &schedule = scheduleByAircraft[aircraftId];
+    schedule.erase(std::remove(schedule.begin(), schedule.end(), date), schedule.end());
+
+    auto &aircraftSchedule = scheduleJson[aircraftId];
+    aircraftSchedule["type"] = aircraftType;
+    if (!aircraftSchedule["schedule"].is_array())
+    {
+        aircraftSchedule["schedule"] = nlohmann::json::array();
+    }
+    auto &entries = aircraftSchedule["schedule"];
+    for (auto entry = entries.begin(); entry != entries.end();)
+    {
+        bool matches = entry->is_object() ? entry->value("date", "") == date : *entry == date;
+        entry = matches ? entries.erase(entry) : entry + 1;
+    }
+}
+
+void MaintenanceRepository::writeCompacted()
+{
+    // Each file is replaced atomically; the new journal is started against both
+    std::string logsText = logsJson.dump(4);
+    JsonUtils::writeFileAtomically(logsFile, logsText);
+    logsHash = hashContents(logsText);
+    logsVersion = JsonUtils::getFileVersion(logsFile);
+
+    std::string scheduleText = scheduleJson.dump(4);
+    JsonUtils::writeFileAtomically(scheduleFile, scheduleText);
+    scheduleHash = hashContents(scheduleText);
+    scheduleVersion = JsonUtils::getFileVersion(scheduleFile);
+
+    startJournal();
+}
+
+void MaintenanceRepository::startJournal()
+{
+    // Other processes keep the journal open, so it is replaced rather than truncated
+    if (journal)
+    {
+        std::fclose(journal);
+        journal = nullptr;
+    }
+    std::string header = nlohmann::json{{"op", "base"}, {"logs", logsHash}, {"schedule", scheduleHash}}.dump();
+    header.push_back('\n');
+    JsonUtils::writeFileAtomically(journalFile, header);
+    logsMatchBase = true;
+    scheduleMatchesBase = true;
+    journalRecords = 0;
+    readOffset = header.size();
+    generation = JsonUtils::getFileVersion(journalFile, lockFile).generation;
+    openJournal();
+}
+
+void MaintenanceRepository::openJournal()
+{
+    journal = JsonUtils::openShared(journalFile, "ab");
+    if (!journal)
+    {
+        throw std::runtime_error("Failed to open file: " + journalFile);
+    }
+}
+
+std::string MaintenanceRepository::readFile(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::uint64_t MaintenanceRepository::hashContents(const std::string& contents)
+{
+    // 64-bit FNV-1a, stable across builds
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : contents)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,183 @@
+#include "../../include/Flight/SeatFinder.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    int lowestBit(std::uint64_t mask)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        int bit = 0;
+        while (!(mask & 1))
+        {
+            mask >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+}
+
+SeatFinder::SeatFinder(int cols, const std::vector<int>& aisleAfter) : cols(cols)
+{
+    if (cols <= 0 || cols > 63)
+    {
+        throw std::invalid_argument("Invalid cabin width");
+    }
+
+    allSeats = (std::uint64_t{1} << cols) - 1;
+    windowSeats = std::uint64_t{1} | std::uint64_t{1} << (cols - 1);
+    aisleSeats = 0;
+    sectionLinks = allSeats >> 1;
+    for (int col : aisleAfter)
+    {
+        if (col < 0 || col + 1 >= cols)
+        {
+            throw std::invalid_argument("Aisle outside the cabin");
+        }
+        aisleSeats |= std::uint64_t{1} << col | std::uint64_t{1} << (col + 1);
+        sectionLinks &= ~(std::uint64_t{1} << col);
+    }
+}
+
+SeatFinder::SeatFinder(const CabinLayout& layout) : SeatFinder(layout.getCols(), {})
+{
+    for (int col = 0; col + 1 < cols; col++)
+    {
+        if (layout.hasAisleAfter(col))
+        {
+            aisleSeats |= std::uint64_t{1} << col | std::uint64_t{1} << (col + 1);
+            sectionLinks &= ~(std::uint64_t{1} << col);
+        }
+    }
+}
+
+SeatPosition SeatFinder::parsePosition(const std::string& text)
+{
+    std::string lower = text;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "window")
+    {
+        return SeatPosition::Window;
+    }
+    if (lower == "aisle")
+    {
+        return SeatPosition::Aisle;
+    }
+    return SeatPosition::Any;
+}
+
+std::uint64_t SeatFinder::blockStarts(std::uint64_t freeSeats, int size, std::uint64_t links) const
+{
+    // Bit p survives step i when seat p + i is free and linked to the seat before it
+    std::uint64_t starts = freeSeats;
+    for (int i = 1; i < size && starts; i++)
+    {
+        starts &= (freeSeats >> i) & (links >> (i - 1));
+    }
+    return starts;
+}
+
+std::uint64_t SeatFinder::blocksCovering(std::uint64_t columns, int size) const
+{
+    // Blocks starting up to size - 1 columns before one of them include it
+    std::uint64_t starts = columns;
+    for (int i = 1; i < size; i++)
+    {
+        starts |= columns >> i;
+    }
+    return starts;
+}
+
+std::uint64_t SeatFinder::positionMask(SeatPosition position) const
+{
+    switch (position)
+    {
+    case SeatPosition::Window:
+        return windowSeats;
+    case SeatPosition::Aisle:
+        return aisleSeats;
+    default:
+        return allSeats;
+    }
+}
+
+std::vector<int> SeatFinder::findSeats(const SeatMap& seatMap, const SeatRequest& request) const
+{
+    std::vector<int> seats;
+    int size = request.partySize;
+    int firstRow = std::max(request.firstRow, 1) - 1;
+    int lastRow = request.lastRow > 0 ? std::min(request.lastRow, seatMap.getRows()) : seatMap.getRows();
+    if (seatMap.getCols() != cols || size <= 0 || firstRow >= lastRow)
+    {
+        return seats;
+    }
+
+    std::uint64_t preferred = positionMask(request.position);
+
+    if (request.together)
+    {
+        if (size > cols)
+        {
+            return seats;
+        }
+
+        struct Pass
+        {
+            std::uint64_t links;
+            std::uint64_t startsAllowed;
+        };
+        const Pass passes[] = {
+            {sectionLinks, blocksCovering(preferred, size)},
+            {sectionLinks, allSeats},
+            {allSeats >> 1, blocksCovering(preferred, size)},
+            {allSeats >> 1, allSeats},
+        };
+        for (const Pass &pass : passes)
+        {
+            for (int row = firstRow; row < lastRow; row++)
+            {
+                std::uint64_t freeSeats = ~seatMap.getRowMask(row) & allSeats;
+                std::uint64_t starts = blockStarts(freeSeats, size, pass.links) & pass.startsAllowed;
+                if (starts)
+                {
+                    int first = row * cols + lowestBit(starts);
+                    for (int i = 0; i < size; i++)
+                    {
+                        seats.push_back(first + i);
+                    }
+                    return seats;
+                }
+            }
+        }
+        return seats;
+    }
+
+    // Apart: preferred seats front to back, then any seats front to back
+    for (std::uint64_t wanted : {preferred, allSeats})
+    {
+        for (int row = firstRow; row < lastRow && static_cast<int>(seats.size()) < size; row++)
+        {
+            std::uint64_t freeSeats = ~seatMap.getRowMask(row) & wanted;
+            for (const int seat : seats)
+            {
+                if (seat / cols == row)
+                {
+                    freeSeats &= ~(std::uint64_t{1} << (seat % cols));
+                }
+            }
+            for (; freeSeats && static_cast<int>(seats.size()) < size; freeSeats &= freeSeats - 1)
+            {
+                seats.push_back(row * cols + lowestBit(freeSeats));
+            }
+        }
+    }
+    if (static_cast<int>(seats.size()) < size)
+    {
+        seats.clear();
+    }
+    std::sort(seats.begin(), seats.end());
+    return seats;
+}
@@ -0,0 +1,678 @@
+#include "../../include/Flight/SeatInventory.hpp"
+#include "../../include/Utils/FileLock.hpp"
+#include "../../include/Booking/TransactionManager.hpp"
+#include <algorithm>
+#include <filesystem>
+
+namespace
+{
+    // File layout: "SEAT", version byte, uint32 flight count, then per flight a
+    // length-prefixed flight number, a length-prefixed cabin layout name (empty for a
+    // standard layout) and the SeatMap's own binary form. Version 1 files have no layout
+    // names; their cabins are all standard.
+    const char seatFileMagic[4] = {'S', 'E', 'A', 'T'};
+    const char seatFileVersion = 2;
+
+    std::string readShortString(std::istream& in)
+    {
+        int length = in.get();
+        std::string text(length > 0 ? length : 0, '\0');
+        if (length == EOF || !in.read(text.data(), length))
+        {
+            throw std::runtime_error("Truncated seat file");
+        }
+        return text;
+    }
+
+    void writeUint32(std::ostream& out, std::uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            out.put(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+
+    std::uint32_t readUint32(std::istream& in)
+    {
+        unsigned char bytes[4];
+        if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+        {
+            throw std::runtime_error("Truncated seat file");
+        }
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+    }
+}
+
+SeatInventory::SeatInventory(const std::string& filename, const std::string& logFile, const std::string& legacyJsonFile)
+    : filename(filename), logFile(logFile), legacyJsonFile(legacyJsonFile)
+{
+    load();
+}
+
+SeatInventory& SeatInventory::instance()
+{
+    static SeatInventory inventory("data/seats.dat", "data/seats.log", "data/seats.json");
+    return inventory;
+}
+
+std::shared_ptr<SeatMap> SeatInventory::findSeatMap(std::string_view flightNumber) const
+{
+    std::shared_lock<std::shared_mutex> lock(seatMapsMutex);
+    auto it = seatMaps.find(flightNumber);
+    return it != seatMaps.end() ? it->second : nullptr;
+}
+
+bool SeatInventory::createSeatMap(const std::string& flightNumber, int rows, int cols)
+{
+    return createSeatMap(flightNumber, CabinLayout::standard(rows, cols));
+}
+
+bool SeatInventory::createSeatMap(const std::string& flightNumber, const CabinLayout& layout)
+{
+    auto seatMap = std::make_shared<SeatMap>(layout);
+    std::unique_lock<std::shared_mutex> lock(seatMapsMutex);
+    return seatMaps.emplace(flightNumber, std::move(seatMap)).second;
+}
+
+bool SeatInventory::removeSeatMap(const std::string& flightNumber)
+{
+    std::unique_lock<std::shared_mutex> lock(seatMapsMutex);
+    return seatMaps.erase(flightNumber) > 0;
+}
+
+void SeatInventory::putSeatMap(const std::string& flightNumber, SeatMap&& seatMap)
+{
+    auto entry = std::make_shared<SeatMap>(std::move(seatMap));
+    std::unique_lock<std::shared_mutex> lock(seatMapsMutex);
+    seatMaps[flightNumber] = std::move(entry);
+}
+
+bool SeatInventory::holdSeat(std::string_view flightNumber, int seatIndex)
+{
+    // The booked bit is the hold; the seat map's sold bits tell it from a sale
+    auto seatMap = findSeatMap(flightNumber);
+    return seatMap && seatIndex >= 0 && seatIndex < seatMap->getSeatCount() && seatMap->book(seatIndex);
+}
+
+bool SeatInventory::isHeldSeat(std::string_view flightNumber, int seatIndex) const
+{
+    auto seatMap = findSeatMap(flightNumber);
+    return seatMap && seatIndex >= 0 && seatIndex < seatMap->getSeatCount() && seatMap->isHeld(seatIndex);
+}
+
+bool SeatInventory::releaseHeldSeat(std::string_view flightNumber, int seatIndex)
+{
+    auto seatMap = findSeatMap(flightNumber);
+    return seatMap && seatIndex >= 0 && seatIndex < seatMap->getSeatCount() && seatMap->releaseHold(seatIndex);
+}
+
+bool SeatInventory::claimSeats(const std::vector<SeatRef>& seats, const std::string& journal, std::uint64_t txn)
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    FileLock lock(JsonUtils::lockFileFor(filename));
+
+    // Another process may have claimed one of our held seats since we last read the files;
+    // catching up sells it to them
+    catchUp(true);
+    for (const auto &[flightNumber, seatIndex] : seats)
+    {
+        if (!isHeldSeat(flightNumber, seatIndex))
+        {
+            return false;
+        }
+    }
+
+    appendLog({{"op", "claim"}, {"journal", journal}, {"txn", txn}, {"seats", seats}});
+    for (const auto &seat : seats)
+    {
+        takeSeat(nullptr, seat);
+    }
+    pendingClaims[journal][txn] = seats;
+    return true;
+}
+
+void SeatInventory::commitSeats(const std::optional<TransactionStamp>& stamp, const std::vector<SeatRef>& booked,
+                                const std::vector<SeatRef>& released)
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    FileLock lock(JsonUtils::lockFileFor(filename));
+    catchUp(true);
+    if (stamp && settled.contains(*stamp))
+    {
+        return; // Replayed, but settled before the crash
+    }
+
+    // Applied here first: if the record can't be written, the next save() still has it
+    nlohmann::json record = {{"op", "commit"}, {"claim", booked}, {"release", released}};
+    if (stamp)
+    {
+        record["journal"] = stamp->journal;
+        record["txn"] = stamp->txn;
+        auto claims = pendingClaims.find(stamp->journal);
+        if (claims != pendingClaims.end() && claims->second.erase(stamp->txn) > 0 && claims->second.empty())
+        {
+            pendingClaims.erase(claims);
+        }
+        settled.add(*stamp);
+    }
+    for (const auto &seat : booked)
+    {
+        takeSeat(nullptr, seat);
+    }
+    for (const auto &seat : released)
+    {
+        freeSeat(nullptr, seat);
+    }
+    appendLog(record);
+}
+
+void SeatInventory::abortClaims(const std::string& journal, std::uint64_t afterTxn)
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    FileLock lock(JsonUtils::lockFileFor(filename));
+    catchUp(true);
+    auto claims = pendingClaims.find(journal);
+    if (claims == pendingClaims.end() || claims->second.upper_bound(afterTxn) == claims->second.end())
+    {
+        return;
+    }
+
+    // Our own claims: the seats go back to the transactions that hold them
+    for (auto it = claims->second.upper_bound(afterTxn); it != claims->second.end(); ++it)
+    {
+        for (const auto &[flightNumber, seatIndex] : it->second)
+        {
+            if (auto seatMap = findSeatMap(flightNumber))
+            {
+                seatMap->unsell(seatIndex, true);
+            }
+        }
+    }
+    claims->second.erase(claims->second.upper_bound(afterTxn), claims->second.end());
+    if (claims->second.empty())
+    {
+        pendingClaims.erase(claims);
+    }
+    appendLog({{"op", "abort"}, {"journal", journal}, {"after", afterTxn}});
+}
+
+void SeatInventory::abortDeadClaims(const std::function<bool(const std::string&)>& dead)
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    FileLock lock(JsonUtils::lockFileFor(filename));
+    catchUp(true);
+    for (auto claims = pendingClaims.begin(); claims != pendingClaims.end();)
+    {
+        if (!dead(claims->first))
+        {
+            ++claims;
+            continue;
+        }
+        for (const auto &[txn, seats] : claims->second)
+        {
+            for (const auto &seat : seats)
+            {
+                freeSeat(nullptr, seat);
+            }
+        }
+        std::string journal = claims->first;
+        claims = pendingClaims.erase(claims);
+        appendLog({{"op", "abort"}, {"journal", journal}, {"after", 0}});
+    }
+}
+
+void SeatInventory::syncLog()
+{
+    // The handle is shared so a save() replacing the log can't close it under the fsync
+    std::shared_ptr<std::FILE> file;
+    {
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        file = log;
+    }
+    if (file)
+    {
+        JsonUtils::syncFile(file.get());
+    }
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<SeatMap>>> SeatInventory::getSeatMaps() const
+{
+    std::shared_lock<std::shared_mutex> lock(seatMapsMutex);
+    return {seatMaps.begin(), seatMaps.end()};
+}
+
+void SeatInventory::save()
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    FileLock lock(JsonUtils::lockFileFor(filename));
+    catchUp(true); // Don't overwrite what another process saved meanwhile
+    writeFile();
+}
+
+void SeatInventory::writeFile()
+{
+    // Pending claims aren't final; they move to the new log instead
+    std::map<std::string, std::vector<int>, std::less<>> claimed;
+    std::string logHead;
+    AppliedTransactions stamps = settled;
+    stamps.prune(TransactionManager::hasJournal);
+    if (!stamps.empty())
+    {
+        logHead = nlohmann::json{{"op", "applied"}, {"transactions", stamps.toJson()}}.dump() + "\n";
+    }
+    for (const auto &[journal, claims] : pendingClaims)
+    {
+        for (const auto &[txn, seats] : claims)
+        {
+            logHead += nlohmann::json{{"op", "claim"}, {"journal", journal}, {"txn", txn}, {"seats", seats}}.dump() + "\n";
+            for (const auto &[flightNumber, seatIndex] : seats)
+            {
+                claimed[flightNumber].push_back(seatIndex);
+            }
+        }
+    }
+
+    // Bookings keep going while the words are copied out; only sold seats are saved
+    std::ostringstream out;
+    std::set<std::string, std::less<>> written;
+    {
+        std::shared_lock<std::shared_mutex> mapsLock(seatMapsMutex);
+        out.write(seatFileMagic, sizeof(seatFileMagic));
+        out.put(seatFileVersion);
+        writeUint32(out, static_cast<std::uint32_t>(seatMaps.size()));
+        for (const auto &[flightNumber, seatMap] : seatMaps)
+        {
+            auto words = seatMap->getSoldWords();
+            auto pending = claimed.find(flightNumber);
+            if (pending != claimed.end())
+            {
+                for (int seatIndex : pending->second)
+                {
+                    if (seatIndex >= 0 && static_cast<size_t>(seatIndex >> 6) < words.size())
+                    {
+                        words[seatIndex >> 6] &= ~(std::uint64_t(1) << (seatIndex & 63));
+                    }
+                }
+            }
+            out.put(static_cast<char>(flightNumber.size()));
+            out.write(flightNumber.data(), static_cast<std::streamsize>(flightNumber.size()));
+            std::string_view layoutName = seatMap->getLayout().getName();
+            out.put(static_cast<char>(layoutName.size()));
+            out.write(layoutName.data(), static_cast<std::streamsize>(layoutName.size()));
+            SeatMap::writeTo(out, seatMap->getRows(), seatMap->getCols(), words);
+            written.insert(flightNumber);
+        }
+    }
+
+    // Synced and renamed into place, so a crash leaves either the old file or the new one.
+    // A crash before the log is cut back too replays the old log over the new file, which
+    // ends in the same seats.
+    JsonUtils::writeFileAtomically(filename, out.str());
+    syncedFlights = std::move(written);
+    syncedVersion = JsonUtils::getFileVersion(filename);
+
+    std::string tempLog = logFile + ".tmp";
+    std::FILE* rewritten = std::fopen(tempLog.c_str(), "wb");
+    if (!rewritten)
+    {
+        throw std::runtime_error("Failed to open file: " + tempLog);
+    }
+    bool complete = std::fwrite(logHead.data(), 1, logHead.size(), rewritten) == logHead.size();
+    try
+    {
+        JsonUtils::syncFile(rewritten);
+    }
+    catch (const std::runtime_error &)
+    {
+        complete = false;
+    }
+    std::fclose(rewritten);
+    if (!complete)
+    {
+        std::remove(tempLog.c_str());
+        throw std::runtime_error("Failed to write file: " + tempLog);
+    }
+
+    // Other processes keep the log open, so it is replaced rather than renamed
+    log.reset();
+    JsonUtils::replaceFile(tempLog, logFile);
+    openLog();
+    logOffset = logHead.size();
+}
+
+void SeatInventory::refresh()
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    std::error_code ec;
+    std::uint64_t logSize = std::filesystem::file_size(logFile, ec);
+    if (JsonUtils::getFileVersion(filename) == syncedVersion && (ec ? 0 : logSize) == logOffset)
+    {
+        return; // Nobody saved or logged anything since we last synced
+    }
+
+    try
+    {
+        FileLock lock(JsonUtils::lockFileFor(filename), FileLock::Mode::Shared);
+        catchUp(false);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error reloading seat maps: " << e.what() << std::endl;
+    }
+}
+
+void SeatInventory::load()
+{
+    try
+    {
+        std::ifstream probe(filename, std::ios::binary);
+        if (probe.good())
+        {
+            std::lock_guard<std::mutex> fileLock(fileMutex);
+            FileLock lock(JsonUtils::lockFileFor(filename), FileLock::Mode::Shared);
+            mergeFromFile();
+        }
+        else
+        {
+            // First run: convert the legacy JSON seat maps
+            importFromJson();
+            save();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error loading seat maps: " << e.what() << std::endl;
+    }
+}
+
+SeatInventory::SeatMaps SeatInventory::readFile() const
+{
+    std::ifstream in(filename, std::ios::binary);
+
+    char magic[sizeof(seatFileMagic)];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), seatFileMagic))
+    {
+        throw std::runtime_error("Not a seat map file: " + filename);
+    }
+    int version = in.get();
+    if (version != 1 && version != seatFileVersion)
+    {
+        throw std::runtime_error("Unsupported seat map file version: " + filename);
+    }
+
+    SeatMaps fileMaps;
+    std::uint32_t count = readUint32(in);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        std::string flightNumber = readShortString(in);
+        std::string layoutName = version > 1 ? readShortString(in) : std::string();
+        auto seatMap = std::make_shared<SeatMap>(SeatMap::readFrom(in));
+        if (!layoutName.empty())
+        {
+            const CabinLayout *layout = CabinLayout::find(layoutName);
+            if (layout && layout->getRows() == seatMap->getRows() && layout->getCols() == seatMap->getCols())
+            {
+                seatMap->setLayout(*layout);
+            }
+            else
+            {
+                std::cerr << "Unknown cabin layout " << layoutName << " for flight " << flightNumber << "; using a standard one" << std::endl;
+            }
+        }
+        fileMaps[flightNumber] = std::move(seatMap);
+    }
+    return fileMaps;
+}
+
+void SeatInventory::catchUp(bool repairTornRecord)
+{
+    if (JsonUtils::getFileVersion(filename) != syncedVersion)
+    {
+        mergeFromFile(); // Saved elsewhere, and the log cut back with it
+        return;
+    }
+    readLog(nullptr, repairTornRecord);
+}
+
+void SeatInventory::mergeFromFile()
+{
+    // The file's seats with the whole log applied, then merged into ours
+    auto version = JsonUtils::getFileVersion(filename);
+    SeatMaps fileMaps = readFile();
+    pendingClaims.clear();
+    settled.clear();
+    logOffset = 0;
+    if (log)
+    {
+        openLog(); // The log may have been replaced
+    }
+    readLog(&fileMaps, false);
+    mergeFromFile(fileMaps, version);
+}
+
+void SeatInventory::readLog(SeatMaps* fileMaps, bool repairTornRecord)
+{
+    std::ifstream in(logFile, std::ios::binary);
+    if (!in.is_open())
+    {
+        return;
+    }
+
+    // Apply the records appended since the last look; a torn last line ends the pass
+    in.seekg(static_cast<std::streamoff>(logOffset));
+    std::string line;
+    bool torn = false;
+    while (std::getline(in, line))
+    {
+        nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+        if (in.eof() || record.is_discarded() || !record.contains("op"))
+        {
+            torn = true;
+            break;
+        }
+        logOffset += line.size() + 1;
+        try
+        {
+            applyRecord(record, fileMaps);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Skipping bad seat log record: " << e.what() << std::endl;
+        }
+    }
+    in.close();
+
+    // Cut the torn record off so new appends start on a clean line
+    if (torn && repairTornRecord)
+    {
+        std::cerr << "Discarding incomplete record at the end of " << logFile << std::endl;
+        std::filesystem::resize_file(logFile, static_cast<std::uintmax_t>(logOffset));
+    }
+}
+
+void SeatInventory::applyRecord(const nlohmann::json& record, SeatMaps* fileMaps)
+{
+    const std::string op = record.at("op").get<std::string>();
+    if (op == "applied")
+    {
+        settled.merge(AppliedTransactions::fromJson(record.at("transactions")));
+    }
+    else if (op == "claim")
+    {
+        auto seats = record.at("seats").get<std::vector<SeatRef>>();
+        for (const auto &seat : seats)
+        {
+            takeSeat(fileMaps, seat);
+        }
+        pendingClaims[record.at("journal").get<std::string>()][record.at("txn").get<std::uint64_t>()] = std::move(seats);
+    }
+    else if (op == "commit")
+    {
+        if (record.contains("journal"))
+        {
+            TransactionStamp stamp{record.at("journal").get<std::string>(), record.at("txn").get<std::uint64_t>(), 0};
+            auto claims = pendingClaims.find(stamp.journal);
+            if (claims != pendingClaims.end() && claims->second.erase(stamp.txn) > 0 && claims->second.empty())
+            {
+                pendingClaims.erase(claims);
+            }
+            settled.add(stamp);
+        }
+        for (const auto &seat : record.at("claim").get<std::vector<SeatRef>>())
+        {
+            takeSeat(fileMaps, seat);
+        }
+        for (const auto &seat : record.at("release").get<std::vector<SeatRef>>())
+        {
+            freeSeat(fileMaps, seat);
+        }
+    }
+    else if (op == "abort")
+    {
+        auto claims = pendingClaims.find(record.at("journal").get<std::string>());
+        if (claims != pendingClaims.end())
+        {
+            auto first = claims->second.upper_bound(record.at("after").get<std::uint64_t>());
+            for (auto it = first; it != claims->second.end(); ++it)
+            {
+                for (const auto &seat : it->second)
+                {
+                    freeSeat(fileMaps, seat);
+                }
+            }
+            claims->second.erase(first, claims->second.end());
+            if (claims->second.empty())
+            {
+                pendingClaims.erase(claims);
+            }
+        }
+    }
+}
+
+void SeatInventory::takeSeat(SeatMaps* fileMaps, const SeatRef& seat)
+{
+    if (auto seatMap = logged(fileMaps, seat))
+    {
+        seatMap->sell(seat.second);
+    }
+}
+
+void SeatInventory::freeSeat(SeatMaps* fileMaps, const SeatRef& seat)
+{
+    if (auto seatMap = logged(fileMaps, seat))
+    {
+        seatMap->unsell(seat.second, false);
+    }
+}
+
+std::shared_ptr<SeatMap> SeatInventory::logged(SeatMaps* fileMaps, const SeatRef& seat) const
+{
+    std::shared_ptr<SeatMap> seatMap;
+    if (fileMaps)
+    {
+        auto fileMap = fileMaps->find(seat.first);
+        seatMap = fileMap != fileMaps->end() ? fileMap->second : nullptr;
+    }
+    else
+    {
+        seatMap = findSeatMap(seat.first);
+    }
+    return seatMap && seat.second >= 0 && seat.second < seatMap->getSeatCount() ? seatMap : nullptr;
+}
+
+void SeatInventory::appendLog(const nlohmann::json& record)
+{
+    if (!log)
+    {
+        openLog();
+    }
+    std::string line = record.dump();
+    line.push_back('\n');
+    if (std::fwrite(line.data(), 1, line.size(), log.get()) != line.size())
+    {
+        // Cut off whatever part of the record got written
+        std::error_code ec;
+        std::filesystem::resize_file(logFile, static_cast<std::uintmax_t>(logOffset), ec);
+        throw std::runtime_error("Failed to append to file: " + logFile);
+    }
+    logOffset += line.size();
+}
+
+void SeatInventory::openLog()
+{
+    std::FILE* file = JsonUtils::openShared(logFile, "ab");
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open file: " + logFile);
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    log.reset(file, [](std::FILE* opened) { std::fclose(opened); });
+}
+
+void SeatInventory::mergeFromFile(const SeatMaps& fileMaps, JsonUtils::FileVersion version)
+{
+    std::unique_lock<std::shared_mutex> lock(seatMapsMutex);
+
+    // Flights we had synced that are gone from the file were removed elsewhere
+    for (auto it = seatMaps.begin(); it != seatMaps.end();)
+    {
+        if (!fileMaps.count(it->first) && syncedFlights.count(it->first))
+        {
+            it = seatMaps.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    std::set<std::string, std::less<>> fileFlights;
+    for (const auto &[flightNumber, fileMap] : fileMaps)
+    {
+        auto ours = seatMaps.find(flightNumber);
+        bool synced = syncedFlights.count(flightNumber) > 0;
+
+        if (ours == seatMaps.end())
+        {
+            // New elsewhere, unless we removed it ourselves since the last sync
+            if (!synced)
+            {
+                seatMaps.emplace(flightNumber, fileMap);
+            }
+        }
+        else if (ours->second->getRows() == fileMap->getRows() && ours->second->getCols() == fileMap->getCols())
+        {
+            // Taken in the files or held here; nothing else is taken. A held seat taken
+            // elsewhere stays booked, but is no longer ours to release.
+            ours->second->setSoldWords(fileMap->getSoldWords());
+        }
+        else if (synced)
+        {
+            ours->second = fileMap; // Cabin was resized elsewhere
+        }
+
+        fileFlights.insert(flightNumber);
+    }
+
+    syncedFlights = std::move(fileFlights);
+    syncedVersion = version;
+}
+
+void SeatInventory::importFromJson()
+{
+    nlohmann::json seatsJson = JsonUtils::readJsonFromFile(legacyJsonFile);
+
+    for (const auto &[flightNumber, flightSeats] : seatsJson.items())
+    {
+        auto seatMap = std::make_shared<SeatMap>(flightSeats.at("rows").get<int>(), flightSeats.at("cols").get<int>());
+        for (const auto &[label, state] : flightSeats.at("seats").items())
+        {
+            int index = seatMap->seatIndex(label);
+            if (index >= 0 && state == "booked")
+            {
+                seatMap->sell(index);
+            }
+        }
+        seatMaps[flightNumber] = std::move(seatMap);
+    }
+}
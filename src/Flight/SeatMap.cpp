@@ -0,0 +1,291 @@
+#include "../../include/Flight/SeatMap.hpp"
+#include <stdexcept>
+
+namespace
+{
+    int countBits(std::uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        int count = 0;
+        for (; word; word &= word - 1)
+        {
+            count++;
+        }
+        return count;
+#endif
+    }
+}
+
+SeatMap::SeatMap(int rows, int cols) : rows(rows), cols(cols)
+{
+    if (rows < 0 || cols <= 0 || cols > CabinLayout::maxColumns || rows > CabinLayout::maxRows)
+    {
+        throw std::invalid_argument("Invalid seat map dimensions");
+    }
+    layout = &CabinLayout::standard(rows, cols);
+    words = std::vector<std::atomic<std::uint64_t>>((static_cast<size_t>(rows) * cols + 63) / 64);
+    soldWords = std::vector<std::atomic<std::uint64_t>>(words.size());
+}
+
+SeatMap::SeatMap(const CabinLayout& layout) : rows(layout.getRows()), cols(layout.getCols()), layout(&layout)
+{
+    words = std::vector<std::atomic<std::uint64_t>>((static_cast<size_t>(rows) * cols + 63) / 64);
+    soldWords = std::vector<std::atomic<std::uint64_t>>(words.size());
+}
+
+void SeatMap::setLayout(const CabinLayout& newLayout)
+{
+    if (newLayout.getRows() != rows || newLayout.getCols() != cols)
+    {
+        throw std::invalid_argument("Cabin layout doesn't fit the seat map");
+    }
+    layout = &newLayout;
+}
+
+int SeatMap::seatIndex(std::string_view label) const
+{
+    return layout ? layout->seatIndex(label) : -1;
+}
+
+std::string SeatMap::seatLabel(int index) const
+{
+    return layout->seatLabel(index);
+}
+
+bool SeatMap::isBooked(int index) const
+{
+    return (words[index >> 6].load(std::memory_order_acquire) >> (index & 63)) & 1u;
+}
+
+bool SeatMap::book(int index)
+{
+    std::uint64_t mask = std::uint64_t{1} << (index & 63);
+    std::atomic<std::uint64_t> &word = words[index >> 6];
+    std::uint64_t current = word.load(std::memory_order_relaxed);
+    do
+    {
+        if (current & mask)
+        {
+            return false; // Someone else holds the seat
+        }
+    } while (!word.compare_exchange_weak(current, current | mask, std::memory_order_acq_rel, std::memory_order_relaxed));
+    return true;
+}
+
+bool SeatMap::release(int index)
+{
+    std::uint64_t mask = std::uint64_t{1} << (index & 63);
+    std::atomic<std::uint64_t> &word = words[index >> 6];
+    std::uint64_t current = word.load(std::memory_order_relaxed);
+    do
+    {
+        if (!(current & mask))
+        {
+            return false; // Seat is already free
+        }
+    } while (!word.compare_exchange_weak(current, current & ~mask, std::memory_order_acq_rel, std::memory_order_relaxed));
+    return true;
+}
+
+bool SeatMap::move(int fromIndex, int toIndex)
+{
+    if (fromIndex == toIndex)
+    {
+        return isBooked(toIndex);
+    }
+
+    if ((fromIndex >> 6) != (toIndex >> 6))
+    {
+        // Different words: claim the new seat first so the passenger never holds none
+        if (!book(toIndex))
+        {
+            return false;
+        }
+        release(fromIndex);
+        return true;
+    }
+
+    // Same word: swap both bits in one CAS
+    std::uint64_t fromMask = std::uint64_t{1} << (fromIndex & 63);
+    std::uint64_t toMask = std::uint64_t{1} << (toIndex & 63);
+    std::atomic<std::uint64_t> &word = words[toIndex >> 6];
+    std::uint64_t current = word.load(std::memory_order_relaxed);
+    do
+    {
+        if (current & toMask)
+        {
+            return false;
+        }
+    } while (!word.compare_exchange_weak(current, (current | toMask) & ~fromMask, std::memory_order_acq_rel, std::memory_order_relaxed));
+    return true;
+}
+
+bool SeatMap::isSold(int index) const
+{
+    return (soldWords[index >> 6].load(std::memory_order_acquire) >> (index & 63)) & 1u;
+}
+
+bool SeatMap::isHeld(int index) const
+{
+    return isBooked(index) && !isSold(index);
+}
+
+void SeatMap::sell(int index)
+{
+    // Sold before booked: releaseHold checks in the other order, so it never frees a sold seat
+    std::uint64_t mask = std::uint64_t{1} << (index & 63);
+    soldWords[index >> 6].fetch_or(mask, std::memory_order_acq_rel);
+    words[index >> 6].fetch_or(mask, std::memory_order_acq_rel);
+}
+
+void SeatMap::unsell(int index, bool keepHeld)
+{
+    // Only a seat that was sold is freed; a held one stays held
+    std::uint64_t mask = std::uint64_t{1} << (index & 63);
+    bool wasSold = soldWords[index >> 6].fetch_and(~mask, std::memory_order_acq_rel) & mask;
+    if (wasSold && !keepHeld)
+    {
+        words[index >> 6].fetch_and(~mask, std::memory_order_acq_rel);
+    }
+}
+
+bool SeatMap::releaseHold(int index)
+{
+    if (isSold(index) || !release(index))
+    {
+        return false;
+    }
+    if (isSold(index))
+    {
+        // Sold meanwhile: it stays booked
+        words[index >> 6].fetch_or(std::uint64_t{1} << (index & 63), std::memory_order_acq_rel);
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::uint64_t> SeatMap::getSoldWords() const
+{
+    std::vector<std::uint64_t> copy(soldWords.size());
+    for (size_t i = 0; i < soldWords.size(); ++i)
+    {
+        copy[i] = soldWords[i].load(std::memory_order_acquire);
+    }
+    return copy;
+}
+
+void SeatMap::setSoldWords(const std::vector<std::uint64_t>& sold)
+{
+    if (sold.size() != words.size())
+    {
+        throw std::invalid_argument("Seat maps of different sizes can't be merged");
+    }
+
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        // Seats held here stay booked unless they are sold now; holds taken meanwhile are kept
+        std::uint64_t wasSold = soldWords[i].exchange(sold[i], std::memory_order_acq_rel);
+        std::uint64_t current = words[i].load(std::memory_order_relaxed);
+        std::uint64_t merged;
+        do
+        {
+            merged = sold[i] | (current & ~wasSold);
+        } while (!words[i].compare_exchange_weak(current, merged, std::memory_order_acq_rel, std::memory_order_relaxed));
+    }
+}
+
+std::uint64_t SeatMap::getRowMask(int row) const
+{
+    // A row may straddle two words
+    size_t first = static_cast<size_t>(row) * cols;
+    unsigned shift = static_cast<unsigned>(first & 63);
+    std::uint64_t bits = words[first >> 6].load(std::memory_order_acquire) >> shift;
+    if (shift + cols > 64)
+    {
+        bits |= words[(first >> 6) + 1].load(std::memory_order_acquire) << (64 - shift);
+    }
+    return bits & ((std::uint64_t{1} << cols) - 1);
+}
+
+int SeatMap::getBookedCount() const
+{
+    int booked = 0;
+    for (const auto &word : words)
+    {
+        booked += countBits(word.load(std::memory_order_relaxed));
+    }
+    return booked;
+}
+
+std::vector<std::uint64_t> SeatMap::getWords() const
+{
+    std::vector<std::uint64_t> copy(words.size());
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        copy[i] = words[i].load(std::memory_order_acquire);
+    }
+    return copy;
+}
+
+void SeatMap::merge(const std::vector<std::uint64_t>& base, const std::vector<std::uint64_t>& other)
+{
+    if (base.size() != words.size() || other.size() != words.size())
+    {
+        throw std::invalid_argument("Seat maps of different sizes can't be merged");
+    }
+
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        std::uint64_t current = words[i].load(std::memory_order_relaxed);
+        std::uint64_t merged;
+        do
+        {
+            std::uint64_t changedHere = current ^ base[i];
+            merged = (other[i] & ~changedHere) | (current & changedHere);
+        } while (!words[i].compare_exchange_weak(current, merged, std::memory_order_acq_rel, std::memory_order_relaxed));
+    }
+}
+
+void SeatMap::writeTo(std::ostream& out) const
+{
+    writeTo(out, rows, cols, getWords());
+}
+
+void SeatMap::writeTo(std::ostream& out, int rows, int cols, const std::vector<std::uint64_t>& words)
+{
+    // uint16 rows, uint8 cols, then ceil(rows * cols / 8) bitset bytes (little-endian)
+    out.put(static_cast<char>(rows & 0xFF));
+    out.put(static_cast<char>((rows >> 8) & 0xFF));
+    out.put(static_cast<char>(cols));
+
+    size_t byteCount = (static_cast<size_t>(rows) * cols + 7) / 8;
+    for (size_t i = 0; i < byteCount; ++i)
+    {
+        out.put(static_cast<char>((words[i / 8] >> (8 * (i % 8))) & 0xFF));
+    }
+}
+
+SeatMap SeatMap::readFrom(std::istream& in)
+{
+    unsigned char header[3];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        throw std::runtime_error("Truncated seat map");
+    }
+
+    SeatMap seatMap(header[0] | (header[1] << 8), header[2]);
+    size_t byteCount = (static_cast<size_t>(seatMap.getSeatCount()) + 7) / 8;
+    for (size_t i = 0; i < byteCount; ++i)
+    {
+        int byte = in.get();
+        if (byte == EOF)
+        {
+            throw std::runtime_error("Truncated seat map");
+        }
+        seatMap.words[i / 8].fetch_or(static_cast<std::uint64_t>(byte) << (8 * (i % 8)), std::memory_order_relaxed);
+        seatMap.soldWords[i / 8].fetch_or(static_cast<std::uint64_t>(byte) << (8 * (i % 8)), std::memory_order_relaxed);
+    }
+    return seatMap;
+}
@@ -10,22 +10,51 @@ void ReportGenerator::generateFlightPerformanceReport(const std::string& month,
     double totalRevenue = 0.0;
     auto flights = flightService.getFlightsForReport();
 
-    // Loop through flights and reservations to calculate metrics
-    for (const auto& flight : flights)
+    // The month as a [start, end) range of epoch seconds
+    const std::int64_t periodStart = Timestamp::parse(year + "-" + month + "-01");
+    if (periodStart == Timestamp::invalid)
     {
+        std::cout << "Invalid month or year." << std::endl;
+        return;
+    }
+    const std::int64_t periodEnd = Timestamp::startOfNextMonth(periodStart);
+
+    // Aggregate reservations per flight once, then join them with the month's flights
+    const auto reservationTotals = reservationService.countReservationsAndRevenueByFlight();
+    struct FlightRow
+    {
+        const Flight* flight;
+        int reservationsCount;
+        double revenue;
+    };
+    std::vector<FlightRow> rows;
+
+    for (const auto& flightEntry : *flights)
+    {
+        const Flight &flight = *flightEntry;
         // Check if flight is in the specified month/year
-        if (flight.getDepartureDate().substr(0, 7) == year + "-" + month) 
+        if (flight.getDepartureTime() < periodStart || flight.getDepartureTime() >= periodEnd)
         {
-            totalFlightsScheduled++;
-            if (flight.getStatus() == "Completed") flightsCompleted++;
-            else if (flight.getStatus() == "Delayed") flightsDelayed++;
-            else if (flight.getStatus() == "Canceled") flightsCanceled++;
+            continue;
+        }
 
-            // Calculate reservations and revenue for this flight
-            auto [reservationsCount, revenue] = reservationService.countReservationsAndRevenue(flight.getFlightNumber());
-            totalReservations += reservationsCount;
-            totalRevenue += revenue;
+        totalFlightsScheduled++;
+        if (flight.getStatus() == "Completed") flightsCompleted++;
+        else if (flight.getStatus() == "Delayed") flightsDelayed++;
+        else if (flight.getStatus() == "Canceled") flightsCanceled++;
+
+        // Look up reservations and revenue for this flight
+        int reservationsCount = 0;
+        double revenue = 0.0;
+        auto totals = reservationTotals.find(flight.getFlightNumberSymbol());
+        if (totals != reservationTotals.end())
+        {
+            reservationsCount = totals->second.first;
+            revenue = totals->second.second;
         }
+        totalReservations += reservationsCount;
+        totalRevenue += revenue;
+        rows.push_back({&flight, reservationsCount, revenue});
     }
 
     // Display the report
@@ -39,25 +68,21 @@ void ReportGenerator::generateFlightPerformanceReport(const std::string& month,
     std::cout << "Total Revenue: $" << totalRevenue << std::endl;
     std::cout << "----------------------------------------"<<std::endl;
 
-    totalFlightsScheduled = 0;
-    // Loop through flights to get performance of each flight
-    for (const auto& flight : flights)
+    // Performance of each flight
+    int position = 0;
+    for (const auto& row : rows)
     {
-        // Check if flight is in the specified month/year
-        if (flight.getDepartureDate().substr(0, 7) == year + "-" + month) 
+        const Flight &flight = *row.flight;
+        position++;
+        if (flight.getStatus() == "Completed" || flight.getStatus() == "Delayed") 
+        {   
+            std::cout<<position<<". "<<"Flight "<<flight.getFlightNumber()<<": ";
+            std::cout<<flight.getStatus()<<" ("<<row.reservationsCount<<"Bookings, "<<row.revenue<<")"<<std::endl;
+        }
+        else if (flight.getStatus() == "Canceled")
         {
-            totalFlightsScheduled++;
-            auto [reservationsCount, revenue] = reservationService.countReservationsAndRevenue(flight.getFlightNumber());
-            if (flight.getStatus() == "Completed" || flight.getStatus() == "Delayed") 
-            {   
-                std::cout<<totalFlightsScheduled<<". "<<"Flight "<<flight.getFlightNumber()<<": ";
-                std::cout<<flight.getStatus()<<" ("<<reservationsCount<<"Bookings, "<<revenue<<")"<<std::endl;
-            }
-            else if (flight.getStatus() == "Canceled")
-            {
-                std::cout<<totalFlightsScheduled<<". "<<"Flight "<<flight.getFlightNumber()<<": ";
-                std::cout<<flight.getStatus()<<std::endl;
-            }
+            std::cout<<position<<". "<<"Flight "<<flight.getFlightNumber()<<": ";
+            std::cout<<flight.getStatus()<<std::endl;
         }
     }
 }
@@ -85,16 +110,13 @@ void ReportGenerator::generateMaintenanceReport(const Aircraft& aircraft) const
 
 void ReportGenerator::generateUserActivityReport(const std::optional<std::string>& userId) const
 {
-    // Read the activity log
-    nlohmann::json log;
-    std::ifstream logFile("data/reports/user_activity.json");
-    if (!logFile.good())
+    // Read the activity log (waits for queued entries to be written first)
+    nlohmann::json log = ActivityLogger::readLog();
+    if (log.empty())
     {
         std::cout << "No activity log found.\n";
         return;
     }
-    logFile >> log;
-    logFile.close();
 
     if (userId) // 🔹 Generate report for a specific user
     {
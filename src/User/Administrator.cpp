@@ -1,9 +1,10 @@
 #include "../../include/User/Administrator.hpp"
+#include "../../include/Utils/Snapshot.hpp"
 
 Administrator::Administrator(const std::string &id, const std::string &username, const std::string &password)
     : User(id, username, password, "Administrator")
 {
-    loadFlightsFromJson("data/flights.json");
+    loadFlights();
     loadAircraftFromJson("data/aircraft.json"); 
     loadUsersFromJson("data/users.json");
 }
@@ -15,12 +16,9 @@ void Administrator::loadUsersFromJson(const std::string &filename)
 
     try
     {
-        auto usersJson = JsonUtils::readJsonFromFile(filename);
-
-        for (const auto &userJson : usersJson)
-        {
-            users.push_back(User::fromJson(userJson));
-        }
+        FileLock lock(JsonUtils::lockFileFor(filename), FileLock::Mode::Shared);
+        users = Snapshot::loadEntities<User>(filename);
+        usersVersion = JsonUtils::getFileVersion(filename);
     }
     catch (const std::exception &e)
     {
@@ -28,38 +26,15 @@ void Administrator::loadUsersFromJson(const std::string &filename)
     }
 }
 
-void Administrator::loadFlightsFromJson(const std::string &filename)
+void Administrator::loadFlights()
 {
-    // Clear the existing flights
+    // Take a working copy of the shared flight catalog
     flights.clear();
-
-    try
-    {
-        nlohmann::json flightsJson = JsonUtils::readJsonFromFile(filename);
-
-        for (const auto &flightJson : flightsJson)
-        {
-            flights.push_back(Flight::fromJson(flightJson));
-        }
-    }
-    catch (const std::exception &e)
-    {
-        std::cout << "Error loading flights from file: " << e.what() << std::endl;
-    }
-}
-
-void Administrator::saveFlightsToJson(const std::string &filename)
-{
-    nlohmann::json flightsJson;
-
-    // Save all flights
-    for (const auto &flight : flights)
+    auto catalogFlights = FlightCatalog::instance().getFlights();
+    for (const auto &flight : *catalogFlights)
     {
-        flightsJson.push_back(flight.toJson());
+        flights.push_back(*flight);
     }
-
-    // Use overwrite = true to replace the entire file
-    JsonUtils::saveJsonToFile(flightsJson, filename);
 }
 
 void Administrator::loadAircraftFromJson(const std::string &filename)
@@ -75,38 +50,10 @@ void Administrator::loadAircraftFromJson(const std::string &filename)
 
     try
     {
-        // Read the JSON data from the file
-        nlohmann::json aircraftsJson = JsonUtils::readJsonFromFile(filename);
-
-        // Debug: Print the JSON data to verify its structure
-       // std::cout << "Loaded JSON data: " << aircraftsJson.dump(4) << std::endl;
-
-        // Ensure the JSON data is an array
-        if (!aircraftsJson.is_array()) {
-            throw std::runtime_error("Invalid JSON structure: Expected an array of aircraft objects.");
-        }
-
-        // Handle nested array (if present)
-        nlohmann::json aircraftArray;
-        if (aircraftsJson.size() == 1 && aircraftsJson[0].is_array()) {
-            // If the outer array contains a single inner array, use the inner array
-            aircraftArray = aircraftsJson[0];
-        } else {
-            // Otherwise, assume the outer array contains the aircraft objects directly
-            aircraftArray = aircraftsJson;
-        }
-
-        // Parse each aircraft object
-        for (const auto &aircraftJson : aircraftArray)
-        {
-            // Ensure each item is an object
-            if (!aircraftJson.is_object()) {
-                throw std::runtime_error("Invalid JSON structure: Expected an aircraft object.");
-            }
-
-            // Convert JSON to Aircraft object and add to the list
-            aircrafts.push_back(Aircraft::fromJson(aircraftJson));
-        }
+        // Parse the aircraft objects as they are read; a nested [[...]] array is flattened
+        FileLock lock(JsonUtils::lockFileFor(filename), FileLock::Mode::Shared);
+        aircrafts = Snapshot::loadEntities<Aircraft>(filename);
+        aircraftVersion = JsonUtils::getFileVersion(filename);
 
        // std::cout << "Successfully loaded " << aircrafts.size() << " aircraft(s) from " << filename << std::endl;
     }
@@ -127,7 +74,9 @@ void Administrator::saveAircraftToJson(const std::string &filename)
     }
 
     // Use overwrite = true to replace the entire file
+    FileLock lock(JsonUtils::lockFileFor(filename));
     JsonUtils::saveJsonToFile(aircraftsJson, filename);
+    aircraftVersion = JsonUtils::getFileVersion(filename);
 }
 
 void Administrator::saveUsersToJson(const std::string &filename)
@@ -136,61 +85,60 @@ void Administrator::saveUsersToJson(const std::string &filename)
     for (const auto &user : users) {
         usersJson.push_back(user.toJson());
     }
+    FileLock lock(JsonUtils::lockFileFor(filename));
     JsonUtils::saveJsonToFile(usersJson, filename);
+    usersVersion = JsonUtils::getFileVersion(filename);
+}
+
+void Administrator::refreshUsers()
+{
+    if (JsonUtils::getFileVersion("data/users.json") != usersVersion)
+    {
+        loadUsersFromJson("data/users.json");
+    }
+}
+
+void Administrator::refreshAircraft()
+{
+    if (JsonUtils::getFileVersion("data/aircraft.json") != aircraftVersion)
+    {
+        loadAircraftFromJson("data/aircraft.json");
+    }
 }
 
 void Administrator::createSeatsForNewFlight(const std::string& flightNumber, const std::string& aircraftType) 
 {
-    nlohmann::json seatsData = JsonUtils::readJsonFromFile("data/seats.json");
+    SeatInventory& seatInventory = SeatInventory::instance();
 
-    // Check if flight already exists in seats.json
-    if (seatsData.contains(flightNumber)) 
+    // Check if flight already has a seat map
+    if (seatInventory.findSeatMap(flightNumber)) 
     {
         return; // Flight seats already exist
     }
 
-    nlohmann::json seatMap;
-    std::string seatLabels = "ABCDEF"; // Standard seat labels
-
-    int cols = 6;
-    int rows;
-    bool aircraftFound = false;
+    const CabinLayout *layout = nullptr;
 
-    // Get the correct row and column values from the aircraft vector
+    // Lay the cabin out for the aircraft type
     for (const auto& aircraft : aircrafts) 
     {
         if (aircraft.getAircraftType() == aircraftType) 
         {
-            rows = aircraft.getRows();
-            aircraftFound = true;
+            layout = &aircraft.getLayout();
             break;
         }
     }
 
-    if (!aircraftFound) 
+    if (!layout) 
     {
         std::cerr << "Error: Aircraft type not found!" << std::endl;
         std::cout << "Press any key to continue... " << std::endl;
         std::cin.get(); // Waits for a single character (e.g., Enter)
         return;
     }
-    for (int row = 1; row <= rows; row++) 
-    {
-        for (int col = 0; col < cols; col++) 
-        {
-            std::string seatId = std::to_string(row) + seatLabels[col];
-            seatMap[seatId] = "available";
-        }
-    }
 
-    // Store the seat data
-    seatsData[flightNumber] = {
-        {"rows", rows},
-        {"cols", cols},
-        {"seats", seatMap}
-    };
-
-    JsonUtils::saveJsonToFile(seatsData, "data/seats.json");
+    // Store an empty seat map (every seat available)
+    seatInventory.createSeatMap(flightNumber, *layout);
+    seatInventory.save();
     std::cout << "Press any key to continue... " << std::endl;
         std::cin.get(); // Waits for a single character (e.g., Enter)
 }
@@ -207,6 +155,10 @@ bool Administrator::createUser(const User& newUser)
         return false;
     }
 
+    // Check against the latest saved users and keep other writers out until we've saved
+    FileLock lock(JsonUtils::lockFileFor("data/users.json"));
+    refreshUsers();
+
     // Check for duplicate user ID or username
     for (const auto &user : users)
     {
@@ -245,6 +197,9 @@ void Administrator::updateUser(const std::string &id, const User& updatedUser)
         return;
     }
 
+    FileLock lock(JsonUtils::lockFileFor("data/users.json"));
+    refreshUsers();
+
     // Search for the user by ID
     for (auto &user : users)
     {
@@ -266,6 +221,9 @@ void Administrator::updateUser(const std::string &id, const User& updatedUser)
 
 void Administrator::deleteUser(const std::string &id)
 {
+    FileLock lock(JsonUtils::lockFileFor("data/users.json"));
+    refreshUsers();
+
     // Remove the user from the vector
     auto initialSize = users.size();
     users.erase(std::remove_if(users.begin(), users.end(),
@@ -277,12 +235,7 @@ void Administrator::deleteUser(const std::string &id)
     if (users.size() < initialSize)
     {
         // Save the updated vector to the JSON file
-        nlohmann::json usersJson;
-        for (const auto &user : users)
-        {
-            usersJson.push_back(user.toJson());
-        }
-        JsonUtils::saveJsonToFile(usersJson, "data/users.json");
+        saveUsersToJson("data/users.json");
 
         // Log the activity
         activityLogger.logActivity(id, "admin", "Deleted user", "User ID: " + id);
@@ -297,6 +250,8 @@ void Administrator::deleteUser(const std::string &id)
 
 void Administrator::addAircraft(const Aircraft &aircraft)
 {
+    FileLock lock(JsonUtils::lockFileFor("data/aircraft.json"));
+    refreshAircraft();
     aircrafts.push_back(aircraft);
     activityLogger.logActivity(id, "admin", "Added Aircraft", "Aircraft Id: " + aircraft.getId());
     saveAircraftToJson("data/aircraft.json");
@@ -304,6 +259,8 @@ void Administrator::addAircraft(const Aircraft &aircraft)
 
 void Administrator::updateAircraft(const std::string &aircraftId, const Aircraft &updatedAircraft)
 {
+    FileLock lock(JsonUtils::lockFileFor("data/aircraft.json"));
+    refreshAircraft();
 
     for (auto &aircraft : aircrafts)
     {
@@ -322,6 +279,9 @@ void Administrator::updateAircraft(const std::string &aircraftId, const Aircraft
 
 void Administrator::deleteAircraft(const std::string &aircraftId)
 {
+    FileLock lock(JsonUtils::lockFileFor("data/aircraft.json"));
+    refreshAircraft();
+
     // Remove the aircraft from the vector
     auto initialSize = aircrafts.size();
     aircrafts.erase(std::remove_if(aircrafts.begin(), aircrafts.end(),
@@ -333,12 +293,7 @@ void Administrator::deleteAircraft(const std::string &aircraftId)
     if (aircrafts.size() < initialSize)
     {
         // Save the updated vector to the JSON file
-        nlohmann::json aircraftsJson;
-        for (const auto &aircraft : aircrafts)
-        {
-            aircraftsJson.push_back(aircraft.toJson());
-        }
-        JsonUtils::saveJsonToFile(aircraftsJson, "data/aircraft.json");
+        saveAircraftToJson("data/aircraft.json");
 
         // Log the activity
         activityLogger.logActivity(aircraftId, "admin", "Deleted aircraft", "Aircraft ID: " + aircraftId);
@@ -354,21 +309,27 @@ void Administrator::deleteAircraft(const std::string &aircraftId)
 
 void Administrator::addFlight(const Flight &flight)
 {
-    createSeatsForNewFlight(flight.getFlightNumber(), flight.getAircraftType()); // Ensure seat map is created
+    createSeatsForNewFlight(std::string(flight.getFlightNumber()), std::string(flight.getAircraftType())); // Ensure seat map is created
     flights.push_back(flight);
-    activityLogger.logActivity(id, "admin", "Added Flight", "Flight Number: " + flight.getFlightNumber());
-    saveFlightsToJson("data/flights.json");
+    FlightCatalog::instance().addFlight(flight);
+    activityLogger.logActivity(id, "admin", "Added Flight", "Flight Number: " + std::string(flight.getFlightNumber()));
 }
-void Administrator::updateFlight(const std::string &flightNumber, const Flight &updatedFlight)
+void Administrator::updateFlight(std::string_view flightNumber, const Flight &updatedFlight)
 {
     for (auto &flight : flights)
     {
         if (flight.getFlightNumber() == flightNumber)
         {
+            // Refused if the flight was removed meanwhile or the new number is another flight's
+            if (!FlightCatalog::instance().updateFlight(flightNumber, updatedFlight))
+            {
+                std::cout << "Flight details couldn't be updated: the flight is gone or flight "
+                          << updatedFlight.getFlightNumber() << " already exists." << std::endl;
+                return;
+            }
             // Update the flight's data with the new data
             flight = updatedFlight;
-            saveFlightsToJson("data/flights.json");
-            activityLogger.logActivity(id, "admin", "Updated Flight", "Flight Number: " + flight.getFlightNumber());
+            activityLogger.logActivity(id, "admin", "Updated Flight", "Flight Number: " + std::string(flight.getFlightNumber()));
             std::cout<<"Flight details updated successfully!"<<std::endl;
             return;
         }
@@ -396,15 +357,10 @@ void Administrator::deleteFlight(const std::string &flightNumber)
     // Check if a flight was deleted
     if (flights.size() < initialSize)
     {
-        // Save the updated vector to the JSON file
-        nlohmann::json flightsJson;
-        for (const auto &flight : flights)
-        {
-            flightsJson.push_back(flight.toJson());
-        }
-        JsonUtils::saveJsonToFile(flightsJson, "data/flights.json");
+        // Remove it from the catalog and its indexes
+        FlightCatalog::instance().removeFlight(flightNumber);
 
-        // Remove the flight's seat data from seats.json
+        // Remove the flight's seat map
         removeFlightSeats(flightNumber);
 
         // Log the activity
@@ -420,23 +376,11 @@ void Administrator::deleteFlight(const std::string &flightNumber)
 void Administrator::removeFlightSeats(const std::string &flightNumber)
 {
 
-    // Read the seats.json file
-    nlohmann::json seatsJson;
-    std::ifstream file("data/seats.json");
-    if (file.good())
-    {
-        file >> seatsJson;
-        file.close();
-    }
-
-    // Check if the flight exists in the seats data
-    if (seatsJson.contains(flightNumber))
+    // Remove the flight's seat map if it has one
+    SeatInventory& seatInventory = SeatInventory::instance();
+    if (seatInventory.removeSeatMap(flightNumber))
     {
-        // Remove the flight's seat data
-        seatsJson.erase(flightNumber);
-
-        // Save the updated seats data to the JSON file using JsonUtils::saveJsonToFile
-        JsonUtils::saveJsonToFile(seatsJson, "data/seats.json");
+        seatInventory.save();
 
         std::cout << "Seat data for flight " << flightNumber << " removed successfully." << std::endl;
     }
@@ -483,7 +427,7 @@ void Administrator::viewFlights() const
         std::cout << "Departure: " << flight.getDepartureDateAndTime() << std::endl;
         std::cout << "Arrival: " << flight.getArrivalDate()  << std::endl;
         std::cout << "Aircraft: " << flight.getAircraftType() << std::endl;
-        std::cout << "Available Seats: " << flight.getAvailableSeats() << std::endl;
+        std::cout << "Available Seats: " << flightService.getAvailableSeats(flight) << std::endl;
         std::cout << "Price: $" << std::fixed << std::setprecision(2) << flight.getPrice() << std::endl;
         std::cout << "-------------------------" << std::endl;
     }
@@ -596,6 +540,10 @@ void Administrator::adminMenu()
 {
     while (true)
     {
+        // Pick up users and aircraft saved by other sessions (only parsed if they changed)
+        refreshUsers();
+        refreshAircraft();
+
         int choice;
         Utils::clearScreen();
         std::cout << "--- Administrator Menu ---" << std::endl;
@@ -932,11 +880,11 @@ void Administrator::addFlightMenu()
 
     for (const auto &aircraft : aircrafts)
     {
-        if (aircraft.getId() == aircraftId) // Get total seats from Aircraft capacity
+        if (aircraft.getId() == aircraftId) // Get total seats from the aircraft's cabin layout
         {
-            totalSeats = aircraft.getCapacity();
+            totalSeats = aircraft.getSeatCount();
             aircraftType = aircraft.getAircraftType();
-            std::cout << "Aircraft " << aircraftId << " has a capacity of " << totalSeats << " seats." << std::endl;
+            std::cout << "Aircraft " << aircraftId << " has " << totalSeats << " seats." << std::endl;
             aircraftFound = true;
             break;
         }
@@ -1154,13 +1102,15 @@ void Administrator::assignCrewToFlight(const std::string &flightNumber)
         return;
     }
 
-    Flight &flight = flightOpt.value().get();
+    Flight flight = *flightOpt;
 
     // Create a CrewService instance
     CrewService crewService("data/crew.json");
     crewService.assignCrewToFlight(flightNumber, flight);
 
-    saveFlightsToJson("data/flights.json");
+    // Store the crewed flight through the catalog and refresh our copy
+    FlightCatalog::instance().updateFlight(flightNumber, flight);
+    loadFlights();
     std::cout << "Crew assigned successfully to flight " << flightNumber << "!" << std::endl;
     activityLogger.logActivity(id, "admin", "Assigned Crew", "Flight Number: " + flightNumber);
 }
@@ -3,60 +3,44 @@
 BookingAgent::BookingAgent(const std::string &id, const std::string &username, const std::string &password):
 User(id, username, password, "Booking Agent") 
 {
-    loadReservationsFromJson("data/reservations.json");
 }
 
 
-
-void BookingAgent::loadReservationsFromJson(const std::string &filename)
+void BookingAgent::searchFlights(const std::string &origin, const std::string &destination, const std::string &departureDate) const
 {
-    // Clear the existing reservations
-    reservations.clear();
+    flightService.searchFlights(origin,destination,departureDate);
+    activityLogger.logActivity(id, "booking agent", "Searched Flights");
+}
 
-    try
-    {
-        nlohmann::json reservationsJson = JsonUtils::readJsonFromFile(filename);
 
-        for (const auto &reservationJson : reservationsJson)
-        {
-            reservations.push_back(Reservation::fromJson(reservationJson));
-        }
-    }
-    catch (const std::exception &e)
+bool BookingAgent::bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails,
+                              const std::optional<SeatHold>& seatHold)
+{
+    if (reservationService.bookFlight(reservation, paymentMethod, paymentDetails, seatHold))
     {
-        std::cout << "Error loading reservations from file: " << e.what() << std::endl;
+        activityLogger.logActivity(id, "booking agent", "Booked Flight", "Reservation ID: " + reservation.getReservationId());
+        return true;
     }
+    return false;
 }
 
-void BookingAgent::saveReservationsToJson(const std::string &filename)
+bool BookingAgent::bookGroup(std::vector<Reservation> &reservations, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails,
+                             const std::vector<SeatHold>& seatHolds)
 {
-    nlohmann::json reservationsJson;
-
-    // Save all reservations
-    for (const auto &reservation : reservations)
+    if (reservationService.bookGroup(reservations, paymentMethod, paymentDetails, seatHolds))
     {
-        reservationsJson.push_back(reservation.toJson());
+        activityLogger.logActivity(id, "booking agent", "Booked Group",
+                                   std::to_string(reservations.size()) + " reservations on flight " + std::string(reservations.front().getFlightNumber()));
+        return true;
     }
-
-    // Use overwrite = true to replace the entire file
-    JsonUtils::saveJsonToFile(reservationsJson, filename);
-}
-
-
-void BookingAgent::searchFlights(const std::string &origin, const std::string &destination, const std::string &departureDate) const
-{
-    flightService.searchFlights(origin,destination,departureDate);
-    activityLogger.logActivity(id, "booking agent", "Searched Flights");
+    return false;
 }
 
-
-bool BookingAgent::bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails)
+bool BookingAgent::joinWaitlist(WaitlistEntry &entry)
 {
-    if (reservationService.bookFlight(reservation, paymentMethod, paymentDetails))
+    if (reservationService.joinWaitlist(entry))
     {
-        reservations.push_back(reservation);
-        saveReservationsToJson("data/reservations.json");
-        activityLogger.logActivity(id, "booking agent", "Booked Flight", "Reservation ID: " + reservation.getReservationId());
+        activityLogger.logActivity(id, "booking agent", "Joined Waitlist", "Passenger ID: " + entry.passengerId + ", Flight: " + entry.flightNumber);
         return true;
     }
     return false;
@@ -64,16 +48,11 @@ bool BookingAgent::bookFlight(Reservation &reservation, const std::string& payme
 
 void BookingAgent::updateReservation(const std::string &reservationId, const Reservation &updatedReservation)
 {
-    for (auto &reservation : reservations)
+    // Update the reservation's data with the new data
+    if (updatedReservation.getReservationId() == reservationId && reservationService.updateReservation(updatedReservation))
     {
-        if (reservation.getReservationId() == reservationId)
-        {
-            // Update the reservation's data with the new data
-            reservation = updatedReservation;
-            saveReservationsToJson("data/reservations.json");
-            activityLogger.logActivity(id, "booking agent", "Updated Reservation", "Reservation ID: " + reservation.getReservationId());
-            return;
-        }
+        activityLogger.logActivity(id, "booking agent", "Updated Reservation", "Reservation ID: " + reservationId);
+        return;
     }
     // If reservation isn't found
     std::cout << "The reservation given doesn't exist" << std::endl;
@@ -81,19 +60,22 @@ void BookingAgent::updateReservation(const std::string &reservationId, const Res
 
 void BookingAgent::cancelReservation(const std::string &reservationId)
 {
-    // Find the reservation in the vector
-    auto it = std::find_if(reservations.begin(), reservations.end(),
-                           [&reservationId](const Reservation &reservation)
-                           {
-                               return reservation.getReservationId() == reservationId;
-                           });
-
-    if (it != reservations.end()) // Reservation found
+    // Find the reservation
+    auto reservationOpt = reservationService.findReservation(reservationId);
+
+    if (reservationOpt) // Reservation found
     {
+        // Free the seat and remove the reservation together
+        if (!reservationService.cancelReservation(reservationId))
+        {
+            std::cout << "Reservation with ID " << reservationId << " could not be cancelled." << std::endl;
+            return;
+        }
+
         // Process refund if payment was made
-        if (it->getPaymentStatus() == "Paid")
+        if (reservationOpt->getPaymentStatus() == "Paid")
         {
-            if (paymentService.processRefund(it->getPaymentMethod(), it->getPrice(), it->getPaymentDetails()))
+            if (paymentService.processRefund(reservationOpt->getPaymentMethod(), reservationOpt->getPrice(), reservationOpt->getPaymentDetails()))
             {
                 std::cout << "Refund processed successfully." << std::endl;
             }
@@ -107,81 +89,6 @@ void BookingAgent::cancelReservation(const std::string &reservationId)
             std::cout << "No refund required." << std::endl;
         }
 
-        // Change the seat back to available in seats.json
-        std::string flightNumber = it->getFlightNumber();
-        std::string seatNumber = it->getSeatNumber();
-
-        // Read seats.json
-        nlohmann::json seatsData;
-        try {
-            seatsData = JsonUtils::readJsonFromFile("data/seats.json");
-        } catch (const std::runtime_error &e) {
-            std::cerr << e.what() << std::endl;
-            return;
-        }
-
-        // Check if the flight exists in seats.json
-        if (seatsData.contains(flightNumber) && seatsData[flightNumber]["seats"].contains(seatNumber))
-        {
-            // Mark the seat as available
-            seatsData[flightNumber]["seats"][seatNumber] = "available";
-        }
-        else
-        {
-            std::cout << "Flight or seat not found in seats.json." << std::endl;
-        }
-
-        // Update available seats in flights.json
-        nlohmann::json flightsData;
-        try {
-            flightsData = JsonUtils::readJsonFromFile("data/flights.json");
-        } catch (const std::runtime_error &e) {
-            std::cerr << e.what() << std::endl;
-            return;
-        }
-
-        // Find the flight in flights.json
-        auto flightIt = std::find_if(flightsData.begin(), flightsData.end(), [&](const nlohmann::json &flight)
-                                      { return flight["flightNumber"] == flightNumber; });
-
-        if (flightIt != flightsData.end())
-        {
-            // Increment available seats
-            int availableSeats = (*flightIt)["availableSeats"];
-            (*flightIt)["availableSeats"] = availableSeats + 1; // Increment available seats
-        }
-        else
-        {
-            std::cout << "Flight " << flightNumber << " not found in flights.json." << std::endl;
-        }
-
-        // Save the updated seats.json
-        try {
-            JsonUtils::saveJsonToFile(seatsData, "data/seats.json");
-        } catch (const std::runtime_error &e) {
-            std::cerr << e.what() << std::endl;
-            return;
-        }
-
-        // Save the updated flights.json
-        try {
-            JsonUtils::saveJsonToFile(flightsData, "data/flights.json");
-        } catch (const std::runtime_error &e) {
-            std::cerr << e.what() << std::endl;
-            return;
-        }
-
-        // Remove the reservation from the vector
-        reservations.erase(it);
-
-        // Save the updated vector to the JSON file
-        nlohmann::json reservationsJson;
-        for (const auto &reservation : reservations)
-        {
-            reservationsJson.push_back(reservation.toJson());
-        }
-        JsonUtils::saveJsonToFile(reservationsJson, "data/reservations.json");
-
         // Log the activity
         activityLogger.logActivity(id, "booking agent", "Cancelled Reservation", "Reservation ID: " + reservationId);
         std::cout << "Reservation with ID " << reservationId << " cancelled successfully." << std::endl;
@@ -192,23 +99,23 @@ void BookingAgent::cancelReservation(const std::string &reservationId)
     }
 }
 
-bool BookingAgent::changeSeat(const std::string &flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber)
+bool BookingAgent::changeSeat(std::string_view flightNumber, const std::string &oldSeatNumber, const std::string &newSeatNumber)
 {
     return flightService.changeSeat(flightNumber,oldSeatNumber,newSeatNumber);
 }
 
-const std::vector<Reservation>& BookingAgent::getReservations() const
+std::vector<Reservation> BookingAgent::getReservations() const
 {
-    return reservations;
+    return reservationService.getReservations();
 }
 
-std::optional<std::reference_wrapper<Reservation>> BookingAgent::findReservation(const std::string &reservationId)
+std::optional<Reservation> BookingAgent::findReservation(const std::string &reservationId)
 {
     auto reservation = reservationService.findReservation(reservationId);
     return reservation;
 }
 
-std::optional<std::reference_wrapper<Flight>> BookingAgent::findFlight(const std::string &flightNumber)
+FlightCatalog::FlightHandle BookingAgent::findFlight(const std::string &flightNumber)
 {
     auto flight = flightService.findFlight(flightNumber);
     return flight;
@@ -241,7 +148,7 @@ void BookingAgent::scanBoardingPass(const BoardingPass& boardingPass)
 
 bool BookingAgent::isValidBoardingPass(const BoardingPass& boardingPass) const
 {
-    for(const auto& reservation:reservations)
+    for(const auto& reservation:reservationService.getReservations())
     {
         // Check the boarding pass from the reservations
         if(reservation.getReservationId() == boardingPass.getReservationId() && reservation.getFlightNumber() == boardingPass.getFlightNumber() )
@@ -265,7 +172,8 @@ void BookingAgent::bookingAgentMenu()
         std::cout << "2. Book a Flight" << std::endl;
         std::cout << "3. Modify Reservation" << std::endl;
         std::cout << "4. Cancel Reservation" << std::endl;
-        std::cout << "5. Logout" << std::endl;
+        std::cout << "5. Book a Group" << std::endl;
+        std::cout << "6. Logout" << std::endl;
         std::cout << "Enter choice: ";
         std::cin >> choice;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -286,6 +194,9 @@ void BookingAgent::bookingAgentMenu()
             std::cin.get(); // Waits for a single character (e.g., Enter)
             break;
         case 5:
+            bookGroupMenu();
+            break;
+        case 6:
             Utils::clearScreen();
             logout();
             return;
@@ -335,12 +246,50 @@ void BookingAgent::bookFlightMenu()
 
     else
     {
-        Flight &flight = flightOpt.value().get();
+        const Flight &flight = *flightOpt;
+        if (flightService.getAvailableSeats(flight) == 0)
+        {
+            joinWaitlistMenu(passengerId, passengerName, flightNumber);
+            std::cout << "Press any key to continue... " << std::endl;
+            std::cin.get(); // Waits for a single character (e.g., Enter)
+            return;
+        }
         Utils::clearScreen();
         displayAvailableSeats(flightNumber);
-        std::cout << "Enter Seat Number (e.g., 12A): ";
-        std::getline(std::cin, seatNumber);
+
+        // Hold the seat while payment is entered, so a taken seat is noticed now
+        std::optional<SeatHold> seatHold;
+        while (!seatHold)
+        {
+            std::cout << "Enter Seat Number (e.g., 12A, 'auto' for the best available, '0' to cancel): ";
+            std::getline(std::cin, seatNumber);
+            if (seatNumber == "0")
+            {
+                std::cout << "Press any key to continue... " << std::endl;
+                std::cin.get(); // Waits for a single character (e.g., Enter)
+                return;
+            }
+            if (Utils::toLowerCase(seatNumber) == "auto")
+            {
+                std::string position;
+                std::cout << "Seat preference (Window/Aisle/Any): ";
+                std::getline(std::cin, position);
+
+                SeatRequest request;
+                request.position = SeatFinder::parsePosition(position);
+                auto holds = autoAssignSeats(flightNumber, request);
+                if (!holds.empty())
+                {
+                    seatHold = holds.front();
+                    seatNumber = seatHold->seatNumber;
+                }
+                continue;
+            }
+            seatHold = holdSeat(flightNumber, seatNumber);
+        }
         Utils::clearScreen();
+        std::cout << "Seat " << seatNumber << " is held for "
+                  << SeatHoldManager::defaultHoldTime.count() / 60 << " minutes." << std::endl;
 
         std::cout << "Enter Payment Method (Credit Card/Cash/PayPal): ";
         std::getline(std::cin, paymentMethod);
@@ -365,10 +314,10 @@ void BookingAgent::bookFlightMenu()
         Reservation reservation(reservationId, passengerId, passengerName, flightNumber, seatNumber, gate, boardingTime, status, flight.getPrice());
 
         // Call the bookFlight function
-        if (bookFlight(reservation, paymentMethod, paymentDetails))
+        if (bookFlight(reservation, paymentMethod, paymentDetails, seatHold))
         {
             auto flightOpt = findFlight(flightNumber);
-            Flight &flight = flightOpt.value();
+            const Flight &flight = *flightOpt;
             std::cout << "Passenger: " << passengerName << std::endl;
             std::cout << "Flight: " << flightNumber << " from " << flight.getOrigin() << " to " << flight.getDestination() << std::endl;
             std::cout << "Seat: " << seatNumber << std::endl;
@@ -380,6 +329,139 @@ void BookingAgent::bookFlightMenu()
     std::cin.get(); // Waits for a single character (e.g., Enter)
 }
 
+void BookingAgent::bookGroupMenu()
+{
+    Utils::clearScreen();
+    std::string flightNumber, paymentMethod, gate, boardingTime;
+    std::optional<std::string> paymentDetails = std::nullopt;
+
+    viewFlights();
+    std::cout << "\n\n--- Book a Group ---" << std::endl;
+    std::cout << "Enter Flight Number: ";
+    std::getline(std::cin, flightNumber);
+    auto flightOpt = findFlight(flightNumber);
+    auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+    if (!flightOpt || !seatMap)
+    {
+        std::cout << "Flight not found!" << std::endl;
+        std::cout << "Press any key to continue... " << std::endl;
+        std::cin.get(); // Waits for a single character (e.g., Enter)
+        return;
+    }
+    const Flight &flight = *flightOpt;
+
+    int partySize = 0;
+    std::cout << "Enter Number of Passengers: ";
+    std::cin >> partySize;
+    std::cin.clear();
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    if (partySize <= 0)
+    {
+        std::cout << "Invalid number of passengers." << std::endl;
+        std::cout << "Press any key to continue... " << std::endl;
+        std::cin.get(); // Waits for a single character (e.g., Enter)
+        return;
+    }
+
+    std::vector<std::pair<std::string, std::string>> passengers; // ID, name
+    for (int i = 1; i <= partySize; i++)
+    {
+        std::string passengerId, passengerName;
+        std::cout << "Passenger " << i << " ID: ";
+        std::getline(std::cin, passengerId);
+        std::cout << "Passenger " << i << " Name: ";
+        std::getline(std::cin, passengerName);
+        passengers.emplace_back(passengerId, passengerName);
+    }
+
+    // Hold the best seats for the whole group while payment is entered; in one row if it fits
+    SeatRequest request;
+    request.partySize = partySize;
+    request.together = partySize <= seatMap->getCols();
+    std::vector<SeatHold> seatHolds = autoAssignSeats(flightNumber, request);
+    if (seatHolds.empty() && request.together)
+    {
+        std::cout << "Seating the group apart instead." << std::endl;
+        request.together = false;
+        seatHolds = autoAssignSeats(flightNumber, request);
+    }
+    if (seatHolds.empty())
+    {
+        std::cout << "Press any key to continue... " << std::endl;
+        std::cin.get(); // Waits for a single character (e.g., Enter)
+        return;
+    }
+    Utils::clearScreen();
+    std::cout << partySize << " seats are held for " << SeatHoldManager::defaultHoldTime.count() / 60 << " minutes:";
+    for (const auto &seatHold : seatHolds)
+    {
+        std::cout << " " << seatHold.seatNumber;
+    }
+    std::cout << "\nTotal: $" << flight.getPrice() * partySize << std::endl;
+
+    std::cout << "Enter Payment Method (Credit Card/Cash/PayPal): ";
+    std::getline(std::cin, paymentMethod);
+
+    if (paymentMethod == "Credit Card" || paymentMethod == "credit card" || paymentMethod == "Credit card" || paymentMethod == "PayPal" || paymentMethod == "Paypal" || paymentMethod == "paypal")
+    {
+        std::cout << "Enter Payment Details: ";
+        std::string details;
+        std::getline(std::cin, details);
+        paymentDetails = details;
+    }
+
+    std::cout << "\nEnter Gate Number: ";
+    std::getline(std::cin, gate);
+    std::cout << "Enter Boarding Time: ";
+    std::getline(std::cin, boardingTime);
+
+    // One reservation per passenger, in seat order
+    std::vector<Reservation> reservations;
+    reservations.reserve(passengers.size());
+    for (size_t i = 0; i < passengers.size(); i++)
+    {
+        reservations.emplace_back(Utils::generateUniqueReservationId(), passengers[i].first, passengers[i].second, flightNumber,
+                                  seatHolds[i].seatNumber, gate, boardingTime, "Confirmed", flight.getPrice());
+    }
+
+    if (bookGroup(reservations, paymentMethod, paymentDetails, seatHolds))
+    {
+        std::cout << "Flight: " << flightNumber << " from " << flight.getOrigin() << " to " << flight.getDestination() << std::endl;
+        std::cout << "Payment Method: " << paymentMethod << std::endl;
+    }
+    std::cout << "Press any key to continue... " << std::endl;
+    std::cin.get(); // Waits for a single character (e.g., Enter)
+}
+
+void BookingAgent::joinWaitlistMenu(const std::string &passengerId, const std::string &passengerName, const std::string &flightNumber)
+{
+    std::string answer, cabinClass, tier;
+    std::cout << "Flight " << flightNumber << " is full. Join the waitlist? (y/n): ";
+    std::getline(std::cin, answer);
+    if (Utils::toLowerCase(answer) != "y")
+    {
+        return;
+    }
+
+    std::optional<std::string> wantedClass;
+    while (!wantedClass)
+    {
+        std::cout << "Cabin Class (blank for any): ";
+        std::getline(std::cin, cabinClass);
+        wantedClass = flightService.findCabinClass(flightNumber, cabinClass);
+    }
+    std::cout << "Loyalty Tier (None/Silver/Gold/Platinum): ";
+    std::getline(std::cin, tier);
+
+    WaitlistEntry entry;
+    entry.passengerId = passengerId;
+    entry.passengerName = passengerName;
+    entry.flightNumber = flightNumber;
+    entry.cabinClass = *wantedClass;
+    entry.tier = parseLoyaltyTier(tier);
+    joinWaitlist(entry);
+}
+
 void BookingAgent::modifyReservationMenu()
 {
     Utils::clearScreen();
@@ -388,13 +470,10 @@ void BookingAgent::modifyReservationMenu()
     std::string reservationId;
     std::getline(std::cin, reservationId);
 
-    auto it = std::find_if(reservations.begin(), reservations.end(),
-                           [reservationId](const Reservation &reservation)
-                           {
-                               return reservation.getReservationId() == reservationId;
-                           });
+    // Work on a copy and push every edit back through updateReservation
+    auto reservationOpt = reservationService.findReservation(reservationId);
 
-    if (it == reservations.end())
+    if (!reservationOpt)
     {
         std::cout << "Reservation not found.\n";
         return;
@@ -403,7 +482,7 @@ void BookingAgent::modifyReservationMenu()
     while (true)
     {
         Utils::clearScreen();
-        reservationService.displayReservation(*it);
+        reservationService.displayReservation(*reservationOpt);
         std::cout << "1. Change Seat\n";
         std::cout << "2. Update Passenger Details\n";
         std::cout << "3. Update Reservation Status\n";
@@ -416,20 +495,19 @@ void BookingAgent::modifyReservationMenu()
         if (modifyChoice == 1)
         {
             Utils::clearScreen();
-            displayAvailableSeats(it->getFlightNumber());
+            displayAvailableSeats(reservationOpt->getFlightNumber());
             std::cout << "Enter new seat number: ";
             std::string newSeat;
             std::getline(std::cin, newSeat);
 
-            // Ensure seat is available
-            if (!changeSeat(it->getFlightNumber(), it->getSeatNumber(), newSeat))
+            // Ensure seat is available; the seat and the reservation change together
+            if (!reservationService.changeSeat(*reservationOpt, newSeat))
             {
                 std::cout << "Seat is already booked. Please choose another " << std::endl;
             }
             else
             {
-                it->setSeatNumber(newSeat);
-                updateReservation(it->getReservationId(), *it);
+                activityLogger.logActivity(id, "booking agent", "Updated Reservation", "Reservation ID: " + reservationOpt->getReservationId());
                 std::cout << "Seat changed successfully" << std::endl;
             }
         }
@@ -439,8 +517,8 @@ void BookingAgent::modifyReservationMenu()
             std::cout << "Enter new passenger name: ";
             std::string newName;
             std::getline(std::cin, newName);
-            it->setPassengerName(newName);
-            updateReservation(it->getReservationId(), *it);
+            reservationOpt->setPassengerName(newName);
+            updateReservation(reservationOpt->getReservationId(), *reservationOpt);
             std::cout << "Passenger details updated.\n";
         }
         else if (modifyChoice == 3)
@@ -449,8 +527,8 @@ void BookingAgent::modifyReservationMenu()
             std::cout << "Enter new Status: ";
             std::string newStatus;
             std::getline(std::cin, newStatus);
-            it->setStatus(newStatus);
-            updateReservation(it->getReservationId(), *it);
+            reservationOpt->setStatus(newStatus);
+            updateReservation(reservationOpt->getReservationId(), *reservationOpt);
             std::cout << "Passenger details updated.\n";
         }
         else if (modifyChoice == 4)
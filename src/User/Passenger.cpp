@@ -17,9 +17,10 @@ void Passenger::viewReservations() const
     activityLogger.logActivity(id, "passenger", "Viewed Reservations");
 }
 
-bool Passenger::bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails)
+bool Passenger::bookFlight(Reservation &reservation, const std::string& paymentMethod, const std::optional<std::string>& paymentDetails,
+                           const std::optional<SeatHold>& seatHold)
 {
-    if(reservationService.bookFlight(reservation, paymentMethod, paymentDetails))
+    if(reservationService.bookFlight(reservation, paymentMethod, paymentDetails, seatHold))
     {
         travelHistory.push_back(reservation);
         activityLogger.logActivity(id, "Passenger", "Booked Flight", "Reservation ID: " + reservation.getReservationId());
@@ -29,13 +30,29 @@ bool Passenger::bookFlight(Reservation &reservation, const std::string& paymentM
     return false;
 }
 
-std::optional<std::reference_wrapper<Reservation>> Passenger::findReservation(const std::string &reservationId)
+bool Passenger::joinWaitlist(std::string_view flightNumber, const std::string& passengerName, const std::string& cabinClass)
+{
+    WaitlistEntry entry;
+    entry.passengerId = getId();
+    entry.passengerName = passengerName;
+    entry.flightNumber = std::string(flightNumber);
+    entry.cabinClass = cabinClass;
+    entry.tier = loyaltyTierForPoints(loyaltyPoints);
+    if (reservationService.joinWaitlist(entry))
+    {
+        activityLogger.logActivity(id, "Passenger", "Joined Waitlist", "Flight: " + entry.flightNumber);
+        return true;
+    }
+    return false;
+}
+
+std::optional<Reservation> Passenger::findReservation(const std::string &reservationId)
 {
     auto reservation = reservationService.findReservation(reservationId);
     return reservation;
 }
 
-std::optional<std::reference_wrapper<Flight>> Passenger::findFlight(const std::string &flightNumber)
+FlightCatalog::FlightHandle Passenger::findFlight(const std::string &flightNumber)
 {
     auto flight = flightService.findFlight(flightNumber);
     return flight;
@@ -69,8 +86,8 @@ void Passenger::checkIn() const
         return;
     }
 
-    // Extract the reference to the actual reservation object
-    Reservation &reservation = reservationOpt.value().get();
+    // Extract the actual reservation object
+    const Reservation &reservation = reservationOpt.value();
 
     if (reservation.getPassengerId() != getId())
     {
@@ -91,12 +108,12 @@ void Passenger::checkIn() const
         return;
     }
     
-    Flight &flight = flightOpt.value().get();
+    const Flight &flight = *flightOpt;
 
     // Generate boarding pass
-    BoardingPass boardingPass(reservation.getReservationId(), reservation.getPassengerName(), reservation.getFlightNumber(),
-                              flight.getOrigin(), flight.getDestination(), flight.getDepartureDateAndTime(),
-                              reservation.getSeatNumber(), reservation.getGate(), reservation.getBoardingTime());
+    BoardingPass boardingPass(reservation.getReservationId(), reservation.getPassengerName(), std::string(reservation.getFlightNumber()),
+                              std::string(flight.getOrigin()), std::string(flight.getDestination()), flight.getDepartureDateAndTime(),
+                              reservation.getSeatNumber(), std::string(reservation.getGate()), reservation.getBoardingTime());
     boardingPass.display();
 
     // Update reservation status
@@ -117,7 +134,8 @@ void Passenger::passengerMenu()
         std::cout << "1. Search Flights" << std::endl;
         std::cout << "2. View my Reservations" << std::endl;
         std::cout << "3. Check In" << std::endl;
-        std::cout << "4. Logout" << std::endl;
+        std::cout << "4. Waitlist Offers" << std::endl;
+        std::cout << "5. Logout" << std::endl;
         std::cout << "Enter choice: ";
         std::cin >> choice;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -142,7 +160,14 @@ void Passenger::passengerMenu()
             std::cout << "Press any key to continue... " << std::endl;
             std::cin.get(); // Waits for a single character (e.g., Enter)
             break;
-        case 4: // Log out
+        case 4: // Waitlist Offers
+            Utils::clearScreen();
+            std::cout << "--- Waitlist Offers ---" << std::endl;
+            waitlistOffersMenu();
+            std::cout << "Press any key to continue... " << std::endl;
+            std::cin.get(); // Waits for a single character (e.g., Enter)
+            break;
+        case 5: // Log out
             logout();
             Utils::clearScreen();
             return;
@@ -153,6 +178,76 @@ void Passenger::passengerMenu()
 }
 
 
+void Passenger::waitlistOffersMenu()
+{
+    auto offers = reservationService.getWaitlistOffers(getId());
+    if (offers.empty())
+    {
+        std::cout << "You have no waitlist offers." << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < offers.size(); i++)
+    {
+        auto expiresAt = std::chrono::system_clock::time_point(std::chrono::milliseconds(offers[i].expiresAt));
+        auto minutesLeft = std::chrono::duration_cast<std::chrono::minutes>(expiresAt - std::chrono::system_clock::now());
+        std::cout << i + 1 << ". Flight " << offers[i].entry.flightNumber << ", seat " << offers[i].seatNumber
+                  << " for " << offers[i].entry.passengerName << ", $" << offers[i].price
+                  << " (open for " << minutesLeft.count() << " more minutes)" << std::endl;
+    }
+
+    std::string answer;
+    std::cout << "Enter the offer number (or '0' to go back): ";
+    std::getline(std::cin, answer);
+    size_t choice = 0;
+    try
+    {
+        choice = std::stoul(answer);
+    }
+    catch (const std::exception &)
+    {
+    }
+    if (choice == 0 || choice > offers.size())
+    {
+        return;
+    }
+    const WaitlistOffer &offer = offers[choice - 1];
+
+    std::cout << "Accept or decline the seat? (a/d): ";
+    std::getline(std::cin, answer);
+    if (Utils::toLowerCase(answer) == "d")
+    {
+        if (reservationService.declineWaitlistOffer(offer.entry.entryId))
+        {
+            std::cout << "Offer declined." << std::endl;
+            activityLogger.logActivity(id, "Passenger", "Declined Waitlist Offer", "Flight: " + offer.entry.flightNumber);
+        }
+        return;
+    }
+    if (Utils::toLowerCase(answer) != "a")
+    {
+        return;
+    }
+
+    std::string paymentMethod, paymentDetails;
+    std::cout << "Enter Payment Method (Credit Card/Cash/PayPal): ";
+    std::getline(std::cin, paymentMethod);
+
+    std::optional<std::string> paymentDetailsOpt;
+    if (paymentMethod == "Credit Card" || paymentMethod == "credit card" || paymentMethod == "Credit card" || paymentMethod == "PayPal" || paymentMethod == "Paypal" || paymentMethod == "paypal")
+    {
+        std::cout << "Enter Payment Details: ";
+        std::getline(std::cin, paymentDetails);
+        paymentDetailsOpt = paymentDetails;
+    }
+    if (reservationService.acceptWaitlistOffer(offer.entry.entryId, paymentMethod, paymentDetailsOpt))
+    {
+        activityLogger.logActivity(id, "Passenger", "Accepted Waitlist Offer", "Flight: " + offer.entry.flightNumber);
+        loyaltyPoints += static_cast<int>(offer.price); // 1 point per dollar;
+    }
+}
+
+
 void Passenger::searchFlightsMenu()
 {
     Utils::clearScreen();
@@ -184,10 +279,56 @@ void Passenger::searchFlightsMenu()
 
             std::cout << "Enter Passenger Name: ";
             std::getline(std::cin, passengerName);
+            if (flightService.getAvailableSeats(*flightOpt) == 0)
+            {
+                std::string answer, cabinClass;
+                std::cout << "This flight is full. Join the waitlist? (y/n): ";
+                std::getline(std::cin, answer);
+                if (Utils::toLowerCase(answer) == "y")
+                {
+                    std::optional<std::string> wantedClass;
+                    while (!wantedClass)
+                    {
+                        std::cout << "Cabin Class (blank for any): ";
+                        std::getline(std::cin, cabinClass);
+                        wantedClass = flightService.findCabinClass(flightNumber, cabinClass);
+                    }
+                    joinWaitlist(flightNumber, passengerName, *wantedClass);
+                }
+                return;
+            }
             displayAvailableSeats(flightNumber);
 
-            std::cout << "Enter Seat Number: ";
-            std::getline(std::cin, seatNumber);
+            // Hold the seat while payment is entered, so a taken seat is noticed now
+            std::optional<SeatHold> seatHold;
+            while (!seatHold)
+            {
+                std::cout << "Enter Seat Number ('auto' for the best available, '0' to cancel): ";
+                std::getline(std::cin, seatNumber);
+                if (seatNumber == "0")
+                {
+                    return;
+                }
+                if (Utils::toLowerCase(seatNumber) == "auto")
+                {
+                    std::string position;
+                    std::cout << "Seat preference (Window/Aisle/Any): ";
+                    std::getline(std::cin, position);
+
+                    SeatRequest request;
+                    request.position = SeatFinder::parsePosition(position);
+                    auto holds = autoAssignSeats(flightNumber, request);
+                    if (!holds.empty())
+                    {
+                        seatHold = holds.front();
+                        seatNumber = seatHold->seatNumber;
+                    }
+                    continue;
+                }
+                seatHold = holdSeat(flightNumber, seatNumber);
+            }
+            std::cout << "Seat " << seatNumber << " is held for you for "
+                      << SeatHoldManager::defaultHoldTime.count() / 60 << " minutes." << std::endl;
 
             Utils::clearScreen();
             std::cout << "Enter Payment Method (Credit Card/Cash/PayPal): ";
@@ -200,11 +341,11 @@ void Passenger::searchFlightsMenu()
                 std::getline(std::cin, paymentDetails);
                 paymentDetailsOpt = paymentDetails;
             }
-            Flight &flight = flightOpt.value().get();
+            const Flight &flight = *flightOpt;
             std::string reservationId = Utils::generateUniqueReservationId();
 
             Reservation newReservation(reservationId, getId(), passengerName, flightNumber, seatNumber, "A12", "8:00", "Pending", flight.getPrice());
-            if (bookFlight(newReservation, paymentMethod, paymentDetailsOpt))
+            if (bookFlight(newReservation, paymentMethod, paymentDetailsOpt, seatHold))
             {
                 std::cout << "Booking successful!" << std::endl;
             }
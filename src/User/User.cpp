@@ -1,32 +1,48 @@
 #include "../../include/User/User.hpp"
+#include "../../include/Utils/Snapshot.hpp"
+#include <mutex>
 
-User::User(const std::string& id, const std::string& username, const std::string& role, const std::string& password) : 
-id(id), username(username), role(role), password(password){}
+User::User(std::string id, std::string username, std::string role, std::string password) : 
+id(std::move(id)), username(std::move(username)), role(std::move(role)), password(std::move(password)){}
 
-std::string User::getId() const
+const std::string& User::getId() const
 {
     return id;
 }
 
-std::string User::getUsername() const
+const std::string& User::getUsername() const
 {
     return username;
 }
 
-std::string User::getRole() const
+const std::string& User::getRole() const
 {
     return role;
 }
 
 std::pair<bool, std::string> User::login(const std::string &username, const std::string &password, const std::string &role)
 {
-    nlohmann::json usersJson = JsonUtils::readJsonFromFile("data/users.json");
+    // Users are parsed again only after some process has saved the file
+    static std::vector<User> users;
+    static JsonUtils::FileVersion usersVersion{};
+    static bool loaded = false;
+    static std::mutex usersMutex;
 
-    for (const auto &user : usersJson)
+    std::lock_guard<std::mutex> guard(usersMutex);
+    auto version = JsonUtils::getFileVersion("data/users.json");
+    if (!loaded || version != usersVersion)
     {
-        if (user["username"] == username && user["password"] == password && user["role"] == role)
+        FileLock lock(JsonUtils::lockFileFor("data/users.json"), FileLock::Mode::Shared);
+        users = Snapshot::loadEntities<User>("data/users.json");
+        usersVersion = JsonUtils::getFileVersion("data/users.json");
+        loaded = true;
+    }
+
+    for (const auto &user : users)
+    {
+        if (user.username == username && user.password == password && user.role == role)
         {
-            return {true, user["id"]}; // Return success and user ID
+            return {true, user.id}; // Return success and user ID
         }
     }
 
@@ -50,18 +66,12 @@ void User::logout()
 
 User User::fromJson(const nlohmann::json &j)
 {
-    return User(
-        j.at("id").get<std::string>(),
-        j.at("username").get<std::string>(),
-        j.at("role").get<std::string>(),
-        j.at("password").get<std::string>());
+    Builder builder;
+    JsonStream::feed(builder, j);
+    return builder.build();
 }
 
 nlohmann::json User::toJson() const
 {
-    return {
-        {"id", id},
-        {"username", username},
-        {"password", password},
-        {"role", role}};
-}
\ No newline at end of file
+    return Reflection::toJson(*this);
+}
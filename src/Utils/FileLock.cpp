@@ -0,0 +1,139 @@
+#include "../../include/Utils/FileLock.hpp"
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+    struct HeldLock
+    {
+        FileLock::Mode mode;
+        int depth;
+    };
+
+    // Locks held by the calling thread, by path. Allocated only while the thread holds
+    // one, so locks released during static destruction still find it.
+    thread_local std::unordered_map<std::string, HeldLock>* heldLocks = nullptr;
+}
+
+FileLock::FileLock(const std::string &path, Mode mode) : FileLock(path, mode, true) {}
+
+FileLock::FileLock(const std::string &path, Mode mode, bool wait) : path(path)
+{
+    if (heldLocks)
+    {
+        auto held = heldLocks->find(path);
+        if (held != heldLocks->end())
+        {
+            if (mode == Mode::Exclusive && held->second.mode == Mode::Shared)
+            {
+                throw std::logic_error("Cannot upgrade a shared lock to exclusive: " + path);
+            }
+            held->second.depth++;
+            acquired = true;
+            nested = true;
+            return;
+        }
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open lock file: " + path);
+    }
+
+    OVERLAPPED overlapped = {};
+    DWORD flags = (mode == Mode::Exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0) | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+    if (!LockFileEx(file, flags, 0, MAXDWORD, MAXDWORD, &overlapped))
+    {
+        CloseHandle(file);
+        if (!wait && GetLastError() == ERROR_LOCK_VIOLATION)
+        {
+            return;
+        }
+        throw std::runtime_error("Failed to lock file: " + path);
+    }
+    handle = file;
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed to open lock file: " + path);
+    }
+
+    int operation = (mode == Mode::Exclusive ? LOCK_EX : LOCK_SH) | (wait ? 0 : LOCK_NB);
+    while (::flock(fd, operation) != 0)
+    {
+        int error = errno;
+        if (error != EINTR)
+        {
+            ::close(fd);
+            fd = -1;
+            if (!wait && error == EWOULDBLOCK)
+            {
+                return;
+            }
+            throw std::runtime_error("Failed to lock file: " + path);
+        }
+    }
+#endif
+
+    acquired = true;
+    if (!heldLocks)
+    {
+        heldLocks = new std::unordered_map<std::string, HeldLock>();
+    }
+    (*heldLocks)[path] = {mode, 1};
+}
+
+FileLock::~FileLock()
+{
+    if (!acquired)
+    {
+        return;
+    }
+
+    // A lock released on another thread (e.g. a static destroyed at exit) isn't in this thread's map
+    if (heldLocks)
+    {
+        auto held = heldLocks->find(path);
+        if (held != heldLocks->end() && --held->second.depth == 0)
+        {
+            heldLocks->erase(held);
+            if (heldLocks->empty())
+            {
+                delete heldLocks;
+                heldLocks = nullptr;
+            }
+        }
+    }
+    if (nested)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    OVERLAPPED overlapped = {};
+    UnlockFileEx(static_cast<HANDLE>(handle), 0, MAXDWORD, MAXDWORD, &overlapped);
+    CloseHandle(static_cast<HANDLE>(handle));
+#else
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+#endif
+}
+
+std::unique_ptr<FileLock> FileLock::tryAcquire(const std::string &path, Mode mode)
+{
+    std::unique_ptr<FileLock> lock(new FileLock(path, mode, false));
+    return lock->acquired ? std::move(lock) : nullptr;
+}
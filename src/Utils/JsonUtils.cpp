@@ -1,7 +1,58 @@
 #include "../../include/Utils/JsonUtils.hpp"
 
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // The generation is stored as fixed-width text at the start of the lock file,
+    // rewritten in place so a concurrent reader never sees it half-truncated
+    constexpr std::streamsize generationWidth = 20;
+
+    // Read straight from the descriptor into a stack buffer: this runs on every version
+    // check, and stdio would allocate a FILE for each one
+    std::uint64_t readGeneration(const std::string &lockFile)
+    {
+        char text[generationWidth];
+#ifdef _WIN32
+        int fd = _open(lockFile.c_str(), _O_RDONLY | _O_BINARY);
+        if (fd < 0)
+        {
+            return 0;
+        }
+        int length = _read(fd, text, sizeof(text));
+        _close(fd);
+#else
+        int fd = ::open(lockFile.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return 0;
+        }
+        ssize_t length = ::pread(fd, text, sizeof(text), 0);
+        ::close(fd);
+#endif
+
+        std::uint64_t generation = 0;
+        for (decltype(length) i = 0; i < length && text[i] >= '0' && text[i] <= '9'; i++)
+        {
+            generation = generation * 10 + static_cast<std::uint64_t>(text[i] - '0');
+        }
+        return generation;
+    }
+}
+
 nlohmann::json JsonUtils::readJsonFromFile(const std::string &filename)
 {
+    FileLock lock(lockFileFor(filename), FileLock::Mode::Shared);
     std::ifstream file(filename);
     if (!file.is_open())
     {
@@ -25,19 +76,208 @@ nlohmann::json JsonUtils::readJsonFromFile(const std::string &filename)
 
 void JsonUtils::saveJsonToFile(const nlohmann::json &data, const std::string &filename)
 {
-    std::ofstream outputFile(filename);
-    if (!outputFile.is_open())
+    writeFileAtomically(filename, data.dump(4)); // Pretty-print with 4 spaces
+}
+
+nlohmann::json JsonUtils::updateJsonFile(const std::string &filename, const std::function<void(nlohmann::json &)> &update)
+{
+    FileLock lock(lockFileFor(filename));
+
+    nlohmann::json data;
+    std::error_code ec;
+    if (std::filesystem::exists(filename, ec))
     {
-        throw std::runtime_error("Failed to open file: " + filename);
+        data = readJsonFromFile(filename);
+    }
+    update(data);
+    saveJsonToFile(data, filename);
+    return data;
+}
+
+void JsonUtils::writeFileAtomically(const std::string &filename, const std::string &contents)
+{
+    FileLock lock(lockFileFor(filename));
+
+    std::string tempFile = filename + ".tmp";
+    std::FILE *file = std::fopen(tempFile.c_str(), "wb");
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open file: " + tempFile);
+    }
+    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    try
+    {
+        syncFile(file);
+    }
+    catch (const std::runtime_error &)
+    {
+        written = false;
+    }
+    std::fclose(file);
+    if (!written)
+    {
+        std::remove(tempFile.c_str());
+        throw std::runtime_error("Failed to write file: " + filename);
+    }
+
+    // Readers see either the old file or the new one, never a partial write
+    replaceFile(tempFile, filename);
+    bumpGeneration(filename);
+}
+
+void JsonUtils::replaceFile(const std::string &from, const std::string &to)
+{
+#ifdef _WIN32
+    if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        throw std::runtime_error("Failed to replace file: " + to + " (error " + std::to_string(GetLastError()) + ")");
+    }
+#else
+    std::filesystem::rename(from, to);
+#endif
+}
+
+std::FILE* JsonUtils::openShared(const std::string &filename, const char *mode)
+{
+#ifdef _WIN32
+    // fopen doesn't share delete access, which a later MoveFileEx over the file needs
+    DWORD access = GENERIC_READ;
+    DWORD disposition = OPEN_EXISTING;
+    int flags = _O_RDONLY | _O_BINARY;
+    if (mode[0] == 'w')
+    {
+        access = GENERIC_WRITE;
+        disposition = CREATE_ALWAYS;
+        flags = _O_WRONLY | _O_BINARY;
+    }
+    else if (mode[0] == 'a')
+    {
+        access = FILE_APPEND_DATA;
+        disposition = OPEN_ALWAYS;
+        flags = _O_WRONLY | _O_APPEND | _O_BINARY;
+    }
+
+    HANDLE handle = CreateFileA(filename.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+    int fd = _open_osfhandle(reinterpret_cast<intptr_t>(handle), flags);
+    if (fd < 0)
+    {
+        CloseHandle(handle);
+        return nullptr;
+    }
+    std::FILE *file = _fdopen(fd, mode);
+    if (!file)
+    {
+        _close(fd);
+    }
+    return file;
+#else
+    return std::fopen(filename.c_str(), mode);
+#endif
+}
+
+JsonUtils::FileVersion JsonUtils::getFileVersion(const std::string &filename)
+{
+    return getFileVersion(filename, lockFileFor(filename));
+}
+
+JsonUtils::FileVersion JsonUtils::getFileVersion(const std::string &filename, const std::string &lockFile)
+{
+    FileVersion version;
+#ifdef _WIN32
+    std::error_code ec;
+    version.size = std::filesystem::file_size(filename, ec);
+    if (ec)
+    {
+        return FileVersion{};
+    }
+    version.modified = std::filesystem::last_write_time(filename, ec).time_since_epoch().count();
+#else
+    struct stat info;
+    if (::stat(filename.c_str(), &info) != 0)
+    {
+        return version;
+    }
+    version.device = static_cast<std::uint64_t>(info.st_dev);
+    version.inode = static_cast<std::uint64_t>(info.st_ino);
+    version.size = static_cast<std::uint64_t>(info.st_size);
+    version.modified = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    version.generation = readGeneration(lockFile);
+    return version;
+}
+
+void JsonUtils::bumpGeneration(const std::string &filename)
+{
+    std::string lockFile = lockFileFor(filename);
+    std::uint64_t generation = readGeneration(lockFile) + 1;
+
+    std::string text = std::to_string(generation);
+    text.insert(0, static_cast<size_t>(generationWidth) - text.size(), '0');
+    std::fstream out(lockFile, std::ios::in | std::ios::out | std::ios::binary);
+    if (!out.is_open())
+    {
+        out.open(lockFile, std::ios::out | std::ios::binary);
     }
+    out.write(text.data(), generationWidth);
+}
 
-    // Write the JSON data to the file (overwrite)
-    outputFile << data.dump(4); // Pretty-print with 4 spaces
-    outputFile.close();
+void JsonUtils::syncFile(std::FILE *file)
+{
+    if (std::fflush(file) != 0)
+    {
+        throw std::runtime_error("Failed to flush file");
+    }
+
+#ifdef _WIN32
+    bool synced = _commit(_fileno(file)) == 0;
+#else
+    bool synced = fsync(fileno(file)) == 0;
+#endif
+    if (!synced)
+    {
+        throw std::runtime_error("Failed to sync file");
+    }
+}
+
+int JsonUtils::duplicateDescriptor(std::FILE *file)
+{
+#ifdef _WIN32
+    int descriptor = _dup(_fileno(file));
+#else
+    int descriptor = dup(fileno(file));
+#endif
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("Failed to duplicate file descriptor");
+    }
+    return descriptor;
+}
+
+void JsonUtils::syncAndClose(int descriptor)
+{
+#ifdef _WIN32
+    bool synced = _commit(descriptor) == 0;
+    _close(descriptor);
+#else
+    bool synced = fsync(descriptor) == 0;
+    close(descriptor);
+#endif
+    if (!synced)
+    {
+        throw std::runtime_error("Failed to sync file");
+    }
 }
 
 bool JsonUtils::deleteFromJsonFile(const std::string &filename, const std::string &key, const std::string &id)
 {
+    // Hold the write lock from the read to the save
+    FileLock lock(lockFileFor(filename));
+
     // Read the existing JSON data
     nlohmann::json data;
     try
@@ -3,36 +3,207 @@
 
 void ActivityLogger::logActivity(const std::string& userId, const std::string& role, const std::string& action, const std::string& details)
 {
-    // Get the current timestamp
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-    std::tm now_tm = *std::localtime(&now_time);
-    std::ostringstream timestamp;
-    timestamp << std::put_time(&now_tm, "%Y-%m-%d %H:%M:%S");
+    // Only capture the entry here; formatting and file I/O happen on the writer thread
+    ActivityLogWriter::instance().submit({userId, role, action, details, std::chrono::system_clock::now()});
+}
+
+void ActivityLogger::configure(const Options& options)
+{
+    ActivityLogWriter::instance().configure(options);
+}
+
+void ActivityLogger::flush()
+{
+    ActivityLogWriter::instance().flush();
+}
+
+nlohmann::json ActivityLogger::readLog()
+{
+    flush();
+
+    nlohmann::json log = nlohmann::json::array();
+
+    // Entries written before the log moved to JSON Lines
+    std::ifstream legacyFile(ActivityLogWriter::legacyLogFile);
+    if (legacyFile.good())
+    {
+        nlohmann::json legacy = nlohmann::json::parse(legacyFile, nullptr, false);
+        if (legacy.is_array())
+        {
+            for (auto &activity : legacy)
+            {
+                log.push_back(std::move(activity));
+            }
+        }
+    }
+
+    std::ifstream logFile(ActivityLogWriter::logFile);
+    std::string line;
+    while (std::getline(logFile, line))
+    {
+        nlohmann::json activity = nlohmann::json::parse(line, nullptr, false);
+        if (!activity.is_discarded())
+        {
+            log.push_back(std::move(activity));
+        }
+    }
+
+    return log;
+}
+
+
+ActivityLogWriter::ActivityLogWriter()
+{
+    worker = std::thread(&ActivityLogWriter::backgroundLoop, this);
+}
+
+ActivityLogWriter::~ActivityLogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+ActivityLogWriter& ActivityLogWriter::instance()
+{
+    static ActivityLogWriter writer;
+    return writer;
+}
+
+void ActivityLogWriter::submit(Entry&& entry)
+{
+    // Reserve a slot so the queue never grows past the configured bound
+    while (queuedEntries.fetch_add(1, std::memory_order_acq_rel) >= maxQueuedEntries.load(std::memory_order_relaxed))
+    {
+        queuedEntries.fetch_sub(1, std::memory_order_acq_rel);
+        if (overflowPolicy.load(std::memory_order_relaxed) == ActivityLogger::OverflowPolicy::Drop)
+        {
+            droppedEntries.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Backpressure: hand the writer the CPU until there is room
+        wakeUp.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    queue.push(std::move(entry));
+    submittedEntries.fetch_add(1, std::memory_order_release);
+}
+
+void ActivityLogWriter::configure(const ActivityLogger::Options& options)
+{
+    flushLatencyMs.store(options.flushLatency.count(), std::memory_order_relaxed);
+    maxQueuedEntries.store(options.maxQueuedEntries > 0 ? options.maxQueuedEntries : 1, std::memory_order_relaxed);
+    overflowPolicy.store(options.overflowPolicy, std::memory_order_relaxed);
+    wakeUp.notify_one();
+}
+
+void ActivityLogWriter::flush()
+{
+    unsigned long long target = submittedEntries.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex);
+    if (writtenEntries >= target)
+    {
+        return;
+    }
+    wakeUp.notify_one();
+    written.wait(lock, [this, target] { return writtenEntries >= target || stopping; });
+}
+
+void ActivityLogWriter::backgroundLoop()
+{
+    std::ofstream out;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeUp.wait_for(lock, std::chrono::milliseconds(flushLatencyMs.load(std::memory_order_relaxed)));
+        bool stop = stopping;
 
-    // Create the activity log entry
-    nlohmann::json activity = {
-        {"userId", userId},
-        {"role", role},
-        {"action", action},
-        {"timestamp", timestamp.str()},
-        {"details", details}
-    };
+        // Do the file I/O outside the lock
+        lock.unlock();
+        size_t count = writeBatch(out);
+        lock.lock();
 
-    // Read the existing log file
-    nlohmann::json log;
-    std::ifstream logFile("data/reports/user_activity.json");
-    if (logFile.good())
+        writtenEntries += count;
+        written.notify_all();
+        if (stop)
+        {
+            break;
+        }
+    }
+}
+
+size_t ActivityLogWriter::writeBatch(std::ofstream& out)
+{
+    std::string batch;
+    size_t count = 0;
+    Entry entry;
+    while (queue.pop(entry))
+    {
+        queuedEntries.fetch_sub(1, std::memory_order_acq_rel);
+        nlohmann::json activity = {
+            {"userId", entry.userId},
+            {"role", entry.role},
+            {"action", entry.action},
+            {"timestamp", formatTimestamp(entry.time)},
+            {"details", entry.details}
+        };
+        batch += activity.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+        batch += '\n';
+        count++;
+    }
+
+    // Leave a marker so dropped entries are visible in the report
+    unsigned long long dropped = droppedEntries.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+    {
+        nlohmann::json marker = {
+            {"userId", ""},
+            {"role", "system"},
+            {"action", "Dropped Activity Entries"},
+            {"timestamp", formatTimestamp(std::chrono::system_clock::now())},
+            {"details", std::to_string(dropped) + " entries dropped, log queue was full"}
+        };
+        batch += marker.dump();
+        batch += '\n';
+    }
+
+    if (batch.empty())
     {
-        logFile >> log;
+        return count;
     }
-    logFile.close();
 
-    // Append the new activity
-    log.push_back(activity);
+    if (!out.is_open())
+    {
+        out.open(logFile, std::ios::app);
+        if (!out.is_open())
+        {
+            std::cerr << "Failed to open file: " << logFile << std::endl;
+            return count;
+        }
+    }
+    out << batch;
+    out.flush();
+    return count;
+}
 
-    // Write the updated log back to the file
-    std::ofstream outFile("data/reports/user_activity.json");
-    outFile << log.dump(4); // Pretty-print with 4 spaces
-    outFile.close();
-}
\ No newline at end of file
+std::string ActivityLogWriter::formatTimestamp(std::chrono::system_clock::time_point time)
+{
+    std::time_t now_time = std::chrono::system_clock::to_time_t(time);
+    std::tm now_tm{};
+#ifdef _WIN32
+    localtime_s(&now_tm, &now_time);
+#else
+    localtime_r(&now_time, &now_tm);
+#endif
+    std::ostringstream timestamp;
+    timestamp << std::put_time(&now_tm, "%Y-%m-%d %H:%M:%S");
+    return timestamp.str();
+}
@@ -0,0 +1,94 @@
+#include "../../include/Utils/MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &path)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize))
+    {
+        CloseHandle(handle);
+        throw std::runtime_error("Failed to read size of file: " + path);
+    }
+    file = handle;
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0)
+    {
+        return; // Nothing to map
+    }
+
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    address = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!address)
+    {
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(handle);
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Failed to read size of file: " + path);
+    }
+    size = static_cast<size_t>(status.st_size);
+    if (size > 0)
+    {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed to map file: " + path);
+        }
+        address = mapped;
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (address)
+    {
+        UnmapViewOfFile(address);
+    }
+    if (mapping)
+    {
+        CloseHandle(mapping);
+    }
+    if (file)
+    {
+        CloseHandle(file);
+    }
+#else
+    if (address)
+    {
+        ::munmap(const_cast<void*>(address), size);
+    }
+#endif
+}
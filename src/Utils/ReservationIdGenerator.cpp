@@ -0,0 +1,135 @@
+#include "../../include/Utils/ReservationIdGenerator.hpp"
+#include "../../include/Utils/FileLock.hpp"
+#include "../../include/Utils/JsonUtils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+ReservationIdGenerator::ReservationIdGenerator(const std::string &stateFile) : stateFile(stateFile)
+{
+    FileLock lock(stateFile + ".lock");
+
+    nlohmann::json state = nlohmann::json::object();
+    if (std::filesystem::exists(stateFile))
+    {
+        state = JsonUtils::readJsonFromFile(stateFile);
+    }
+
+    // Lease a free node and start at or after every timestamp handed out before,
+    // so a node reused from a dead process can't repeat its IDs
+    leaseNode(state.value("nextNode", 0ULL) & nodeMask);
+    std::int64_t start = std::max(currentMillis(), state.value("reservedUntil", std::int64_t{0}));
+
+    state["nextNode"] = (node + 1) & nodeMask;
+    state["reservedUntil"] = start + reserveAheadMillis;
+    JsonUtils::saveJsonToFile(state, stateFile);
+
+    lastIssued.store(static_cast<std::uint64_t>(start) << sequenceBits);
+    reservedUntil.store(start + reserveAheadMillis);
+}
+
+ReservationIdGenerator& ReservationIdGenerator::instance()
+{
+    static ReservationIdGenerator generator("data/reservation_ids.json");
+    return generator;
+}
+
+std::string ReservationIdGenerator::nextId()
+{
+    return format(nextValue());
+}
+
+std::uint64_t ReservationIdGenerator::nextValue()
+{
+    std::uint64_t previous = lastIssued.load(std::memory_order_relaxed);
+    std::uint64_t next;
+    do
+    {
+        std::int64_t previousTimestamp = static_cast<std::int64_t>(previous >> sequenceBits);
+        std::int64_t now = currentMillis();
+
+        if (now > previousTimestamp)
+        {
+            next = static_cast<std::uint64_t>(now) << sequenceBits;
+        }
+        else if ((previous & sequenceMask) < sequenceMask)
+        {
+            // Same millisecond, or the clock went back: keep counting on the last timestamp
+            next = previous + 1;
+        }
+        else
+        {
+            // Sequence exhausted: borrow the next millisecond instead of spinning
+            next = static_cast<std::uint64_t>(previousTimestamp + 1) << sequenceBits;
+        }
+    } while (!lastIssued.compare_exchange_weak(previous, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    std::int64_t timestamp = static_cast<std::int64_t>(next >> sequenceBits);
+    if (timestamp > reservedUntil.load(std::memory_order_acquire))
+    {
+        reserveUntil(timestamp);
+    }
+
+    return (static_cast<std::uint64_t>(timestamp) << (nodeBits + sequenceBits)) | (node << sequenceBits) | (next & sequenceMask);
+}
+
+std::string ReservationIdGenerator::format(std::uint64_t value)
+{
+    static constexpr char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string id(14, '0');
+    id[0] = 'R';
+    for (size_t i = id.size() - 1; i > 0 && value > 0; i--)
+    {
+        id[i] = digits[value % 36];
+        value /= 36;
+    }
+    return id;
+}
+
+void ReservationIdGenerator::leaseNode(std::uint64_t first)
+{
+    // A node's lock is held by its live process and released by the OS when it dies
+    for (std::uint64_t i = 0; i <= nodeMask; i++)
+    {
+        std::uint64_t candidate = (first + i) & nodeMask;
+        nodeLease = FileLock::tryAcquire(nodeLockFile(candidate));
+        if (nodeLease)
+        {
+            node = candidate;
+            return;
+        }
+    }
+    throw std::runtime_error("All " + std::to_string(nodeMask + 1) + " reservation ID nodes are in use");
+}
+
+std::string ReservationIdGenerator::nodeLockFile(std::uint64_t candidate) const
+{
+    return stateFile + ".node" + std::to_string(candidate) + ".lock";
+}
+
+void ReservationIdGenerator::reserveUntil(std::int64_t timestamp)
+{
+    std::lock_guard<std::mutex> guard(reserveMutex);
+    if (timestamp <= reservedUntil.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    FileLock lock(stateFile + ".lock");
+    nlohmann::json state = nlohmann::json::object();
+    if (std::filesystem::exists(stateFile))
+    {
+        state = JsonUtils::readJsonFromFile(stateFile);
+    }
+
+    std::int64_t horizon = std::max(timestamp, state.value("reservedUntil", std::int64_t{0})) + reserveAheadMillis;
+    state["reservedUntil"] = horizon;
+    JsonUtils::saveJsonToFile(state, stateFile);
+    reservedUntil.store(horizon, std::memory_order_release);
+}
+
+std::int64_t ReservationIdGenerator::currentMillis()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count() - epochMillis;
+}
@@ -0,0 +1,308 @@
+#include "../../include/Utils/Snapshot.hpp"
+#include <array>
+#include <cstdio>
+
+namespace
+{
+    const char snapshotMagic[8] = {'A', 'R', 'S', 'S', 'N', 'A', 'P', '\0'};
+    constexpr size_t headerSize = 16;        // magic, version, section count
+    constexpr size_t sectionEntrySize = 80;
+    constexpr size_t sectionNameSize = 16;
+
+    size_t alignTo8(size_t offset)
+    {
+        return (offset + 7) & ~static_cast<size_t>(7);
+    }
+
+    size_t pageCount(std::uint64_t size, size_t pageSize)
+    {
+        return static_cast<size_t>((size + pageSize - 1) / pageSize);
+    }
+
+    const std::array<std::uint32_t, 256>& crcTable()
+    {
+        static const std::array<std::uint32_t, 256> table = []
+        {
+            std::array<std::uint32_t, 256> entries{};
+            for (std::uint32_t i = 0; i < 256; i++)
+            {
+                std::uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                }
+                entries[i] = crc;
+            }
+            return entries;
+        }();
+        return table;
+    }
+}
+
+Snapshot::FileStamp Snapshot::FileStamp::of(const std::string &path)
+{
+    FileStamp stamp;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+    {
+        return stamp;
+    }
+    auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec)
+    {
+        return stamp;
+    }
+    stamp.size = size;
+    stamp.modified = static_cast<std::int64_t>(modified.time_since_epoch().count());
+    return stamp;
+}
+
+std::uint32_t Snapshot::crc32(std::string_view data)
+{
+    const auto &table = crcTable();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (char c : data)
+    {
+        crc = table[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+std::string Snapshot::sectionName(const std::string &sourceFile)
+{
+    return std::filesystem::path(sourceFile).stem().string();
+}
+
+void Snapshot::Writer::save(const std::string &path) const
+{
+    // Checksum every page of each section's records and pool
+    std::vector<std::string> pageChecksums;
+    for (const auto &section : sections)
+    {
+        std::string data = section.records + section.pool;
+        std::string checksums;
+        Reflection::BinaryWriter out(checksums);
+        for (size_t page = 0; page < data.size(); page += pageSize)
+        {
+            out.writeU32(crc32(std::string_view(data).substr(page, pageSize)));
+        }
+        pageChecksums.push_back(std::move(checksums));
+    }
+
+    // Lay the sections out after the header, section table and header checksum
+    std::vector<size_t> recordOffsets;
+    size_t offset = alignTo8(headerSize + sections.size() * sectionEntrySize + 4);
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        recordOffsets.push_back(offset);
+        offset = alignTo8(offset + sections[i].records.size() + sections[i].pool.size() + pageChecksums[i].size());
+    }
+
+    std::string header;
+    Reflection::BinaryWriter out(header);
+    header.append(snapshotMagic, sizeof(snapshotMagic));
+    out.writeU32(formatVersion);
+    out.writeU32(static_cast<std::uint32_t>(sections.size()));
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        const Section &section = sections[i];
+        if (section.name.size() >= sectionNameSize)
+        {
+            throw std::runtime_error("Snapshot section name too long: " + section.name);
+        }
+        std::string name = section.name;
+        name.resize(sectionNameSize, '\0');
+        header += name;
+        out.writeU32(section.fieldCount);
+        out.writeU32(section.schemaHash);
+        out.writeI64(static_cast<std::int64_t>(section.recordCount));
+        out.writeI64(static_cast<std::int64_t>(recordOffsets[i]));
+        out.writeI64(static_cast<std::int64_t>(recordOffsets[i] + section.records.size()));
+        out.writeI64(static_cast<std::int64_t>(section.pool.size()));
+        out.writeI64(static_cast<std::int64_t>(section.source.size));
+        out.writeI64(section.source.modified);
+        out.writeU32(crc32(pageChecksums[i]));
+        out.writeU32(static_cast<std::uint32_t>(pageSize));
+    }
+    out.writeU32(crc32(header));
+
+    std::string contents = std::move(header);
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        contents.resize(recordOffsets[i], '\0');
+        contents += sections[i].records;
+        contents += sections[i].pool;
+        contents += pageChecksums[i];
+    }
+
+    const std::string temporary = path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open file: " + temporary);
+    }
+    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    try
+    {
+        JsonUtils::syncFile(file);
+    }
+    catch (const std::exception &)
+    {
+        written = false;
+    }
+    std::fclose(file);
+    if (!written)
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Failed to write file: " + temporary);
+    }
+    JsonUtils::replaceFile(temporary, path);
+}
+
+Snapshot::Reader::Reader(const std::string &path) : path(path), file(std::make_shared<MappedFile>(path))
+{
+    std::string_view data = file->data();
+    if (data.size() < headerSize || data.substr(0, sizeof(snapshotMagic)) != std::string_view(snapshotMagic, sizeof(snapshotMagic)))
+    {
+        throw std::runtime_error("Not a snapshot file: " + path);
+    }
+
+    Reflection::BinaryReader in(data.substr(sizeof(snapshotMagic)));
+    std::uint32_t version = in.readU32();
+    if (version != formatVersion)
+    {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(version) + ": " + path);
+    }
+    std::uint32_t sectionCount = in.readU32();
+    size_t tableEnd = headerSize + static_cast<size_t>(sectionCount) * sectionEntrySize;
+    if (data.size() < tableEnd + 4)
+    {
+        throw std::runtime_error("Truncated snapshot: " + path);
+    }
+    Reflection::BinaryReader checksum(data.substr(tableEnd, 4));
+    if (checksum.readU32() != crc32(data.substr(0, tableEnd)))
+    {
+        throw std::runtime_error("Snapshot header checksum mismatch: " + path);
+    }
+
+    for (std::uint32_t i = 0; i < sectionCount; i++)
+    {
+        const size_t entryOffset = headerSize + static_cast<size_t>(i) * sectionEntrySize;
+        std::string_view name = data.substr(entryOffset, sectionNameSize);
+        Reflection::BinaryReader entry(data.substr(entryOffset + sectionNameSize, sectionEntrySize - sectionNameSize));
+
+        SectionEntry section;
+        section.name = std::string(name.substr(0, name.find('\0')));
+        section.fieldCount = entry.readU32();
+        section.schemaHash = entry.readU32();
+        section.recordCount = static_cast<std::uint64_t>(entry.readI64());
+        section.recordsOffset = static_cast<std::uint64_t>(entry.readI64());
+        section.poolOffset = static_cast<std::uint64_t>(entry.readI64());
+        section.poolSize = static_cast<std::uint64_t>(entry.readI64());
+        section.source.size = static_cast<std::uint64_t>(entry.readI64());
+        section.source.modified = entry.readI64();
+        section.checksum = entry.readU32();
+        section.pageSize = entry.readU32();
+
+        // Records run up to the pool, then the page checksums, which must end inside the file
+        const std::uint64_t recordBytes = section.recordCount * section.fieldCount * 8;
+        if (section.fieldCount == 0 || section.pageSize == 0 || section.recordsOffset > data.size() ||
+            section.poolOffset != section.recordsOffset + recordBytes ||
+            section.poolOffset > data.size() || section.poolSize > data.size() - section.poolOffset ||
+            pageCount(recordBytes + section.poolSize, section.pageSize) * 4 > data.size() - section.poolOffset - section.poolSize)
+        {
+            throw std::runtime_error("Corrupt snapshot section table: " + path);
+        }
+        sections.push_back(std::move(section));
+    }
+}
+
+const Snapshot::Reader::SectionEntry* Snapshot::Reader::findSection(std::string_view name) const
+{
+    for (const auto &section : sections)
+    {
+        if (section.name == name)
+        {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+Snapshot::FileStamp Snapshot::Reader::sourceOf(std::string_view name) const
+{
+    const SectionEntry* section = findSection(name);
+    return section ? section->source : FileStamp{};
+}
+
+std::vector<std::string> Snapshot::Reader::sectionNames() const
+{
+    std::vector<std::string> names;
+    for (const auto &section : sections)
+    {
+        names.push_back(section.name);
+    }
+    return names;
+}
+
+const Snapshot::Reader::SectionEntry& Snapshot::Reader::openSection(std::string_view name, std::uint32_t fieldCount,
+                                                                    std::uint32_t schemaHash) const
+{
+    const SectionEntry* section = findSection(name);
+    if (!section)
+    {
+        throw std::runtime_error("Snapshot has no section " + std::string(name) + ": " + path);
+    }
+    if (section->fieldCount != fieldCount || section->schemaHash != schemaHash)
+    {
+        throw std::runtime_error("Snapshot section " + section->name + " was written with different fields: " + path);
+    }
+
+    // Only the page checksums are read here; each page is checked when a record first needs it
+    if (crc32(pageChecksumsOf(*section)) != section->checksum)
+    {
+        throw std::runtime_error("Snapshot section " + section->name + " checksum mismatch: " + path);
+    }
+    return *section;
+}
+
+std::string_view Snapshot::Reader::pageChecksumsOf(const SectionEntry &section) const
+{
+    const std::uint64_t size = section.poolOffset + section.poolSize - section.recordsOffset;
+    return file->data().substr(section.poolOffset + section.poolSize, pageCount(size, section.pageSize) * 4);
+}
+
+std::shared_ptr<const Snapshot::PageChecks> Snapshot::Reader::pageChecks(const SectionEntry &section) const
+{
+    std::string_view contents = file->data().substr(section.recordsOffset, section.poolOffset + section.poolSize - section.recordsOffset);
+    return std::make_shared<PageChecks>(contents, pageChecksumsOf(section), section.pageSize, path + " section " + section.name);
+}
+
+Snapshot::PageChecks::PageChecks(std::string_view data, std::string_view checksums, size_t pageSize, std::string section)
+    : data(data), checksums(checksums), pageSize(pageSize), section(std::move(section)),
+      verified(std::make_unique<std::atomic<bool>[]>(pageCount(data.size(), pageSize)))
+{
+}
+
+void Snapshot::PageChecks::verify(size_t offset, size_t length) const
+{
+    if (length == 0)
+    {
+        return;
+    }
+    for (size_t page = offset / pageSize; page <= (offset + length - 1) / pageSize; page++)
+    {
+        // Two threads may both check a fresh page; either result is the same
+        if (verified[page].load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        Reflection::BinaryReader expected(checksums.substr(page * 4, 4));
+        if (crc32(data.substr(page * pageSize, pageSize)) != expected.readU32())
+        {
+            throw std::runtime_error("Snapshot page checksum mismatch in " + section);
+        }
+        verified[page].store(true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,158 @@
+#include "../../include/Utils/SnapshotConverter.hpp"
+#include <filesystem>
+#include <sstream>
+
+namespace
+{
+    const char* flightsFile = "data/flights.json";
+    const char* reservationsFile = "data/reservations.json";
+    const char* usersFile = "data/users.json";
+    const char* aircraftFile = "data/aircraft.json";
+    const char* crewFile = "data/crew.json";
+    const char* seatsFile = "data/seats.dat";
+
+    // crew.json keeps one list per role
+    const std::pair<const char*, const char*> crewLists[] = {{"pilots", "Pilot"}, {"flight_attendants", "Flight Attendant"}};
+
+    template <typename Entity>
+    void addJsonSection(Snapshot::Writer &writer, const std::string &jsonFile)
+    {
+        writer.addSection(Snapshot::sectionName(jsonFile), JsonUtils::readEntitiesFromFile<Entity>(jsonFile),
+                          Snapshot::FileStamp::of(jsonFile));
+    }
+
+    template <typename Entity>
+    void restoreJsonSection(const Snapshot::Reader &reader, const std::string &jsonFile)
+    {
+        const std::string section = Snapshot::sectionName(jsonFile);
+        if (!reader.hasSection(section))
+        {
+            return;
+        }
+        nlohmann::json entities = nlohmann::json::array();
+        for (const auto &entity : reader.table<Entity>(section).loadAll())
+        {
+            entities.push_back(Reflection::toJson(entity));
+        }
+        JsonUtils::saveJsonToFile(entities, jsonFile);
+    }
+
+    std::vector<Crew> readCrew()
+    {
+        nlohmann::json crewJson = JsonUtils::readJsonFromFile(crewFile);
+        std::vector<Crew> crew;
+        for (const auto &[list, role] : crewLists)
+        {
+            if (!crewJson.contains(list))
+            {
+                continue;
+            }
+            for (auto member : crewJson.at(list))
+            {
+                member["role"] = role;
+                Crew::Builder builder;
+                JsonStream::feed(builder, member);
+                crew.push_back(builder.build());
+            }
+        }
+        return crew;
+    }
+
+    void restoreCrew(const Snapshot::Reader &reader)
+    {
+        const std::string section = Snapshot::sectionName(crewFile);
+        if (!reader.hasSection(section))
+        {
+            return;
+        }
+        nlohmann::json crewJson = nlohmann::json::object();
+        for (const auto &[list, role] : crewLists)
+        {
+            crewJson[list] = nlohmann::json::array();
+        }
+        for (const auto &member : reader.table<Crew>(section).loadAll())
+        {
+            for (const auto &[list, role] : crewLists)
+            {
+                if (member.getRole() == role)
+                {
+                    nlohmann::json memberJson = Reflection::toJson(member);
+                    memberJson.erase("role");
+                    crewJson[list].push_back(std::move(memberJson));
+                }
+            }
+        }
+        JsonUtils::saveJsonToFile(crewJson, crewFile);
+    }
+
+    std::vector<Snapshot::SeatMapRecord> readSeatMaps()
+    {
+        std::vector<Snapshot::SeatMapRecord> records;
+        for (const auto &[flightNumber, seatMap] : SeatInventory::instance().getSeatMaps())
+        {
+            std::ostringstream blob;
+            seatMap->writeTo(blob);
+            records.push_back({flightNumber, std::string(seatMap->getLayout().getName()), blob.str()});
+        }
+        return records;
+    }
+
+    void restoreSeatMaps(const Snapshot::Reader &reader)
+    {
+        const std::string section = Snapshot::sectionName(seatsFile);
+        if (!reader.hasSection(section))
+        {
+            return;
+        }
+        SeatInventory &inventory = SeatInventory::instance();
+        auto records = reader.table<Snapshot::SeatMapRecord>(section).loadAll();
+        for (const auto &[flightNumber, seatMap] : inventory.getSeatMaps())
+        {
+            inventory.removeSeatMap(flightNumber);
+        }
+        for (const auto &record : records)
+        {
+            std::istringstream blob(record.seatMap);
+            SeatMap seatMap = SeatMap::readFrom(blob);
+            if (const CabinLayout *layout = CabinLayout::find(record.layout))
+            {
+                seatMap.setLayout(*layout);
+            }
+            inventory.putSeatMap(record.flightNumber, std::move(seatMap));
+        }
+        inventory.save();
+    }
+}
+
+void SnapshotConverter::buildFromJson(const std::string &snapshotFile)
+{
+    Snapshot::Writer writer;
+    addJsonSection<Flight>(writer, flightsFile);
+    addJsonSection<Reservation>(writer, reservationsFile);
+    addJsonSection<User>(writer, usersFile);
+    addJsonSection<Aircraft>(writer, aircraftFile);
+    writer.addSection(Snapshot::sectionName(crewFile), readCrew(), Snapshot::FileStamp::of(crewFile));
+    // Seat maps are created lazily, so there may be nothing to capture yet
+    std::error_code ec;
+    if (std::filesystem::exists(seatsFile, ec))
+    {
+        writer.addSection(Snapshot::sectionName(seatsFile), readSeatMaps(), Snapshot::FileStamp::of(seatsFile));
+    }
+    writer.save(snapshotFile);
+}
+
+void SnapshotConverter::restoreToJson(const std::string &snapshotFile)
+{
+    {
+        Snapshot::Reader reader(snapshotFile);
+        restoreJsonSection<Flight>(reader, flightsFile);
+        restoreJsonSection<Reservation>(reader, reservationsFile);
+        restoreJsonSection<User>(reader, usersFile);
+        restoreJsonSection<Aircraft>(reader, aircraftFile);
+        restoreCrew(reader);
+        restoreSeatMaps(reader);
+    }
+
+    // The files were just rewritten; rebuild so the snapshot matches them again
+    buildFromJson(snapshotFile);
+}
@@ -0,0 +1,83 @@
+#include "../../include/Utils/Symbol.hpp"
+#include <stdexcept>
+
+SymbolTable::SymbolTable()
+{
+    // ID 0 is the empty string, so default symbols need no lookup
+    intern("");
+}
+
+SymbolTable::~SymbolTable()
+{
+    for (auto &chunk : chunks)
+    {
+        delete[] chunk.load();
+    }
+}
+
+SymbolTable& SymbolTable::instance()
+{
+    static SymbolTable table;
+    return table;
+}
+
+std::uint32_t SymbolTable::intern(std::string_view text)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(text);
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(text);
+    if (it != ids.end())
+    {
+        return it->second; // Another thread added it meanwhile
+    }
+
+    std::uint32_t id = count;
+    std::uint32_t chunkIndex = id >> chunkBits;
+    if (chunkIndex >= maxChunks)
+    {
+        throw std::length_error("Symbol table is full");
+    }
+
+    std::string* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+        chunk = new std::string[chunkSize];
+        chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+    chunk[id & (chunkSize - 1)] = std::string(text);
+    count++;
+
+    ids.emplace(std::string_view(chunk[id & (chunkSize - 1)]), id);
+    return id;
+}
+
+std::optional<std::uint32_t> SymbolTable::find(std::string_view text) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(text);
+    if (it == ids.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::optional<Symbol> Symbol::find(std::string_view text)
+{
+    auto id = SymbolTable::instance().find(text);
+    if (!id)
+    {
+        return std::nullopt;
+    }
+    Symbol symbol;
+    symbol.id = *id;
+    return symbol;
+}
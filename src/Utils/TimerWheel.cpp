@@ -0,0 +1,133 @@
+#include "../../include/Utils/TimerWheel.hpp"
+#include <algorithm>
+
+TimerWheel::TimerWheel(Clock::duration tick, Clock::time_point start) : start(start), tick(tick)
+{
+    slots.fill(none);
+}
+
+std::uint64_t TimerWheel::toTick(Clock::time_point time) const
+{
+    return time > start ? static_cast<std::uint64_t>((time - start) / tick) : 0;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(Clock::time_point deadline, std::uint64_t payload)
+{
+    std::uint32_t index;
+    if (freeList != none)
+    {
+        index = freeList;
+        freeList = timers[index].next;
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(timers.size());
+        timers.emplace_back();
+    }
+
+    // Round up so a timer never fires before its deadline
+    Timer &timer = timers[index];
+    std::uint64_t deadlineTick = toTick(deadline);
+    if (deadline > start && start + deadlineTick * tick < deadline)
+    {
+        deadlineTick++;
+    }
+    timer.deadline = deadlineTick;
+    timer.payload = payload;
+    place(index, currentTick + 1); // This tick's slot has already fired
+    armed++;
+    return (static_cast<TimerId>(timer.generation) << 32 | index) + 1;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    if (id == 0)
+    {
+        return false;
+    }
+    std::uint32_t index = static_cast<std::uint32_t>((id - 1) & UINT32_MAX);
+    std::uint32_t generation = static_cast<std::uint32_t>((id - 1) >> 32);
+    if (index >= timers.size() || timers[index].generation != generation || timers[index].slot == none)
+    {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::place(std::uint32_t index, std::uint64_t earliest)
+{
+    // Anything already due fires at the earliest tick still to come
+    std::uint64_t deadline = std::max(timers[index].deadline, earliest);
+    std::uint64_t delta = deadline - currentTick;
+
+    for (int level = 0; level < levels; level++)
+    {
+        if (delta < (std::uint64_t(1) << (slotBits * (level + 1))))
+        {
+            std::uint32_t slot = static_cast<std::uint32_t>((deadline >> (slotBits * level)) & (slotsPerLevel - 1));
+            link(index, level * slotsPerLevel + slot);
+            return;
+        }
+    }
+
+    // Beyond the wheel: wait in the furthest slot and be placed again from there
+    std::uint64_t furthest = currentTick + (std::uint64_t(1) << (slotBits * levels)) - 1;
+    std::uint32_t slot = static_cast<std::uint32_t>((furthest >> (slotBits * (levels - 1))) & (slotsPerLevel - 1));
+    link(index, (levels - 1) * slotsPerLevel + slot);
+}
+
+void TimerWheel::link(std::uint32_t index, std::uint32_t slot)
+{
+    Timer &timer = timers[index];
+    timer.slot = slot;
+    timer.prev = none;
+    timer.next = slots[slot];
+    if (timer.next != none)
+    {
+        timers[timer.next].prev = index;
+    }
+    slots[slot] = index;
+}
+
+void TimerWheel::unlink(std::uint32_t index)
+{
+    Timer &timer = timers[index];
+    if (timer.prev != none)
+    {
+        timers[timer.prev].next = timer.next;
+    }
+    else
+    {
+        slots[timer.slot] = timer.next;
+    }
+    if (timer.next != none)
+    {
+        timers[timer.next].prev = timer.prev;
+    }
+    timer.slot = none;
+}
+
+void TimerWheel::release(std::uint32_t index)
+{
+    // A new generation makes IDs of the old timer stale
+    Timer &timer = timers[index];
+    timer.generation++;
+    timer.next = freeList;
+    freeList = index;
+    armed--;
+}
+
+void TimerWheel::cascade(int level)
+{
+    std::uint32_t slot = level * slotsPerLevel + static_cast<std::uint32_t>((currentTick >> (slotBits * level)) & (slotsPerLevel - 1));
+    std::uint32_t index = slots[slot];
+    slots[slot] = none;
+    while (index != none)
+    {
+        std::uint32_t next = timers[index].next;
+        place(index, currentTick); // Level 0's slot for this tick fires right after the cascade
+        index = next;
+    }
+}
@@ -0,0 +1,172 @@
+#include "../../include/Utils/Timestamp.hpp"
+
+namespace
+{
+    // Read exactly count digits starting at pos
+    bool readDigits(std::string_view text, size_t pos, size_t count, unsigned &value)
+    {
+        if (pos + count > text.size())
+        {
+            return false;
+        }
+        value = 0;
+        for (size_t i = pos; i < pos + count; i++)
+        {
+            unsigned digit = static_cast<unsigned>(text[i] - '0');
+            if (digit > 9)
+            {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+        return true;
+    }
+
+    bool isLeapYear(unsigned year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    unsigned daysInMonth(unsigned year, unsigned month)
+    {
+        static constexpr unsigned days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && isLeapYear(year) ? 29 : days[month - 1];
+    }
+
+    // Inverse of daysFromCivil
+    void civilFromDays(std::int64_t days, std::int64_t &year, unsigned &month, unsigned &day)
+    {
+        days += 719468;
+        const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+        const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+        month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+        year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2);
+    }
+
+    void appendPadded(std::string &out, std::int64_t value, int width)
+    {
+        char buffer[24];
+        int length = 0;
+        do
+        {
+            buffer[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        for (int i = length; i < width; i++)
+        {
+            out.push_back('0');
+        }
+        while (length > 0)
+        {
+            out.push_back(buffer[--length]);
+        }
+    }
+}
+
+std::int64_t Timestamp::parseDay(std::string_view text)
+{
+    unsigned year, month, day;
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-' ||
+        !readDigits(text, 0, 4, year) || !readDigits(text, 5, 2, month) || !readDigits(text, 8, 2, day))
+    {
+        return invalid;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+    {
+        return invalid;
+    }
+    return daysFromCivil(year, month, day);
+}
+
+std::int64_t Timestamp::parse(std::string_view text)
+{
+    if (!text.empty() && text.back() == 'Z')
+    {
+        text.remove_suffix(1);
+    }
+
+    std::int64_t day = parseDay(text.substr(0, 10));
+    if (day == invalid)
+    {
+        return invalid;
+    }
+    if (text.size() == 10)
+    {
+        return day * secondsPerDay;
+    }
+
+    // Time part: " HH:MM" or " HH:MM:SS"
+    unsigned hour, minute, second = 0;
+    if ((text.size() != 16 && text.size() != 19) || (text[10] != ' ' && text[10] != 'T') || text[13] != ':' ||
+        !readDigits(text, 11, 2, hour) || !readDigits(text, 14, 2, minute))
+    {
+        return invalid;
+    }
+    if (text.size() == 19 && (text[16] != ':' || !readDigits(text, 17, 2, second)))
+    {
+        return invalid;
+    }
+    if (hour > 23 || minute > 59 || second > 59)
+    {
+        return invalid;
+    }
+    return day * secondsPerDay + hour * 3600 + minute * 60 + second;
+}
+
+std::int64_t Timestamp::startOfNextMonth(std::int64_t time)
+{
+    if (time == invalid)
+    {
+        return invalid;
+    }
+
+    std::int64_t year;
+    unsigned month, day;
+    civilFromDays(dayOf(time), year, month, day);
+    return month == 12 ? fromCivil(year + 1, 1, 1) : fromCivil(year, month + 1, 1);
+}
+
+std::string Timestamp::formatDate(std::int64_t time)
+{
+    if (time == invalid)
+    {
+        return "";
+    }
+
+    std::int64_t year;
+    unsigned month, day;
+    civilFromDays(dayOf(time), year, month, day);
+
+    std::string out;
+    out.reserve(10);
+    appendPadded(out, year, 4);
+    out.push_back('-');
+    appendPadded(out, month, 2);
+    out.push_back('-');
+    appendPadded(out, day, 2);
+    return out;
+}
+
+std::string Timestamp::format(std::int64_t time)
+{
+    if (time == invalid)
+    {
+        return "";
+    }
+
+    std::int64_t secondOfDay = time - dayOf(time) * secondsPerDay;
+    std::string out = formatDate(time);
+    out.reserve(20);
+    out.push_back(' ');
+    appendPadded(out, secondOfDay / 3600, 2);
+    out.push_back(':');
+    appendPadded(out, secondOfDay / 60 % 60, 2);
+    out.push_back(':');
+    appendPadded(out, secondOfDay % 60, 2);
+    out.push_back('Z');
+    return out;
+}
@@ -1,4 +1,5 @@
 #include "../../include/Utils/Utils.hpp"
+#include "../../include/Utils/ReservationIdGenerator.hpp"
 
 std::string Utils::getPassword()
 {
@@ -26,11 +27,7 @@ std::string Utils::getPassword()
 
 std::string Utils::generateUniqueReservationId() 
 {
-    static std::random_device rd;  // True random number generator
-    static std::mt19937 gen(rd()); // Mersenne Twister engine
-    static std::uniform_int_distribution<> dis(1000, 9999); // 4-digit IDs
-
-    return "R" + std::to_string(dis(gen));
+    return ReservationIdGenerator::instance().nextId();
 }
 
 std::string Utils::getCurrentTimestamp()
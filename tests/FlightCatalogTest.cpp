@@ -0,0 +1,93 @@
+#include "TestSupport.hpp"
+#include "../include/Flight/FlightCatalog.hpp"
+#include <atomic>
+#include <thread>
+
+// Adding, renaming and removing flights keeps flight numbers unique and the indexes in step;
+// flights and lists already handed out are snapshots that changes never touch
+namespace
+{
+    Flight makeFlight(const std::string& flightNumber, const std::string& origin, const std::string& day)
+    {
+        return Flight(flightNumber, origin, "Chicago", day + " 09:00:00Z", day + " 13:00:00Z", "Boeing 737", "On Time", 180, 180, 250.0);
+    }
+
+    void testUniqueNumbers()
+    {
+        FlightCatalog &catalog = FlightCatalog::instance();
+        CHECK(catalog.addFlight(makeFlight("FC100", "Florida", "2025-03-10")));
+        CHECK(catalog.addFlight(makeFlight("FC200", "Boston", "2025-03-11")));
+        CHECK(!catalog.addFlight(makeFlight("FC100", "Denver", "2025-03-12")));
+
+        // Renaming onto another flight's number leaves both flights as they were
+        CHECK(!catalog.updateFlight("FC100", makeFlight("FC200", "Florida", "2025-03-10")));
+        CHECK(catalog.getFlights()->size() == 2);
+        CHECK(catalog.findFlight("FC100") && catalog.findFlight("FC100")->getOrigin() == "Florida");
+        CHECK(catalog.findFlight("FC200") && catalog.findFlight("FC200")->getOrigin() == "Boston");
+
+        // A free number is fine, and the route index follows
+        CHECK(catalog.updateFlight("FC100", makeFlight("FC300", "Seattle", "2025-03-10")));
+        CHECK(!catalog.findFlight("FC100"));
+        CHECK(catalog.findFlight("FC300"));
+        CHECK(catalog.findFlightsByRoute("Florida", "Chicago", "2025-03-10")->empty());
+        CHECK(catalog.findFlightsByRoute("Seattle", "Chicago", "2025-03-10")->size() == 1);
+
+        CHECK(catalog.removeFlight("FC300"));
+        CHECK(!catalog.removeFlight("FC300"));
+        CHECK(catalog.getFlights()->size() == 1);
+    }
+
+    void testSnapshots()
+    {
+        FlightCatalog &catalog = FlightCatalog::instance();
+        CHECK(catalog.addFlight(makeFlight("FC400", "Denver", "2025-03-12")));
+        auto before = catalog.findFlight("FC400");
+        auto routeBefore = catalog.findFlightsByRoute("Denver", "Chicago", "2025-03-12");
+        CHECK(catalog.updateFlight("FC400", makeFlight("FC400", "Austin", "2025-03-12")));
+        CHECK(before->getOrigin() == "Denver");
+        CHECK(routeBefore->size() == 1 && routeBefore->front() == before);
+        CHECK(catalog.findFlight("FC400")->getOrigin() == "Austin");
+
+        // Readers on other threads while flights are changed
+        std::atomic<bool> stop{false};
+        std::atomic<bool> consistent{true};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; i++)
+        {
+            readers.emplace_back([&]
+            {
+                while (!stop)
+                {
+                    auto flights = catalog.getFlights();
+                    for (const auto &flight : *flights)
+                    {
+                        auto same = catalog.findFlight(flight->getFlightNumber());
+                        consistent = consistent && (!same || same->getFlightNumber() == flight->getFlightNumber());
+                    }
+                    auto route = catalog.findFlightsByRoute("Austin", "Chicago", "2025-03-12");
+                    consistent = consistent && route->size() <= 1;
+                }
+            });
+        }
+        for (int i = 0; i < 50; i++)
+        {
+            CHECK(catalog.updateFlight("FC400", makeFlight("FC400", i % 2 ? "Austin" : "Denver", "2025-03-12")));
+        }
+        stop = true;
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        CHECK(consistent);
+        CHECK(catalog.findFlight("FC400")->getOrigin() == "Austin");
+    }
+}
+
+int main()
+{
+    TestSupport::useScratchDirectory("flight_catalog_test");
+    JsonUtils::saveJsonToFile(nlohmann::json::array(), "data/flights.json");
+    testUniqueNumbers();
+    testSnapshots();
+    return TestSupport::result("FlightCatalogTest");
+}
@@ -0,0 +1,89 @@
+#include "TestSupport.hpp"
+#include "../include/Utils/ReservationIdGenerator.hpp"
+#include "../include/Utils/JsonUtils.hpp"
+#include <condition_variable>
+#include <cstdlib>
+#include <set>
+#include <thread>
+
+// Node leases skip nodes whose process is alive and reuse those of dead processes.
+// The program runs copies of itself ("expect <node>") as the other processes.
+namespace
+{
+    std::string self;
+    const std::string stateFile = "data/reservation_ids.json";
+
+    bool runChild(const std::string& mode)
+    {
+        return std::system(("\"" + self + "\" " + mode).c_str()) == 0;
+    }
+
+    void setNextNode(std::uint64_t node)
+    {
+        FileLock lock(stateFile + ".lock");
+        nlohmann::json state = JsonUtils::readJsonFromFile(stateFile);
+        state["nextNode"] = node;
+        JsonUtils::saveJsonToFile(state, stateFile);
+    }
+
+    void testLeases()
+    {
+        // Node 7's process is still alive: another thread holds its lock like a process would
+        JsonUtils::saveJsonToFile({{"nextNode", 7}}, stateFile);
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool held = false, done = false;
+        std::thread holder([&]
+        {
+            FileLock lease(stateFile + ".node7.lock");
+            std::unique_lock<std::mutex> lock(mutex);
+            held = true;
+            changed.notify_all();
+            changed.wait(lock, [&done] { return done; });
+        });
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&held] { return held; });
+        }
+
+        ReservationIdGenerator &generator = ReservationIdGenerator::instance();
+        CHECK(generator.getNode() == 8);
+        CHECK(runChild("expect 9"));    // the next process takes the node after ours
+
+        // Node 9's process has exited, so its node is free again
+        setNextNode(9);
+        CHECK(runChild("expect 9"));
+
+        // The wrap-around lands on our own live node, which is skipped too
+        setNextNode(8);
+        CHECK(runChild("expect 9"));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        changed.notify_all();
+        holder.join();
+
+        std::set<std::string> ids;
+        for (int i = 0; i < 10000; i++)
+        {
+            ids.insert(generator.nextId());
+        }
+        CHECK(ids.size() == 10000);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    self = std::filesystem::absolute(argv[0]).string();
+    if (argc > 2)
+    {
+        // A child: already in the parent's scratch directory
+        return ReservationIdGenerator::instance().getNode() == std::stoull(argv[2]) ? 0 : 1;
+    }
+
+    TestSupport::useScratchDirectory("reservation_id_test");
+    testLeases();
+    return TestSupport::result("ReservationIdGeneratorTest");
+}
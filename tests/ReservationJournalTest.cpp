@@ -0,0 +1,112 @@
+#include "TestSupport.hpp"
+#include "../include/Booking/ReservationJournal.hpp"
+#include <cstdlib>
+#include <fstream>
+
+// Restart recovery, torn records, stamps and sharing the journal with another process.
+// The program runs copies of itself as the other processes: "crash" makes changes and
+// dies without compacting, "book" adds a reservation and "verify" checks the final state.
+namespace
+{
+    std::string self;
+
+    bool runChild(const std::string& mode)
+    {
+        return std::system(("\"" + self + "\" " + mode).c_str()) == 0;
+    }
+
+    Reservation makeReservation(const std::string& id, const std::string& seat)
+    {
+        Reservation reservation(id, "P1", "Ann", "AA123", seat, "A12", "8:00", "Confirmed", 250.0);
+        reservation.setPaymentStatus("Paid");
+        reservation.setPaymentDetails("Credit Card", std::string("4111"));
+        return reservation;
+    }
+
+    int crash()
+    {
+        ReservationJournal &journal = ReservationJournal::instance();
+        journal.recordBooking(makeReservation("R1", "1A"));
+        journal.recordBookings({makeReservation("R2", "1B"), makeReservation("R3", "1C")});
+        journal.recordUpdate(makeReservation("R2", "2B"));
+        journal.recordStatusChange("R1", "Checked-In");
+        journal.recordCancellation("R3");
+        journal.flush();
+        std::_Exit(0); // No destructors, no compaction: only the journal has the changes
+    }
+
+    int book()
+    {
+        return ReservationJournal::instance().recordBooking(makeReservation("R4", "4A")) ? 0 : 1;
+    }
+
+    int verify()
+    {
+        ReservationJournal &journal = ReservationJournal::instance();
+        CHECK(journal.getReservations().size() == 2);
+        CHECK(journal.findReservation("R1"));
+        CHECK(journal.findReservation("R4"));
+        CHECK(!journal.findReservation("R3"));
+        return TestSupport::failures == 0 ? 0 : 1;
+    }
+
+    void testRecoveryAfterCrash()
+    {
+        CHECK(runChild("crash"));
+
+        // A write torn off by a crash mid-append
+        std::ofstream("data/reservations.journal", std::ios::app | std::ios::binary) << "{\"op\":\"book\",\"reserv";
+
+        ReservationJournal &journal = ReservationJournal::instance();
+        CHECK(journal.getReservations().size() == 2);
+        auto first = journal.findReservation("R1");
+        CHECK(first && first->getStatus() == "Checked-In");
+        CHECK(first && first->getPaymentStatus() == "Paid");
+        auto second = journal.findReservation("R2");
+        CHECK(second && second->getSeatNumber() == "2B");
+        CHECK(!journal.findReservation("R3"));
+    }
+
+    void testStampsApplyOnce()
+    {
+        ReservationJournal &journal = ReservationJournal::instance();
+        TransactionStamp stamp{"test-journal", 1, 0};
+        CHECK(journal.recordCancellation("R2", stamp));
+        CHECK(!journal.recordBooking(makeReservation("R2", "1B"), stamp)); // Same stamp: already applied
+        CHECK(!journal.findReservation("R2"));
+        CHECK(journal.recordBooking(makeReservation("R2", "1B"), TransactionStamp{"test-journal", 2, 0}));
+        CHECK(journal.findReservation("R2"));
+    }
+
+    void testOtherProcess()
+    {
+        ReservationJournal &journal = ReservationJournal::instance();
+        std::uint64_t changes = journal.getExternalChanges();
+        CHECK(runChild("book"));
+        journal.refresh();
+        CHECK(journal.findReservation("R4"));
+        CHECK(journal.getExternalChanges() > changes);
+
+        // After compaction a new process starts from the snapshot alone
+        journal.recordCancellation("R2");
+        journal.compact();
+        CHECK(runChild("verify"));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    self = std::filesystem::absolute(argv[0]).string();
+    if (argc > 1)
+    {
+        // A child: already in the parent's scratch directory
+        std::string mode = argv[1];
+        return mode == "crash" ? crash() : mode == "book" ? book() : verify();
+    }
+
+    TestSupport::useScratchDirectory("journal_test");
+    testRecoveryAfterCrash();
+    testStampsApplyOnce();
+    testOtherProcess();
+    return TestSupport::result("ReservationJournalTest");
+}
@@ -0,0 +1,123 @@
+#include "TestSupport.hpp"
+#include "../include/Flight/SeatFinder.hpp"
+#include <random>
+
+// Best-available picks on an ABC|DEF cabin, plus random cabins checked against brute force
+namespace
+{
+    const int cols = 6;
+    const SeatFinder finder(cols, {2});   // aisle between C and D
+
+    std::vector<int> seatsAt(int row, std::initializer_list<int> columns)
+    {
+        std::vector<int> seats;
+        for (int col : columns)
+        {
+            seats.push_back(row * cols + col);
+        }
+        return seats;
+    }
+
+    SeatRequest request(int partySize, SeatPosition position = SeatPosition::Any, bool together = true)
+    {
+        SeatRequest wanted;
+        wanted.partySize = partySize;
+        wanted.position = position;
+        wanted.together = together;
+        return wanted;
+    }
+
+    void testPreferences()
+    {
+        SeatMap seatMap(10, cols);
+        CHECK(finder.findSeats(seatMap, request(1, SeatPosition::Window)) == seatsAt(0, {0}));
+        CHECK(finder.findSeats(seatMap, request(1, SeatPosition::Aisle)) == seatsAt(0, {2}));
+        CHECK(finder.findSeats(seatMap, request(3)) == seatsAt(0, {0, 1, 2}));
+        CHECK(finder.findSeats(seatMap, request(4)) == seatsAt(0, {0, 1, 2, 3}));   // only fits across the aisle
+        CHECK(finder.findSeats(seatMap, request(7)).empty());
+
+        // A window pair further back beats a middle pair in front
+        for (int col : {0, 2, 3, 5})
+        {
+            seatMap.book(col);
+        }
+        CHECK(finder.findSeats(seatMap, request(2, SeatPosition::Window)) == seatsAt(1, {0, 1}));
+        CHECK(finder.findSeats(seatMap, request(1, SeatPosition::Any)) == seatsAt(0, {1}));
+        CHECK(finder.findSeats(seatMap, request(2)) == seatsAt(1, {0, 1}));   // 1B and 1E aren't adjacent
+    }
+
+    void testApartAndRowRange()
+    {
+        SeatMap seatMap(3, cols);
+        for (int seat = 0; seat < seatMap.getSeatCount(); seat++)
+        {
+            if (seat % 2 == 0)
+            {
+                seatMap.book(seat);
+            }
+        }
+        CHECK(finder.findSeats(seatMap, request(2)).empty());
+        auto apart = finder.findSeats(seatMap, request(4, SeatPosition::Window, false));
+        CHECK(apart.size() == 4);
+        for (int seat : apart)
+        {
+            CHECK(!seatMap.isBooked(seat));
+        }
+        // Every free window seat (column F) is taken before any other seat
+        CHECK(apart == std::vector<int>({1, 5, 11, 17}));
+
+        SeatRequest back = request(1);
+        back.firstRow = 3;
+        back.lastRow = 3;
+        auto seats = finder.findSeats(seatMap, back);
+        CHECK(seats.size() == 1 && seats.front() / cols == 2);
+        CHECK(finder.findSeats(seatMap, request(10, SeatPosition::Any, false)).empty());
+    }
+
+    void testAgainstBruteForce()
+    {
+        std::mt19937 random(2024);
+        bool valid = true, complete = true;
+        for (int round = 0; round < 2000; round++)
+        {
+            SeatMap seatMap(8, cols);
+            for (int seat = 0; seat < seatMap.getSeatCount(); seat++)
+            {
+                if (random() % 100 < 60)
+                {
+                    seatMap.book(seat);
+                }
+            }
+            int size = 1 + static_cast<int>(random() % cols);
+            auto seats = finder.findSeats(seatMap, request(size, static_cast<SeatPosition>(random() % 3)));
+
+            bool exists = false;
+            for (int row = 0; row < seatMap.getRows() && !exists; row++)
+            {
+                for (int start = 0; start + size <= cols && !exists; start++)
+                {
+                    exists = true;
+                    for (int col = start; col < start + size; col++)
+                    {
+                        exists = exists && !seatMap.isBooked(row * cols + col);
+                    }
+                }
+            }
+            complete = complete && exists == !seats.empty();
+            for (size_t i = 0; i < seats.size(); i++)
+            {
+                valid = valid && !seatMap.isBooked(seats[i]) && seats[i] / cols == seats[0] / cols && seats[i] == seats[0] + static_cast<int>(i);
+            }
+        }
+        CHECK(valid);
+        CHECK(complete);
+    }
+}
+
+int main()
+{
+    testPreferences();
+    testApartAndRowRange();
+    testAgainstBruteForce();
+    return TestSupport::result("SeatFinderTest");
+}
@@ -0,0 +1,158 @@
+#include "TestSupport.hpp"
+#include "../include/Flight/SeatMap.hpp"
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Booking, releasing and moving seats, alone and from many threads at once
+namespace
+{
+    void testSingleThread()
+    {
+        SeatMap seatMap(20, 6);
+        int seat = seatMap.seatIndex("3C");
+        CHECK(seat == 2 * 6 + 2);
+        CHECK(seatMap.seatLabel(seat) == "3C");
+        CHECK(seatMap.seatIndex("21A") == -1);
+
+        CHECK(seatMap.book(seat));
+        CHECK(!seatMap.book(seat));
+        CHECK(seatMap.isBooked(seat));
+        CHECK(seatMap.getAvailableCount() == 20 * 6 - 1);
+        CHECK(seatMap.getRowMask(2) == 0b100);
+
+        // Within one word, and across words
+        CHECK(seatMap.move(seat, seatMap.seatIndex("3D")));
+        CHECK(!seatMap.isBooked(seat));
+        CHECK(seatMap.book(seatMap.seatIndex("20F")));
+        CHECK(!seatMap.move(seatMap.seatIndex("3D"), seatMap.seatIndex("20F")));
+        CHECK(seatMap.isBooked(seatMap.seatIndex("3D")));
+        CHECK(seatMap.move(seatMap.seatIndex("3D"), seatMap.seatIndex("19A")));
+        CHECK(seatMap.getBookedCount() == 2);
+
+        CHECK(seatMap.release(seatMap.seatIndex("19A")));
+        CHECK(!seatMap.release(seatMap.seatIndex("19A")));
+    }
+
+    void testEverySeatSoldOnce()
+    {
+        // Every thread tries every seat; each seat must go to exactly one of them
+        SeatMap seatMap(100, 6);
+        const int threadCount = 8;
+        std::vector<int> won(threadCount, 0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&seatMap, &won, t]
+            {
+                for (int seat = 0; seat < seatMap.getSeatCount(); seat++)
+                {
+                    won[t] += seatMap.book(seat) ? 1 : 0;
+                }
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        int total = 0;
+        for (int count : won)
+        {
+            total += count;
+        }
+        CHECK(total == seatMap.getSeatCount());
+        CHECK(seatMap.getAvailableCount() == 0);
+    }
+
+    void testConcurrentMovesKeepCount()
+    {
+        // Passengers hop between seats sharing words; nobody loses or gains a seat
+        SeatMap seatMap(10, 6);
+        const int threadCount = 4;
+        for (int t = 0; t < threadCount; t++)
+        {
+            seatMap.book(t);
+        }
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&seatMap, t]
+            {
+                int seat = t;
+                for (int step = 0; step < 20000; step++)
+                {
+                    int target = (seat + 1 + step % 7) % seatMap.getSeatCount();
+                    if (seatMap.move(seat, target))
+                    {
+                        seat = target;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        CHECK(seatMap.getBookedCount() == threadCount);
+    }
+
+    void testMergeAndSerialize()
+    {
+        SeatMap seatMap(4, 6);
+        seatMap.book(1);
+        std::vector<std::uint64_t> base = seatMap.getWords();
+        seatMap.book(2);                   // changed here
+        std::vector<std::uint64_t> other = base;
+        other[0] |= std::uint64_t{1} << 5; // changed elsewhere
+        other[0] &= ~(std::uint64_t{1} << 1);
+        seatMap.merge(base, other);
+        CHECK(!seatMap.isBooked(1));
+        CHECK(seatMap.isBooked(2));
+        CHECK(seatMap.isBooked(5));
+
+        std::stringstream buffer;
+        seatMap.writeTo(buffer);
+        SeatMap copy = SeatMap::readFrom(buffer);
+        CHECK(copy.getRows() == 4 && copy.getCols() == 6);
+        CHECK(copy.getWords() == seatMap.getWords());
+        CHECK(copy.getSoldWords() == seatMap.getWords());   // a saved seat is sold
+    }
+
+    void testHoldsAndSales()
+    {
+        SeatMap seatMap(4, 6);
+        CHECK(seatMap.book(0) && seatMap.isHeld(0));
+        seatMap.sell(0);                   // claimed: no longer a hold
+        CHECK(!seatMap.isHeld(0) && !seatMap.releaseHold(0) && seatMap.isBooked(0));
+        seatMap.unsell(0, true);           // claim withdrawn: held again
+        CHECK(seatMap.isHeld(0) && seatMap.releaseHold(0) && !seatMap.isBooked(0));
+
+        // Freeing a sale never frees a hold
+        CHECK(seatMap.book(1));
+        seatMap.unsell(1, false);
+        CHECK(seatMap.isHeld(1));
+
+        // Sales from elsewhere: a held seat sold there stays booked, the other holds stay
+        // held, and a seat no longer sold is freed
+        seatMap.sell(3);
+        CHECK(seatMap.book(2));
+        std::vector<std::uint64_t> sold = {(std::uint64_t{1} << 1) | (std::uint64_t{1} << 4)};
+        seatMap.setSoldWords(sold);
+        CHECK(seatMap.isBooked(1) && seatMap.isSold(1));
+        CHECK(seatMap.isHeld(2));
+        CHECK(!seatMap.isBooked(3));
+        CHECK(seatMap.isBooked(4) && seatMap.isSold(4));
+    }
+}
+
+int main()
+{
+    testSingleThread();
+    testEverySeatSoldOnce();
+    testConcurrentMovesKeepCount();
+    testMergeAndSerialize();
+    testHoldsAndSales();
+    return TestSupport::result("SeatMapTest");
+}
@@ -0,0 +1,156 @@
+#include "TestSupport.hpp"
+#include "../include/Utils/Snapshot.hpp"
+#include "../include/Booking/Reservation.hpp"
+#include "../include/Flight/Flight.hpp"
+#include <cstring>
+#include <fstream>
+
+// Snapshot round trips, checksums and the fallback to JSON once a source file changes;
+// timestamps that don't parse survive every round trip as they were written
+namespace
+{
+    const std::string reservationsFile = "data/reservations.json";
+    const std::string snapshotFile = "data/snapshot.bin";
+
+    std::vector<Reservation> makeReservations()
+    {
+        std::vector<Reservation> reservations;
+        for (int i = 0; i < 50; i++)
+        {
+            Reservation reservation("R" + std::to_string(i), "P" + std::to_string(i % 7), "Passenger " + std::to_string(i), "AA123",
+                                    std::to_string(i / 6 + 1) + char('A' + i % 6), "A12", "8:00", i % 3 ? "Confirmed" : "Checked-In",
+                                    100.0 + i);
+            reservation.setPaymentStatus("Paid");
+            reservation.setPaymentDetails("Credit Card", std::string("4111"));
+            reservations.push_back(reservation);
+        }
+        return reservations;
+    }
+
+    void writeJson(const std::vector<Reservation>& reservations)
+    {
+        nlohmann::json array = nlohmann::json::array();
+        for (const auto &reservation : reservations)
+        {
+            array.push_back(reservation.toJson());
+        }
+        JsonUtils::saveJsonToFile(array, reservationsFile);
+    }
+
+    void testRoundTrip()
+    {
+        auto reservations = makeReservations();
+        std::vector<Flight> flights{Flight("AA123", "Florida", "Chicago", "2025-03-10 09:00:00Z", "2025-03-10 13:30:00Z", "Boeing 737",
+                                           "On Time", 180, 120, 250.0),
+                                    Flight("AA124", "Chicago", "Florida", "03/11/2025 9am", "2025-03-11 13:30:00Z", "Boeing 737",
+                                           "On Time", 180, 120, 250.0)};
+        writeJson(reservations);
+
+        Snapshot::Writer writer;
+        writer.addSection("reservations", reservations, Snapshot::FileStamp::of(reservationsFile));
+        writer.addSection("flights", flights, Snapshot::FileStamp{});
+        writer.save(snapshotFile);
+
+        Snapshot::Reader reader(snapshotFile);
+        CHECK(reader.hasSection("reservations"));
+        CHECK(reader.hasSection("flights"));
+        CHECK(!reader.hasSection("users"));
+
+        auto table = reader.table<Reservation>("reservations");
+        CHECK(table.size() == reservations.size());
+        CHECK(table.get(17).toJson() == reservations[17].toJson());
+        auto loaded = table.loadAll();
+        bool same = loaded.size() == reservations.size();
+        for (size_t i = 0; same && i < loaded.size(); i++)
+        {
+            same = loaded[i].toJson() == reservations[i].toJson();
+        }
+        CHECK(same);
+        CHECK(reader.table<Flight>("flights").get(0).toJson() == flights[0].toJson());
+
+        // A legacy timestamp is kept as text, from JSON and from the snapshot alike
+        nlohmann::json legacy = flights[1].toJson();
+        CHECK(legacy.at("departure") == "03/11/2025 9am");
+        CHECK(Flight::fromJson(legacy).toJson() == legacy);
+        CHECK(reader.table<Flight>("flights").get(1).toJson() == legacy);
+
+        // A section read as the wrong entity is refused
+        bool refused = false;
+        try
+        {
+            reader.table<Flight>("reservations");
+        }
+        catch (const std::exception &)
+        {
+            refused = true;
+        }
+        CHECK(refused);
+    }
+
+    template <typename Read>
+    bool fails(const Read& read)
+    {
+        try
+        {
+            read();
+        }
+        catch (const std::exception &)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    std::string corrupt(const std::string& bytes, size_t offset)
+    {
+        std::string corrupted = bytes;
+        corrupted[offset] ^= 0x5A;
+        std::ofstream("data/corrupted.bin", std::ios::binary) << corrupted;
+        return "data/corrupted.bin";
+    }
+
+    void testChecksum()
+    {
+        std::string bytes;
+        {
+            std::ifstream in(snapshotFile, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+
+        // A flipped byte near the end is in the last section's page checksums, so opening it fails
+        std::string corrupted = corrupt(bytes, bytes.size() - 2);
+        CHECK(fails([&] { Snapshot::Reader(corrupted).table<Flight>("flights"); }));
+
+        // One in the first reservation is found when that record is read, not when the section is opened
+        std::uint64_t recordsOffset = 0;
+        std::memcpy(&recordsOffset, bytes.data() + 16 + 16 + 8 + 8, sizeof(recordsOffset));   // first section entry
+        corrupted = corrupt(bytes, static_cast<size_t>(recordsOffset));
+        Snapshot::Reader reader(corrupted);
+        auto table = reader.table<Reservation>("reservations");
+        CHECK(fails([&] { table.get(0); }));
+        CHECK(fails([&] { table.loadAll(); }));
+        CHECK(!fails([&] { reader.table<Flight>("flights").loadAll(); }));
+    }
+
+    void testFallbackToJson()
+    {
+        // Unchanged source: the snapshot is used
+        CHECK(Snapshot::loadEntities<Reservation>(reservationsFile).size() == 50);
+
+        // Changed source: the JSON file is read instead
+        auto reservations = makeReservations();
+        reservations.resize(10);
+        writeJson(reservations);
+        auto loaded = Snapshot::loadEntities<Reservation>(reservationsFile);
+        CHECK(loaded.size() == 10);
+    }
+}
+
+int main()
+{
+    TestSupport::useScratchDirectory("snapshot_test");
+    testRoundTrip();
+    testChecksum();
+    testFallbackToJson();
+    return TestSupport::result("SnapshotTest");
+}
@@ -0,0 +1,50 @@
+#ifndef TESTSUPPORT_HPP
+#define TESTSUPPORT_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+// Shared helpers for the programs in tests/ and bench/.
+// Each test is one executable: CHECK() records failures and result() turns them into
+// the exit status, so `make test` stops at the first program with a failing check.
+namespace TestSupport
+{
+    inline int failures = 0;
+
+    inline void check(bool passed, const char* expression, const char* file, int line)
+    {
+        if (!passed)
+        {
+            failures++;
+            std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+        }
+    }
+
+    // Run in a new empty directory with a data/ folder, so the stores start empty and the
+    // real data files are never touched. Call before anything opens a store.
+    inline std::filesystem::path useScratchDirectory(const std::string& name)
+    {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / ("airline_" + name + "_" + std::to_string(stamp));
+        std::filesystem::create_directories(directory / "data");
+        std::filesystem::current_path(directory);
+        return directory;
+    }
+
+    inline int result(const std::string& name)
+    {
+        if (failures > 0)
+        {
+            std::cerr << name << ": " << failures << " checks failed" << std::endl;
+            return 1;
+        }
+        std::cout << name << ": all checks passed" << std::endl;
+        return 0;
+    }
+}
+
+#define CHECK(expression) TestSupport::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,156 @@
+#include "TestSupport.hpp"
+#include "../include/Utils/TimerWheel.hpp"
+#include "../include/Booking/SeatHoldManager.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+
+// Timers fire at their deadline tick on every level of the wheel, never early and never
+// twice; cancelled ones never fire. Seat holds expire through the wheel.
+namespace
+{
+    using Clock = TimerWheel::Clock;
+    const Clock::time_point origin{};
+    constexpr std::chrono::milliseconds tick{1};
+
+    void testFiresOnTime()
+    {
+        // Level boundaries, and one past the top level
+        const std::uint64_t deadlines[] = {1, 2, 63, 64, 65, 100, 4095, 4096, 4097, 262143, 262144, 300000,
+                                           (std::uint64_t(1) << 24) + 5};
+        TimerWheel wheel(tick, origin);
+        for (std::uint64_t deadline : deadlines)
+        {
+            wheel.schedule(origin + deadline * tick, deadline);
+        }
+        CHECK(wheel.size() == std::size(deadlines));
+
+        std::vector<std::uint64_t> fired;
+        auto collect = [&fired](std::uint64_t payload) { fired.push_back(payload); };
+        for (std::uint64_t deadline : deadlines)
+        {
+            wheel.advance(origin + (deadline - 1) * tick, collect);
+            CHECK(std::find(fired.begin(), fired.end(), deadline) == fired.end());
+            wheel.advance(origin + deadline * tick, collect);
+            CHECK(!fired.empty() && fired.back() == deadline);
+        }
+        CHECK(fired.size() == std::size(deadlines));
+        CHECK(wheel.size() == 0);
+    }
+
+    void testRoundsUp()
+    {
+        // A deadline between ticks waits for the next one
+        TimerWheel wheel(tick, origin);
+        wheel.schedule(origin + std::chrono::microseconds(2500), 7);
+        size_t fired = wheel.advance(origin + 2 * tick, [](std::uint64_t) {});
+        CHECK(fired == 0);
+        fired = wheel.advance(origin + 3 * tick, [](std::uint64_t payload) { CHECK(payload == 7); });
+        CHECK(fired == 1);
+
+        // An overdue deadline fires on the next tick
+        wheel.schedule(origin, 8);
+        CHECK(wheel.advance(origin + 4 * tick, [](std::uint64_t payload) { CHECK(payload == 8); }) == 1);
+    }
+
+    void testCancel()
+    {
+        TimerWheel wheel(tick, origin);
+        auto first = wheel.schedule(origin + 10 * tick, 1);
+        CHECK(wheel.cancel(first));
+        CHECK(!wheel.cancel(first));
+
+        // The node is reused; the old ID must not cancel the new timer
+        auto second = wheel.schedule(origin + 10 * tick, 2);
+        CHECK(!wheel.cancel(first));
+        CHECK(wheel.size() == 1);
+        CHECK(wheel.advance(origin + 10 * tick, [](std::uint64_t payload) { CHECK(payload == 2); }) == 1);
+        CHECK(!wheel.cancel(second));
+        CHECK(!wheel.cancel(0));
+    }
+
+    void testRandomized()
+    {
+        std::mt19937_64 random(12345);
+        TimerWheel wheel(tick, origin);
+        std::map<std::uint64_t, std::uint64_t> deadlineOf;   // payload -> deadline tick, live timers only
+        std::vector<std::pair<std::uint64_t, TimerWheel::TimerId>> ids;
+        std::uint64_t now = 0;
+        bool onTime = true;
+        size_t firedCount = 0;
+
+        for (int round = 0; round < 2000; round++)
+        {
+            for (int i = 0; i < 5; i++)
+            {
+                std::uint64_t payload = ids.size();
+                std::uint64_t deadline = now + 1 + random() % (round % 10 == 0 ? 500000 : 3000);
+                ids.emplace_back(payload, wheel.schedule(origin + deadline * tick, payload));
+                deadlineOf[payload] = deadline;
+            }
+            auto victim = ids[random() % ids.size()];
+            if (deadlineOf.count(victim.first))
+            {
+                CHECK(wheel.cancel(victim.second));
+                deadlineOf.erase(victim.first);
+            }
+
+            std::uint64_t previous = now;
+            now += random() % 700;
+            firedCount += wheel.advance(origin + now * tick, [&](std::uint64_t payload)
+            {
+                auto live = deadlineOf.find(payload);
+                onTime = onTime && live != deadlineOf.end() && live->second > previous && live->second <= now;
+                if (live != deadlineOf.end())
+                {
+                    deadlineOf.erase(live);
+                }
+            });
+        }
+        CHECK(onTime);
+        CHECK(wheel.size() == deadlineOf.size());
+        CHECK(firedCount + deadlineOf.size() <= ids.size());
+    }
+
+    void testSeatHoldsExpire()
+    {
+        TestSupport::useScratchDirectory("timer_wheel_test");
+        SeatInventory &inventory = SeatInventory::instance();
+        inventory.createSeatMap("T200", 10, 6);
+        auto seatMap = inventory.findSeatMap("T200");
+        SeatHoldManager &holds = SeatHoldManager::instance();
+
+        auto plain = holds.hold("T200", "1A", std::chrono::seconds(60));
+        CHECK(plain && seatMap->isBooked(seatMap->seatIndex("1A")));
+        CHECK(!holds.hold("T200", "1A"));
+
+        std::optional<SeatHold> expired;
+        auto handled = holds.hold("T200", "1B", std::chrono::seconds(60), [&expired](const SeatHold& seatHold) { expired = seatHold; });
+        CHECK(handled);
+
+        holds.expire(Clock::now() + std::chrono::seconds(61));
+        CHECK(!holds.isActive(*plain));
+        CHECK(!seatMap->isBooked(seatMap->seatIndex("1A")));   // freed
+        CHECK(expired && expired->id == handled->id);
+        CHECK(inventory.isHeldSeat("T200", seatMap->seatIndex("1B")));   // left to the handler
+
+        // The handler may pass the seat on
+        auto adopted = holds.adopt("T200", "1B", std::chrono::seconds(60));
+        CHECK(adopted && holds.isActive(*adopted));
+        CHECK(holds.release(*adopted));
+        CHECK(!seatMap->isBooked(seatMap->seatIndex("1B")));
+
+        Transaction transaction;
+        CHECK(!holds.confirm(*plain, transaction));
+    }
+}
+
+int main()
+{
+    testFiresOnTime();
+    testRoundsUp();
+    testCancel();
+    testRandomized();
+    testSeatHoldsExpire();
+    return TestSupport::result("TimerWheelTest");
+}
@@ -0,0 +1,189 @@
+#include "TestSupport.hpp"
+#include "../include/Booking/TransactionManager.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+// Recovery of a dead process's intent journal, nested transactions during a checkpoint,
+// and seat claims racing another process. The program runs copies of itself as the
+// other processes ("stamped" and "take-seat").
+namespace
+{
+    std::string self;
+    const std::string flightNumber = "T100";
+    const std::string deadJournal = "data/transactions-999999.journal";
+    const std::string deadJournalId = "999999-1";
+
+    bool runChild(const std::string& mode)
+    {
+        return std::system(("\"" + self + "\" " + mode).c_str()) == 0;
+    }
+
+    nlohmann::json booking(const std::string& id, const std::string& seat)
+    {
+        Reservation reservation(id, "P1", "Ann", flightNumber, seat, "A12", "8:00", "Confirmed", 250.0);
+        return {{"op", "book"}, {"reservation", reservation.toJson()}};
+    }
+
+    nlohmann::json seatBooking(const std::string& seat)
+    {
+        return {{"op", "bookSeat"}, {"flightNumber", flightNumber}, {"seatNumber", seat}};
+    }
+
+    // The dead process applied its first transaction (the booking is its op 1), then
+    // another process cancelled it
+    int stamped()
+    {
+        Reservation reservation = Reservation::fromJson(booking("R1", "1A").at("reservation"));
+        ReservationJournal::instance().recordBooking(reservation, TransactionStamp{deadJournalId, 1, 1});
+        ReservationJournal::instance().recordCancellation("R1");
+        ReservationJournal::instance().flush();
+        std::_Exit(0);
+    }
+
+    int takeSeat()
+    {
+        Transaction transaction;
+        return transaction.bookSeat(flightNumber, "5A") && transaction.commit() ? 0 : 1;
+    }
+
+    void writeDeadJournal()
+    {
+        auto record = [](std::uint64_t txn, nlohmann::json operations)
+        {
+            return nlohmann::json{{"journal", deadJournalId}, {"txn", txn}, {"ops", std::move(operations)}}.dump() + "\n";
+        };
+        auto commit = [](std::uint64_t txn) { return nlohmann::json{{"commit", txn}}.dump() + "\n"; };
+
+        std::ofstream out(deadJournal, std::ios::binary);
+        out << record(1, {seatBooking("1A"), booking("R1", "1A")}) << commit(1)   // applied and cancelled since
+            << record(2, {seatBooking("2A"), booking("R2", "2A")})               // never committed
+            << record(3, {seatBooking("3A"), booking("R3", "3A")}) << commit(3)   // committed, not yet applied
+            << nlohmann::json{{"ops", {seatBooking("4A"), booking("R4", "4A")}}}.dump() << "\n"   // from before commit lines
+            << "{\"journal\":\"" << deadJournalId << "\",\"txn\":5,\"ops\":[";    // torn
+    }
+
+    // The dead process's seat claims: transaction 1 settled (its seat freed by someone
+    // since), 2 and 3 still pending
+    void writeDeadClaims()
+    {
+        auto seat = [](const std::string& label)
+        {
+            return nlohmann::json::array({nlohmann::json::array({flightNumber, SeatInventory::instance().findSeatMap(flightNumber)->seatIndex(label)})});
+        };
+        auto claim = [&seat](std::uint64_t txn, const std::string& label)
+        {
+            return nlohmann::json{{"op", "claim"}, {"journal", deadJournalId}, {"txn", txn}, {"seats", seat(label)}}.dump() + "\n";
+        };
+
+        std::ofstream out("data/seats.log", std::ios::binary | std::ios::app);
+        out << claim(1, "1A")
+            << nlohmann::json{{"op", "commit"}, {"journal", deadJournalId}, {"txn", 1}, {"claim", seat("1A")}, {"release", nlohmann::json::array()}}.dump() << "\n"
+            << nlohmann::json{{"op", "commit"}, {"claim", nlohmann::json::array()}, {"release", seat("1A")}}.dump() << "\n"
+            << claim(2, "2A") << claim(3, "3A");
+    }
+
+    void testRecovery()
+    {
+        CHECK(runChild("stamped"));
+        writeDeadJournal();
+
+        SeatInventory &inventory = SeatInventory::instance();
+        inventory.createSeatMap(flightNumber, 10, 6);
+        inventory.save();
+        writeDeadClaims();
+        TransactionManager::instance(); // Recovers on first use
+
+        ReservationJournal &journal = ReservationJournal::instance();
+        CHECK(!journal.findReservation("R1"));   // the later cancellation stands
+        CHECK(!journal.findReservation("R2"));
+        CHECK(journal.findReservation("R3"));
+        CHECK(journal.findReservation("R4"));
+        CHECK(!std::filesystem::exists(deadJournal));
+
+        // Committed seats are settled unless they were already; uncommitted claims are withdrawn
+        auto seatMap = inventory.findSeatMap(flightNumber);
+        CHECK(!seatMap->isBooked(seatMap->seatIndex("1A")));
+        CHECK(!seatMap->isBooked(seatMap->seatIndex("2A")));
+        CHECK(seatMap->isBooked(seatMap->seatIndex("3A")));
+        CHECK(seatMap->isBooked(seatMap->seatIndex("4A")));
+
+        // The checkpoint put them in seats.dat and cut the log back
+        std::ifstream log("data/seats.log");
+        std::string line;
+        while (std::getline(log, line))
+        {
+            CHECK(nlohmann::json::parse(line).at("op") == "applied");
+        }
+    }
+
+    void testNestedDuringCheckpoint()
+    {
+        std::atomic<bool> done{false};
+        std::thread watchdog([&done]
+        {
+            for (int i = 0; i < 200 && !done; i++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            if (!done)
+            {
+                std::cerr << "Nested transaction deadlocked" << std::endl;
+                std::_Exit(1);
+            }
+        });
+
+        {
+            WaitlistEntry entry;
+            entry.entryId = "W1";
+            entry.passengerId = "P2";
+            entry.flightNumber = flightNumber;
+            Transaction first;
+            first.joinWaitlist(entry);
+            CHECK(first.commit()); // Gives the checkpoint something to do
+        }
+
+        Transaction outer;
+        CHECK(outer.bookSeat(flightNumber, "6A"));
+        std::thread checkpointer([] { TransactionManager::instance().checkpoint(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // The checkpoint now waits for outer
+        {
+            Transaction inner; // Must not wait for the checkpoint that waits for outer
+            CHECK(inner.bookSeat(flightNumber, "6B"));
+            CHECK(inner.commit());
+        }
+        CHECK(outer.commit());
+        checkpointer.join();
+
+        done = true;
+        watchdog.join();
+    }
+
+    void testSeatTakenByAnotherProcess()
+    {
+        Transaction transaction;
+        CHECK(transaction.bookSeat(flightNumber, "5A")); // Held here, free in the file
+        CHECK(runChild("take-seat"));
+        transaction.recordBooking(Reservation::fromJson(booking("R5", "5A").at("reservation")));
+        CHECK(!transaction.commit());
+        CHECK(!ReservationJournal::instance().findReservation("R5"));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    self = std::filesystem::absolute(argv[0]).string();
+    if (argc > 1)
+    {
+        // A child: already in the parent's scratch directory
+        std::string mode = argv[1];
+        return mode == "stamped" ? stamped() : takeSeat();
+    }
+
+    TestSupport::useScratchDirectory("transaction_test");
+    testRecovery();
+    testNestedDuringCheckpoint();
+    testSeatTakenByAnotherProcess();
+    return TestSupport::result("TransactionRecoveryTest");
+}
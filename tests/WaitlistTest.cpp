@@ -0,0 +1,193 @@
+#include "TestSupport.hpp"
+#include "../include/Booking/ReservationService.hpp"
+#include "../include/Booking/TransactionManager.hpp"
+#include <cstdlib>
+
+// Waitlist order, and offers: a cancelled seat stays sold while it is offered, the offer
+// is seen and answered from another process, a failed payment or transaction leaves the
+// waitlist and the offers as they were and an offer whose time is up passes the seat on.
+// The program runs copies of itself ("decline" and "take-seat") as the other processes.
+namespace
+{
+    std::string self;
+    const std::string flightNumber = "T300";
+
+    bool runChild(const std::string& mode)
+    {
+        return std::system(("\"" + self + "\" " + mode).c_str()) == 0;
+    }
+
+    bool isBooked(const std::string& seatNumber)
+    {
+        SeatInventory::instance().refresh();
+        auto seatMap = SeatInventory::instance().findSeatMap(flightNumber);
+        return seatMap->isBooked(seatMap->seatIndex(seatNumber));
+    }
+
+    Reservation book(ReservationService& service, const std::string& id, const std::string& passengerId, const std::string& seat)
+    {
+        Reservation reservation(id, passengerId, passengerId, flightNumber, seat, "A12", "8:00", "Confirmed", 250.0);
+        CHECK(service.bookFlight(reservation, "Cash"));
+        return reservation;
+    }
+
+    std::string wait(ReservationService& service, const std::string& passengerId)
+    {
+        WaitlistEntry entry;
+        entry.passengerId = passengerId;
+        entry.passengerName = passengerId;
+        entry.flightNumber = flightNumber;
+        CHECK(service.joinWaitlist(entry));
+        return entry.entryId;
+    }
+
+    WaitlistEntry entry(const std::string& id, LoyaltyTier tier, std::int64_t requestedAt, const std::string& cabinClass = "")
+    {
+        WaitlistEntry waiting;
+        waiting.entryId = id;
+        waiting.passengerId = "P" + id;
+        waiting.flightNumber = "T301";
+        waiting.cabinClass = cabinClass;
+        waiting.tier = tier;
+        waiting.requestedAt = requestedAt;
+        return waiting;
+    }
+
+    std::vector<std::string> order(const std::vector<WaitlistEntry>& entries)
+    {
+        std::vector<std::string> ids;
+        for (const auto &waiting : entries)
+        {
+            ids.push_back(waiting.entryId);
+        }
+        return ids;
+    }
+
+    // Another process sells seat 2B
+    int takeSeat()
+    {
+        Transaction transaction;
+        return transaction.bookSeat(flightNumber, "2B") && transaction.commit() ? 0 : 1;
+    }
+
+    // The other process turns down P2's offer
+    int decline()
+    {
+        ReservationService service;
+        auto offers = service.getWaitlistOffers("P2");
+        bool declined = offers.size() == 1 && service.declineWaitlistOffer(offers[0].entry.entryId);
+        TransactionManager::instance().checkpoint();
+        return declined ? 0 : 1;
+    }
+
+    void testOrder()
+    {
+        // Higher tiers first, then earlier requests, across the class's queue and the any-class one
+        Waitlist &waitlist = Waitlist::instance();
+        CHECK(waitlist.add(entry("W1", LoyaltyTier::None, 100)));
+        CHECK(waitlist.add(entry("W2", LoyaltyTier::Gold, 300, "Business")));
+        CHECK(waitlist.add(entry("W3", LoyaltyTier::Gold, 200)));
+        CHECK(waitlist.add(entry("W4", LoyaltyTier::Platinum, 400, "Economy")));
+        CHECK(waitlist.add(entry("W5", LoyaltyTier::None, 50, "Business")));
+        CHECK(waitlist.add(entry("W6", LoyaltyTier::Gold, 500)));
+        WaitlistEntry again = entry("W7", LoyaltyTier::Gold, 600);
+        again.passengerId = "PW1";
+        CHECK(!waitlist.add(again));   // W1's passenger waits already
+        CHECK((order(waitlist.getEntries("T301")) == std::vector<std::string>{"W4", "W3", "W2", "W6", "W5", "W1"}));
+
+        auto next = waitlist.claimNext("T301", "Business");
+        CHECK(next && next->entryId == "W3");
+        next = waitlist.claimNext("T301", "Business");
+        CHECK(next && next->entryId == "W2");
+        next = waitlist.claimNext("T301", "Economy");
+        CHECK(next && next->entryId == "W4");
+        next = waitlist.claimNext("T301", "First");
+        CHECK(next && next->entryId == "W6");
+        next = waitlist.claimNext("T301", "Business");
+        CHECK(next && next->entryId == "W5");   // earlier than W1, same tier
+    }
+
+    void testOffers()
+    {
+        SeatInventory::instance().createSeatMap(flightNumber, 2, 2);
+        SeatInventory::instance().save();
+        ReservationService service;
+
+        book(service, "R1", "P1", "1A");
+        std::string second = wait(service, "P2");
+        std::string third = wait(service, "P3");
+        CHECK(service.cancelReservation("R1"));
+        CHECK(isBooked("1A"));   // offered, never free on the way
+        auto offers = service.getWaitlistOffers("P2");
+        CHECK(offers.size() == 1 && offers[0].entry.entryId == second && offers[0].seatNumber == "1A");
+
+        // Saved with the waitlist, so another process can answer it
+        TransactionManager::instance().checkpoint();
+        CHECK(runChild("decline"));
+        CHECK(service.getWaitlistOffers("P2").empty());
+        offers = service.getWaitlistOffers("P3");
+        CHECK(offers.size() == 1 && offers[0].entry.entryId == third);
+        CHECK(isBooked("1A"));
+
+        // A failed payment leaves the offer open
+        CHECK(!service.acceptWaitlistOffer(third, "Bitcoin"));
+        CHECK(service.getWaitlistOffers("P3").size() == 1);
+        CHECK(service.acceptWaitlistOffer(third, "Cash"));
+        CHECK(service.getWaitlistOffers("P3").empty());
+        auto booked = service.getReservationsByPassenger("P3");
+        CHECK(booked.size() == 1 && booked[0].getSeatNumber() == "1A");
+        CHECK(isBooked("1A"));
+
+        // A transaction that fails after taking an offer and claiming the next passenger
+        // puts both back: here a seat it books is sold by another process meanwhile
+        book(service, "R3", "P6", "2A");
+        std::string seventh = wait(service, "P7");
+        std::string eighth = wait(service, "P8");
+        CHECK(service.cancelReservation("R3"));
+        {
+            Transaction transaction;
+            auto taken = transaction.takeOffer(seventh);
+            auto claimed = transaction.claimFromWaitlist(flightNumber, "");
+            CHECK(taken && claimed && claimed->entryId == eighth);
+            WaitlistOffer passed = *taken;
+            passed.entry = *claimed;
+            transaction.openOffer(passed);
+            CHECK(transaction.bookSeat(flightNumber, "2B"));
+            CHECK(runChild("take-seat"));
+            CHECK(!transaction.commit());
+        }
+        CHECK(service.getWaitlistOffers("P7").size() == 1);
+        CHECK(service.getWaitlistOffers("P8").empty());
+        CHECK(Waitlist::instance().isWaiting(flightNumber, "P8"));
+        CHECK(service.declineWaitlistOffer(seventh));
+        CHECK(service.getWaitlistOffers("P8").size() == 1);
+        CHECK(service.declineWaitlistOffer(eighth));
+        CHECK(!isBooked("2A"));
+
+        // An offer whose time is up goes on, here to nobody, so the seat is freed
+        book(service, "R2", "P4", "2A");
+        std::string fifth = wait(service, "P5");
+        CHECK(service.cancelReservation("R2"));
+        auto offer = Waitlist::instance().takeOffer(fifth);
+        CHECK(offer);
+        offer->expiresAt = 0;
+        Waitlist::instance().openOffer(*offer);
+        CHECK(service.getWaitlistOffers("P5").empty());
+        CHECK(!isBooked("2A"));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    self = std::filesystem::absolute(argv[0]).string();
+    if (argc > 1)
+    {
+        // A child: already in the parent's scratch directory
+        return std::string(argv[1]) == "decline" ? decline() : takeSeat();
+    }
+
+    TestSupport::useScratchDirectory("waitlist_test");
+    testOrder();
+    testOffers();
+    return TestSupport::result("WaitlistTest");
+}